@@ -3,7 +3,7 @@ Project: TUC
 File: asm_generator.hpp
 Author: Leonardo Banderali
 Created: October 6, 2015
-Last Modified: October 6, 2015
+Last Modified: October 18, 2026
 
 Description:
     TUC is a simple, experimental compiler designed for learning and experimenting.
@@ -38,8 +38,10 @@ THE SOFTWARE.
 #define ASM_GENERATOR_HPP
 
 // project headers
-#include "syntax_tree.hpp"
-#include "symbol_table.hpp"
+#include "ir.hpp"
+#include "asm_instruction.hpp"
+#include "value_range.hpp"
+#include "superoptimizer.hpp"
 
 // standard libraries
 #include <string>
@@ -49,8 +51,18 @@ THE SOFTWARE.
 //~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
 namespace tuc {
-    std::string gen_expr_asm(SyntaxNode* node, const SymbolTable& symTable);
-    /*  generates assembly code from a syntax tree and symbol table */
+    AsmList gen_program_code(const IRProgram& program, const ValueRangeAnalysis::Result* ranges = nullptr,
+                             const SuperoptimizerTable* superoptimizerTable = nullptr, Target target = Target::X86,
+                             int workerCount = 0);
+    /*  generates the instructions of a program in the intermediate representation for a target, using the ranges of
+        its values and the superoptimizer table (if given) to pick cheaper instruction sequences
+
+        On x86-64, the spawned calls of the program (see parallelizer.hpp) run on a pool of `workerCount` threads
+        started by the program, or one for each processor it may run on (besides the main thread) if it is 0; on x86
+        they are plain calls. */
+
+    std::string gen_program_asm(const AsmList& code, Target target = Target::X86);
+    /*  generates the nasm assembly code of a program from its instructions for a target */
 };
 
 #endif//ASM_GENERATOR_HPP
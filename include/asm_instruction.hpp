@@ -0,0 +1,196 @@
+/*
+Project: TUC
+File: asm_instruction.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_ASM_INSTRUCTION_HPP
+#define TUC_ASM_INSTRUCTION_HPP
+
+// standard libraries
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <bitset>
+#include <iostream>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class AsmOperand;       // an operand of an x86 instruction
+    class AsmInstruction;   // an x86 instruction (or a label)
+
+    using AsmList = std::vector<AsmInstruction>;
+
+    // general purpose registers, in the order of their x86 encoding
+    enum class Register {AX, CX, DX, BX, SP, BP, SI, DI, R8, R9, R10, R11, R12, R13, R14, R15};
+    enum class AsmOpcode {LABEL, MOV, ADD, SUB, IMUL, IDIV, DIV, CDQ, NEG, XOR, SHL, SHR, SAR, LEA, PUSH, POP, JMP, INT,
+                          SYSCALL, MOVSXD, RET, CALL, CMP, JE, JNE, XCHG, RESERVE};
+
+    // the instruction sets tuc generates code for: 32-bit x86 (the default) and x86-64
+    enum class Target {X86, X86_64};
+
+    /*################################################################################################################
+    ### A register set has one bit per general purpose register (indexed by the register's encoding) plus one bit  ##
+    ### for the flags register.  It is used to describe which registers an instruction reads and writes.           ##
+    ################################################################################################################*/
+
+    using RegisterSet = std::bitset<17>;
+    const int flags_bit = 16;
+
+    std::string register_name(Register r, int size = 4);
+    /*  returns the name of a register when used with operands of `size` bytes (4 or 8) */
+
+    RegisterSet registers_read(const AsmInstruction& instruction);
+    /*  returns the registers (and flags) read by an instruction, including implicit operands */
+
+    RegisterSet registers_written(const AsmInstruction& instruction);
+    /*  returns the registers (and flags) written by an instruction, including implicit operands */
+
+    int address_size(Target target) noexcept;
+    /*  returns the size in bytes of addresses (and of the registers pushed on the stack) on a target */
+
+    bool is_exit(const AsmInstruction& instruction) noexcept;
+    /*  returns true if an instruction is the system call ending the program; the other system calls (those of the
+        runtime of parallel calls) have the number of the call as their operand */
+
+    bool has_side_effects(const AsmInstruction& instruction);
+    /*  returns true if an instruction does more than write registers (e.g. accesses memory, the stack, or control
+        flow, or may trap) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+An operand of an x86 instruction: a register, an immediate value, a memory reference of the form
+`[base + index*scale + displacement]`, or the name of a label.
+*/
+class tuc::AsmOperand {
+    public:
+        enum class OperandType {NONE, REGISTER, IMMEDIATE, MEMORY, LABEL};
+
+        AsmOperand() = default;
+
+        static AsmOperand reg(Register r);
+
+        static AsmOperand imm(std::int64_t value);
+
+        static AsmOperand mem(Register base, std::int32_t displacement = 0);
+
+        static AsmOperand mem(Register base, Register index, int scale, std::int32_t displacement = 0);
+
+        static AsmOperand label(const std::string& name);
+
+        OperandType type() const noexcept;
+
+        bool is_register(Register r) const noexcept;
+        /*  returns true if the operand is the register `r` */
+
+        Register base() const noexcept;
+        /*  returns the register of a REGISTER operand or the base register of a MEMORY operand */
+
+        bool has_index() const noexcept;
+
+        Register index() const noexcept;
+
+        int scale() const noexcept;
+
+        std::int64_t value() const noexcept;
+        /*  returns the value of an IMMEDIATE operand or the displacement of a MEMORY operand */
+
+        std::string name() const noexcept;
+        /*  returns the name of a LABEL operand */
+
+        bool operator==(const AsmOperand& other) const noexcept;
+
+        bool operator!=(const AsmOperand& other) const noexcept;
+
+    private:
+        OperandType operandType = OperandType::NONE;
+        Register baseRegister = Register::AX;
+        Register indexRegister = Register::AX;
+        bool hasIndex = false;
+        int indexScale = 1;
+        std::int64_t operandValue = 0;
+        std::string labelName;
+};
+
+/*
+An x86 instruction in Intel operand order (destination first). A LABEL pseudo-instruction marks a position in the code
+with the name given by its only operand. A RESERVE pseudo-instruction reserves zeroed memory for the program (in its
+`.bss` section) with the name given by its first operand and the size in bytes given by its second; the address of the
+memory is loaded with `mov r, name` on x86 and `lea r, [rel name]` on x86-64. The size is the size of the operands in
+bytes (4 or 8).
+*/
+class tuc::AsmInstruction {
+    public:
+        AsmInstruction(AsmOpcode _opcode, std::vector<AsmOperand> _operands = {}, int _size = 4);
+
+        AsmOpcode opcode() const noexcept;
+
+        int operand_count() const noexcept;
+
+        const AsmOperand& operand(int i) const noexcept;
+
+        AsmOperand& operand(int i) noexcept;
+
+        int size() const noexcept;
+
+    private:
+        AsmOpcode instructionOpcode;
+        std::vector<AsmOperand> instructionOperands;
+        int operandSize;
+};
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::ostream& operator<< (std::ostream& os, const tuc::AsmInstruction& instruction);
+/*  puts an instruction in an output stream using nasm syntax (with 32-bit addresses) */
+
+std::ostream& operator<< (std::ostream& os, const tuc::AsmList& code);
+/*  puts a list of instructions in an output stream using nasm syntax, one per line */
+
+namespace tuc {
+    std::ostream& put_instruction(std::ostream& os, const AsmInstruction& instruction, Target target);
+    /*  puts an instruction in an output stream using nasm syntax, with the registers of memory operands named for
+        the addresses of `target` */
+}
+
+#endif//TUC_ASM_INSTRUCTION_HPP
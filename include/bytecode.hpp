@@ -0,0 +1,115 @@
+/*
+Project: TUC
+File: bytecode.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_BYTECODE_HPP
+#define TUC_BYTECODE_HPP
+
+// project headers
+#include "syntax_tree.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class Bytecode;     // a program in tuc's register-based bytecode
+
+    /*################################################################################################################
+    ### The operations of the bytecode.  `r[a] = r[b] op r[c]` operations name three registers; the IMMEDIATE      ##
+    ### superinstructions compute `r[a] = r[b] op imm` (or `imm op r[b]` for the REVERSE ones) with the value in   ##
+    ### the word after the instruction, so that an operation with a literal operand takes a single dispatch.       ##
+    ################################################################################################################*/
+
+    enum class BytecodeOpcode : std::uint8_t {LOAD, ADD, SUBTRACT, MULTIPLY, DIVIDE, ADD_IMMEDIATE, SUBTRACT_IMMEDIATE,
+                                              MULTIPLY_IMMEDIATE, DIVIDE_IMMEDIATE, REVERSE_SUBTRACT_IMMEDIATE,
+                                              REVERSE_DIVIDE_IMMEDIATE, EXIT};
+
+    Bytecode gen_bytecode(const SyntaxNode* root);
+    /*  lowers a program's syntax tree to bytecode; every top-level expression is evaluated in order and the value of
+        the last one is the program's exit value, as with the native code */
+
+    bool run_bytecode(const Bytecode& code, std::int32_t& exitValue);
+    /*  runs a program with exact 32-bit (wrapping) arithmetic and sets `exitValue` to the value it exits with;
+        returns false if the program traps instead (on division by 0, or of the smallest integer by -1), where the
+        native code raises SIGFPE */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+A program in tuc's bytecode: a list of 32-bit words, each instruction being one word holding its opcode (in the low
+byte) and up to three register numbers (in the other bytes), followed by one word for the immediate value of the
+instructions that take one. Registers hold 32-bit values and there are at most 256 of them.
+*/
+class tuc::Bytecode {
+    public:
+        using Word = std::uint32_t;
+
+        static const int max_registers = 256;
+
+        void append(BytecodeOpcode opcode, int a, int b = 0, int c = 0);
+        /*  appends an instruction on registers `a`, `b`, and `c` */
+
+        void append_with_immediate(BytecodeOpcode opcode, int a, int b, std::int32_t immediate);
+        /*  appends an instruction on registers `a` and `b` followed by its immediate value */
+
+        const std::vector<Word>& words() const noexcept;
+
+        int register_count() const noexcept;
+        /*  returns the number of registers used by the program (one more than the highest one named) */
+
+    private:
+        std::vector<Word> codeWords;
+        int registerCount = 0;
+};
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::ostream& operator<< (std::ostream& os, const tuc::Bytecode& code);
+/*  puts a textual representation of a program's bytecode in an output stream, one instruction per line */
+
+#endif//TUC_BYTECODE_HPP
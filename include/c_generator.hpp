@@ -0,0 +1,59 @@
+/*
+Project: TUC
+File: c_generator.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_C_GENERATOR_HPP
+#define TUC_C_GENERATOR_HPP
+
+// project headers
+#include "syntax_tree.hpp"
+
+// standard libraries
+#include <string>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    std::string gen_program_c(const SyntaxNode* root);
+    /*  lowers a program's syntax tree to portable C (C99) whose `main` computes every top-level expression and
+        exits with the value of the last one (functions become static C functions); values wrap around at 32 bits and divisions trap (raise SIGFPE) in the
+        same cases as the native code, so the program exits with the same status once compiled */
+}
+
+#endif//TUC_C_GENERATOR_HPP
@@ -0,0 +1,128 @@
+/*
+Project: TUC
+File: column_kernel.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_COLUMN_KERNEL_HPP
+#define TUC_COLUMN_KERNEL_HPP
+
+// project headers
+#include "syntax_tree.hpp"
+
+// standard libraries
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class ColumnKernel;     // a U expression compiled to evaluate over columns of 32-bit integers
+
+    // the instruction sets a kernel can use, from the least to the most capable
+    enum class SimdLevel {SCALAR, SSE2, AVX2};
+
+    SimdLevel best_simd_level() noexcept;
+    /*  returns the most capable instruction set the machine running tuc supports */
+
+    std::string simd_level_name(SimdLevel level);
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+A U expression (e.g. `price * quantity - discount`) compiled to evaluate over columns of 32-bit integers: each
+identifier of the expression names an input column and the expression is computed for every row, into an output
+column. The values are those the expression has in a U program, wrapping around on overflow and truncating divisions
+toward 0.
+
+The expression is compiled to a list of operations on whole columns, which are run on blocks of `block_size` rows at a
+time so that intermediate values stay in the cache; every operation is a loop over the rows of the block using the
+vector instructions of the kernel's instruction set (picked when the kernel is made, the best one by default).
+*/
+class tuc::ColumnKernel {
+    public:
+        static const std::size_t block_size = 1024;
+
+        ColumnKernel(const SyntaxNode* expression, const std::vector<std::string>& columns,
+                     SimdLevel level = best_simd_level());
+        /*  compiles an expression (a node of a syntax tree from `gen_syntax_tree`) whose identifiers are among the
+            names of the input columns; throws if it uses another identifier.  If the machine does not support the
+            instruction set `level`, the best one it does support is used instead. */
+
+        bool evaluate(const std::vector<const std::int32_t*>& inputs, std::int32_t* output, std::size_t rows) const;
+        /*  computes the expression for `rows` rows of the input columns (in the order of their names) into the
+            output column; returns false if the expression traps on some row (divides by 0, or the smallest integer
+            by -1), in which case the values of the output are unspecified */
+
+        SimdLevel simd_level() const noexcept;
+
+        int operation_count() const noexcept;
+        /*  returns the number of operations on columns the expression compiled to */
+
+    private:
+        // where the values of an operand are: an input column, a column of a constant, a column of intermediate
+        // values (of the current block), or the output column
+        enum class SlotType {INPUT, CONSTANT, TEMPORARY, OUTPUT};
+
+        struct Slot {
+            SlotType type;
+            int index;
+        };
+
+        enum class Operation {ADD, SUBTRACT, MULTIPLY, DIVIDE, COPY};
+
+        struct Step {
+            Operation operation;
+            Slot destination;
+            Slot left;
+            Slot right;
+        };
+
+        Slot compile(const SyntaxNode* node, const std::vector<std::string>& columns, std::vector<int>& freeTemporaries);
+
+        std::vector<Step> steps;
+        std::vector<std::vector<std::int32_t>> constants;   // a block of each constant
+        int temporaryCount = 0;
+        SimdLevel kernelLevel;
+};
+
+#endif//TUC_COLUMN_KERNEL_HPP
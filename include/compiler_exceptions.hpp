@@ -3,7 +3,7 @@ Project: TUC
 File: compiler_exceptions.hpp
 Author: Leonardo Banderali
 Created: October 9, 2015
-Last Modified: January 5, 2016
+Last Modified: October 18, 2026
 
 Description:
     TUC is a simple, experimental compiler designed for learning and experimenting.
@@ -53,8 +53,14 @@ namespace tuc {
 
         class UnknownSymbol;            // exception class for unknown symbol (undeclared symbols)
         class MismatchedParenthesis;    // exception class for mismatched parentheses
+        class ArgumentCountMismatch;    // exception class for calls and definitions with the wrong number of arguments
+        class Redefinition;             // exception class for symbols that are defined more than once
 
         class UnimplementedFeature;     // exception class for when using an unimplemented language feature
+        class InvalidOption;            // exception class for command line options the compiler does not accept
+        class InvalidTable;             // exception class for malformed tables read by the compiler
+        class InvalidInstruction;       // exception class for instructions the encoder cannot encode
+        class JitFailure;               // exception class for when the JIT cannot load code into memory
     }
 }
 
@@ -142,6 +148,32 @@ class tuc::CompilerException::MismatchedParenthesis : public tuc::CompilerExcept
         std::string error() const noexcept override;
 };
 
+/*
+exception class for calls and definitions with the wrong number of arguments
+*/
+class tuc::CompilerException::ArgumentCountMismatch : public tuc::CompilerException::CompilationError {
+    public:
+        ArgumentCountMismatch(const TextEntity& _symbol, int _expected, int _given);
+
+        std::string error() const noexcept override;
+
+    private:
+        std::string errorMsg;
+};
+
+/*
+exception class for symbols that are defined more than once (functions, or parameters of the same function)
+*/
+class tuc::CompilerException::Redefinition : public tuc::CompilerException::CompilationError {
+    public:
+        explicit Redefinition(const TextEntity& _symbol);
+
+        std::string error() const noexcept override;
+
+    private:
+        std::string errorMsg;
+};
+
 /*
 exception class for when using an unimplemented language feature
 */
@@ -170,4 +202,79 @@ class tuc::CompilerException::UnimplementedFeature : public tuc::CompilerExcepti
         std::string faultCause;
 };
 
+/*
+exception class for command line options the compiler does not accept
+*/
+class tuc::CompilerException::InvalidOption : public tuc::CompilerException::CompilerFault {
+    public:
+        InvalidOption(std::string _option, std::string _cause);
+
+        std::string title() const noexcept override;
+
+        std::string cause() const noexcept override;
+
+        std::string option() const noexcept;
+
+    private:
+        std::string optionText;
+        std::string faultCause;
+};
+
+/*
+exception class for malformed tables read by the compiler (e.g. a superoptimizer table)
+*/
+class tuc::CompilerException::InvalidTable : public tuc::CompilerException::CompilerFault {
+    public:
+        InvalidTable(std::string _file, unsigned int _line, std::string _cause);
+
+        std::string title() const noexcept override;
+
+        std::string cause() const noexcept override;
+
+        std::string file() const noexcept;
+
+        unsigned int line() const noexcept;
+
+    private:
+        std::string filePath;
+        unsigned int lineNumber;
+        std::string faultCause;
+};
+
+/*
+exception class for instructions the encoder cannot encode (e.g. a 64-bit register in 32-bit code)
+*/
+class tuc::CompilerException::InvalidInstruction : public tuc::CompilerException::CompilerFault {
+    public:
+        InvalidInstruction(std::string _instruction, std::string _cause);
+
+        std::string title() const noexcept override;
+
+        std::string cause() const noexcept override;
+
+        std::string instruction() const noexcept;
+
+    private:
+        std::string instructionText;
+        std::string faultCause;
+};
+
+/*
+exception class for when the JIT cannot load code into memory (e.g. the system refuses to map executable memory)
+*/
+class tuc::CompilerException::JitFailure : public tuc::CompilerException::CompilerFault {
+    public:
+        JitFailure(std::string _operation, std::string _cause);
+
+        std::string title() const noexcept override;
+
+        std::string cause() const noexcept override;
+
+        std::string operation() const noexcept;
+
+    private:
+        std::string operationName;
+        std::string faultCause;
+};
+
 #endif//TUC_COMPILER_EXCEPTIONS_HPP
@@ -0,0 +1,64 @@
+/*
+Project: TUC
+File: elf_writer.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+
+#ifndef TUC_ELF_WRITER_HPP
+#define TUC_ELF_WRITER_HPP
+
+// project headers
+#include "x86_encoder.hpp"
+
+// standard libraries
+#include <string>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    std::string gen_elf_object(const MachineCode& code, Target target);
+    /*  returns the contents of an ELF relocatable object file (32-bit for x86, 64-bit for x86-64) with the machine
+        code in its `.text` section, the data it reserves in its `.bss` section, and the labels of the code as
+        symbols, `_start` being the only global one */
+
+    std::string gen_elf_executable(const MachineCode& code, Target target);
+    /*  returns the contents of a static ELF executable (32-bit for x86, 64-bit for x86-64) running the machine code
+        from `_start`, the way `ld` would link the object of the code */
+}
+
+#endif//TUC_ELF_WRITER_HPP
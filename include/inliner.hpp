@@ -0,0 +1,61 @@
+/*
+Project: TUC
+File: inliner.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_INLINER_HPP
+#define TUC_INLINER_HPP
+
+// project headers
+#include "ir.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    const int default_inline_threshold = 4;
+    /*  the number of instructions by which inlining a call may make the program larger than the call it replaces */
+
+    int inline_calls(IRProgram& program, int threshold = default_inline_threshold);
+    /*  replaces calls to small functions by a copy of the body of the function (the functions of the language are
+        pure, so a call is just the computation of its result); returns the number of calls replaced
+
+        A call is inlined when the instructions of the callee, less the ones that only depend on constant arguments
+        and the cost of the call itself, are no more than `threshold`.  Recursive and memoized functions are never
+        inlined, and the functions left with no calls are removed. */
+}
+
+#endif//TUC_INLINER_HPP
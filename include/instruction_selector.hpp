@@ -0,0 +1,166 @@
+/*
+Project: TUC
+File: instruction_selector.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_INSTRUCTION_SELECTOR_HPP
+#define TUC_INSTRUCTION_SELECTOR_HPP
+
+// project headers
+#include "ir.hpp"
+#include "asm_instruction.hpp"
+
+// standard libraries
+#include <string>
+#include <vector>
+#include <functional>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class InstructionTile;      // the operations computed by a rule of the instruction selector
+    class InstructionSelector;  // picks the cheapest tiles covering the expression trees of a function
+
+    /*################################################################################################################
+    ### Instructions are selected by a bottom-up rewrite system (BURS).  The rules of src/x86.burs are tree        ##
+    ### patterns with a cost and the instructions computing them; tools/burg.cpp compiles them into tables when   ##
+    ### tuc is built.  The selector labels every value with the cheapest rule deriving each nonterminal from it,  ##
+    ### from the operands up, then reduces the trees from their roots to get the tiles to generate.              ##
+    ################################################################################################################*/
+
+    enum class TileAction {NONE, INSTRUCTIONS, MULTIPLY_BY_CONSTANT, DIVIDE, DIVIDE_BY_CONSTANT};
+    /*  how the code generator computes a tile: with the instructions of its rule or with one of its own cases,
+        which read the operands from the first two leaves */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+The operations covered by a rule: the root of its pattern and the operations inside it. The leaves are the values at the
+nonterminals of the pattern, in the order of the rule (`$0`, `$1`, ...); they are computed by tiles of their own, or are
+constants.
+*/
+class tuc::InstructionTile {
+    public:
+        InstructionTile(int _rule, ValueId _root, std::vector<ValueId> _leaves, std::vector<ValueId> _nodes);
+
+        int rule() const noexcept;
+
+        std::string rule_text() const;
+        /*  returns the pattern of the rule, e.g. "reg: ADD(reg, MULTIPLY(reg, scale))" */
+
+        ValueId root() const noexcept;
+
+        const std::vector<ValueId>& leaves() const noexcept;
+
+        const std::vector<ValueId>& nodes() const noexcept;
+        /*  returns the operations covered, operands first and the root last */
+
+        TileAction action() const noexcept;
+
+        bool commutes() const noexcept;
+        /*  returns true if the two leaves can be swapped (the root is commutative and both leaves are alike) */
+
+        bool addresses_leaves() const noexcept;
+        /*  returns true if leaves which are not constants are used as the registers of an address */
+
+        void swap_leaves();
+
+        AsmList expand(Register result, const std::function<AsmOperand(ValueId)>& operandOf) const;
+        /*  returns the instructions of the rule computing the tile into `result`, where `operandOf` gives the
+            operand holding each leaf; moves of a register to itself are left out */
+
+    private:
+        int ruleIndex;
+        ValueId rootValue;
+        std::vector<ValueId> leafValues;
+        std::vector<ValueId> nodeValues;
+};
+
+/*
+Selects the instructions of a function. An operation can be covered by the tile of its user when it is used only once,
+in the same block, and is not in `fixed` (which may be empty); fixed values are left in a register of their own.
+*/
+class tuc::InstructionSelector {
+    public:
+        InstructionSelector(const IRFunction& _function, std::vector<bool> _fixed = {});
+
+        const InstructionTile* tile(ValueId value) const;
+        /*  returns the tile computing `value`, or null if it is a constant or it is covered by another tile */
+
+        InstructionTile operation_tile(ValueId value) const;
+        /*  returns the cheapest tile covering only the operation defining `value`; its leaves are the operands */
+
+        int cost(ValueId value) const;
+        /*  returns the cost of computing `value` in a register */
+
+    private:
+        struct Label {
+            int cost;
+            int rule;
+        };
+
+        bool is_inlinable(ValueId value, ValueId root) const;
+        /*  returns true if `value` can be covered by a pattern rooted at `root` */
+
+        bool match(int rule, ValueId root, int& cost, std::vector<ValueId>* leaves, std::vector<ValueId>* nodes) const;
+        /*  returns true if the pattern of `rule` matches the tree of `root`, adding the cost of the nonterminals
+            at its leaves to `cost` and collecting the leaves and covered operations (if not null) */
+
+        void label(ValueId value);
+
+        void reduce(ValueId value, int nonterminal);
+
+        Label& state(ValueId value, int nonterminal);
+        const Label& state(ValueId value, int nonterminal) const;
+
+        const IRFunction& function;
+        std::vector<bool> fixed;
+        std::vector<int> useCount;
+        std::vector<BlockId> blockOf;
+        std::vector<BlockId> userBlock;
+        std::vector<Label> labels;                  // the cheapest rule for each value and nonterminal
+        std::vector<Label> operationLabels;         // the cheapest single operation rule for each value
+        std::vector<int> tileOf;                    // index of the tile of each value (-1 if none)
+        std::vector<InstructionTile> tiles;
+        std::vector<bool> covered;
+};
+
+#endif//TUC_INSTRUCTION_SELECTOR_HPP
@@ -0,0 +1,216 @@
+/*
+Project: TUC
+File: ir.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_IR_HPP
+#define TUC_IR_HPP
+
+// standard libraries
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <initializer_list>
+#include <iostream>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class IRInstruction;    // an instruction of the intermediate representation
+    class IRBlock;          // a basic block of the intermediate representation
+    class IRFunction;       // a function in the intermediate representation
+
+    /*################################################################################################################
+    ### The intermediate representation (IR) is in static single assignment (SSA) form.  Each instruction defines  ##
+    ### at most one value (a virtual register) which is identified by the index of the instruction in the flat     ##
+    ### instruction array of its function.  Operands are stored in a flat array shared by all the instructions of  ##
+    ### a function; each instruction only records where its operands start and how many it has.  A basic block is ##
+    ### the ordered list of the instructions it executes and always ends with a terminator (JUMP, RETURN or EXIT). ##
+    ### A program is a list of functions: the first one is the entry point, which ends with EXIT, and the others  ##
+    ### are the functions defined in the source, which get their arguments with PARAMETER and end with RETURN.    ##
+    ################################################################################################################*/
+
+    using ValueId = int;
+    using BlockId = int;
+    using IRProgram = std::vector<IRFunction>;  // the first function is the program's entry point
+
+    enum class IROpcode {CONSTANT, ADD, SUBTRACT, MULTIPLY, DIVIDE, PARAMETER, CALL, SPAWN, JOIN, JUMP, RETURN, EXIT};
+    enum class IRType {VOID, INT32};
+
+    const ValueId no_value = -1;
+
+    std::string opcode_name(IROpcode opcode);
+    /*  returns the textual name of an IR opcode */
+
+    bool is_terminator(IROpcode opcode) noexcept;
+    /*  returns true if instructions with the opcode can only be at the end of a basic block */
+
+    bool has_side_effects(const IRFunction& function, ValueId value);
+    /*  returns true if the instruction defining `value` does anything other than compute its value (e.g. it may
+        trap or transfer control); unknown opcodes are assumed to have side effects */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+An instruction of the intermediate representation. The meaning of the immediate value depends on the opcode: it is the
+value of a CONSTANT, the index of the argument of a PARAMETER, the index of the function (in its program) of a CALL or
+a SPAWN, and the target block of a JUMP. The operands of a CALL are its arguments. A SPAWN starts a call that may run
+in parallel with the instructions after it (see parallelizer.hpp); it has the same operands as a CALL but defines no
+value, and the JOIN using it waits for the call to finish and defines its result.
+*/
+class tuc::IRInstruction {
+    public:
+        IRInstruction(IROpcode _opcode, IRType _type, int _firstOperand, int _operandCount, std::int32_t _immediate);
+
+        IROpcode opcode() const noexcept;
+
+        IRType type() const noexcept;
+        /*  returns the type of the value defined by the instruction (VOID if it does not define one) */
+
+        int first_operand() const noexcept;
+        /*  returns the index of the first operand in the function's operand array */
+
+        int operand_count() const noexcept;
+
+        std::int32_t immediate() const noexcept;
+
+    private:
+        IROpcode instructionOpcode;
+        IRType valueType;
+        int firstOperand;
+        int operandCount;
+        std::int32_t immediateValue;
+};
+
+/*
+A basic block: a straight sequence of instructions with a single entry and a single exit.
+*/
+class tuc::IRBlock {
+    public:
+        const std::vector<ValueId>& instructions() const noexcept;
+        /*  returns the instructions of the block in execution order */
+
+        std::vector<ValueId>& instructions() noexcept;
+
+    private:
+        std::vector<ValueId> blockInstructions;
+};
+
+/*
+A function in the intermediate representation. The first block is the entry block.
+*/
+class tuc::IRFunction {
+    public:
+        explicit IRFunction(const std::string& _name);
+
+        std::string name() const noexcept;
+
+        bool memoized() const noexcept;
+        /*  returns true if the code generated for the function caches its results (see memoizer.hpp) */
+
+        void set_memoized(bool memoized) noexcept;
+
+        BlockId add_block();
+        /*  appends a new empty block to the function and returns its id */
+
+        ValueId append(BlockId block, IROpcode opcode, IRType type, std::initializer_list<ValueId> operands,
+                       std::int32_t immediate = 0);
+        /*  creates an instruction, appends it to the end of `block`, and returns the id of the value it defines */
+
+        ValueId append(BlockId block, IROpcode opcode, IRType type, const std::vector<ValueId>& operands,
+                       std::int32_t immediate = 0);
+
+        ValueId insert(BlockId block, int index, IROpcode opcode, IRType type, std::initializer_list<ValueId> operands,
+                       std::int32_t immediate = 0);
+        ValueId insert(BlockId block, int index, IROpcode opcode, IRType type, const std::vector<ValueId>& operands,
+                       std::int32_t immediate = 0);
+        /*  creates an instruction, inserts it in `block` before the instruction at `index`, and returns the id of the
+            value it defines */
+
+        void redefine(ValueId value, IROpcode opcode, IRType type, std::initializer_list<ValueId> operands,
+                      std::int32_t immediate = 0);
+        void redefine(ValueId value, IROpcode opcode, IRType type, const std::vector<ValueId>& operands,
+                      std::int32_t immediate = 0);
+        /*  replaces the instruction defining `value` (keeping its place in its block) so that every use of `value`
+            now uses the result of the new instruction */
+
+        int instruction_count() const noexcept;
+        /*  returns the number of instructions ever created in the function (including any that were removed from
+            their block) */
+
+        const IRInstruction& instruction(ValueId value) const noexcept;
+        /*  returns the instruction defining `value` */
+
+        ValueId operand(ValueId value, int i) const noexcept;
+        /*  returns operand `i` of the instruction defining `value` */
+
+        void set_operand(ValueId value, int i, ValueId operandValue) noexcept;
+
+        void replace_uses(ValueId value, ValueId replacement) noexcept;
+        /*  makes every instruction using `value` use `replacement` instead */
+
+        int block_count() const noexcept;
+
+        const IRBlock& block(BlockId id) const noexcept;
+
+        IRBlock& block(BlockId id) noexcept;
+
+        std::vector<ValueId> linear_order() const;
+        /*  returns all the instructions of the function, block by block, in execution order */
+
+    private:
+        std::string functionName;
+        bool isMemoized = false;
+        std::vector<IRInstruction> instructions;
+        std::vector<ValueId> operands;
+        std::vector<IRBlock> blocks;
+};
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::ostream& operator<< (std::ostream& os, const tuc::IRFunction& function);
+/*  puts a textual representation of a function in an output stream */
+
+std::ostream& operator<< (std::ostream& os, const tuc::IRProgram& program);
+/*  puts a textual representation of all the functions of a program in an output stream */
+
+#endif//TUC_IR_HPP
@@ -0,0 +1,78 @@
+/*
+Project: TUC
+File: ir_analysis.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_IR_ANALYSIS_HPP
+#define TUC_IR_ANALYSIS_HPP
+
+// project headers
+#include "ir.hpp"
+
+// standard libraries
+#include <string>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class UseCountAnalysis;     // counts the uses of every value of a program
+
+    /*################################################################################################################
+    ### An analysis is a class with a `Result` type, a static `name()`, and a static `run()` computing the result  ##
+    ### for a whole program.  Analyses are requested through the pass manager's AnalysisManager, which caches      ##
+    ### their results until a transform pass reports that it changed the program.                                ##
+    ################################################################################################################*/
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+Counts the number of times each value of a program is used as an operand by an instruction that is still in a block.
+*/
+class tuc::UseCountAnalysis {
+    public:
+        using Result = std::vector<std::vector<int>>;   // the use count of each value, for each function
+
+        static std::string name();
+
+        static Result run(const IRProgram& program);
+};
+
+#endif//TUC_IR_ANALYSIS_HPP
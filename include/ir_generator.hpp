@@ -0,0 +1,61 @@
+/*
+Project: TUC
+File: ir_generator.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_IR_GENERATOR_HPP
+#define TUC_IR_GENERATOR_HPP
+
+// project headers
+#include "ir.hpp"
+#include "syntax_tree.hpp"
+#include "symbol_table.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    IRProgram gen_ir(const SyntaxNode* root, const SymbolTable& symTable);
+    /*  lowers a program's syntax tree to the intermediate representation; each top-level expression becomes a basic
+        block of the entry function and the value of the last one is the program's exit code, and each definition
+        becomes a function (in the order of the definitions) */
+
+    int register_need(const SyntaxNode* node);
+    /*  returns the number of registers needed to evaluate an expression without spilling values to the stack (its
+        Sethi-Ullman number) */
+}
+
+#endif//TUC_IR_GENERATOR_HPP
@@ -0,0 +1,105 @@
+/*
+Project: TUC
+File: jit.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_JIT_HPP
+#define TUC_JIT_HPP
+
+// project headers
+#include "asm_instruction.hpp"
+#include "x86_encoder.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class JitProgram;       // a program loaded into executable memory, run in-process as a function
+
+    AsmList gen_jit_code(const AsmList& code);
+    /*  returns the x86-64 code of a program turned into a function of the System V ABI taking no arguments: it saves
+        the registers its caller expects to be preserved and returns the exit status in eax instead of exiting */
+
+    std::string perf_map_path();
+    /*  returns the file `perf` reads the symbols of the code JIT'd by this process from (/tmp/perf-<pid>.map) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+A program loaded into executable memory by the JIT: the x86-64 code generated for it is turned into a function (see
+`gen_jit_code`), encoded, and copied into pages that are made executable (and no longer writable) once the code is in
+place (the data it reserves is in writable pages after it). Running the program calls the function, which returns the
+value the program would have exited with (all 32 bits of it, not only the 8 an exit status keeps). The code runs in
+the calling process, so a program that divides by zero raises SIGFPE in it, as it would in an executable.
+*/
+class tuc::JitProgram {
+    public:
+        explicit JitProgram(const AsmList& code);
+        /*  loads the x86-64 code generated for a program (throws if the JIT cannot map executable memory) */
+
+        ~JitProgram();
+
+        JitProgram(const JitProgram&) = delete;
+
+        JitProgram& operator= (const JitProgram&) = delete;
+
+        std::int32_t run() const;
+        /*  runs the program and returns the value it exits with */
+
+        const std::uint8_t* address() const noexcept;
+
+        std::size_t size() const noexcept;
+        /*  returns the size of the machine code (not of the memory mapped for it) */
+
+        void write_perf_map(std::ostream& os) const;
+        /*  puts one line per label of the code in an output stream, in the format of perf map files
+            (`<address> <size> <name>`, hexadecimal), each label covering the code up to the next one */
+
+    private:
+        MachineCode machineCode;
+        void* memory = nullptr;
+        std::size_t mappedSize = 0;
+};
+
+#endif//TUC_JIT_HPP
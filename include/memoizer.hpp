@@ -0,0 +1,63 @@
+/*
+Project: TUC
+File: memoizer.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef TUC_MEMOIZER_HPP
+#define TUC_MEMOIZER_HPP
+
+// project headers
+#include "ir.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    const int default_memoize_threshold = 16;
+    /*  the number of calls of a function in a run of the program from which its results are worth caching */
+
+    int memoize_functions(IRProgram& program, int threshold = default_memoize_threshold);
+    /*  marks the functions whose calls are likely to be repeated with the same arguments as memoized, so that the
+        code generated for them caches their results in a memo table (the functions of the language are pure, so
+        their result only depends on their arguments); returns the number of functions marked
+
+        A function is memoized when it makes calls itself (a function only doing arithmetic is cheaper to run again
+        than to look up) and it is either tree recursive, calling itself (directly or not) from more than one place,
+        or called `threshold` times or more by a run of the program, counting every path of calls leading to it (a
+        chain of functions each calling the next one twice calls the last one exponentially many times).  The code
+        generator only caches the results of the functions whose arguments fit in registers, with two to spare. */
+}
+
+#endif//TUC_MEMOIZER_HPP
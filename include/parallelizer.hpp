@@ -0,0 +1,70 @@
+/*
+Project: TUC
+File: parallelizer.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef TUC_PARALLELIZER_HPP
+#define TUC_PARALLELIZER_HPP
+
+// project headers
+#include "ir.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    const int default_parallel_threshold = 10000;
+    /*  the estimated number of instructions run by a call from which it is worth running in parallel */
+
+    int parallelize_calls(IRProgram& program, int threshold = default_parallel_threshold);
+    /*  turns the calls that can run at the same time as a later call of the same block into a SPAWN, with a JOIN
+        before the first use of their result; returns the number of calls spawned
+
+        Only the calls estimated to run at least `threshold` instructions (counting those of the functions they call)
+        are spawned or counted as later calls, so that a call is never started on another thread when the cost of
+        doing so is greater than what there is to gain.  The functions of the language are pure, so two calls with
+        no data dependence between them compute the same results whether they run one after the other or at the
+        same time, and any trap they make is the same division error.  The calls of functions that can recurse
+        (which never return) are never spawned and no instruction is moved across them, so a program that hangs or
+        traps still does.  Neither are the calls of functions that can reach a memoized function, whose memo table
+        is not safe to share between threads.
+
+        To find independent calls, the expensive calls of a block are moved up, together with the instructions
+        computing their arguments, ahead of the other instructions of the block (a block is only reordered if it
+        ends up with a spawned call), so that the four calls of `f a + f b + f c + f d` all start before any of
+        the additions.  The code generator runs the spawned calls on a pool of threads (see asm_generator.hpp). */
+}
+
+#endif//TUC_PARALLELIZER_HPP
@@ -0,0 +1,90 @@
+/*
+Project: TUC
+File: partial_evaluator.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_PARTIAL_EVALUATOR_HPP
+#define TUC_PARTIAL_EVALUATOR_HPP
+
+// project headers
+#include "ir.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class PartialEvaluation;    // what the partial evaluator found out about a program
+
+    const int default_evaluation_fuel = 100000;
+
+    PartialEvaluation partially_evaluate(IRProgram& program, int fuel = default_evaluation_fuel);
+    /*  runs the program at compile time for at most `fuel` instructions and replaces every value it could compute
+        by a constant; the code that depends on anything only known at run time is left as it is (the residual) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+What the partial evaluator found out about a program.
+*/
+class tuc::PartialEvaluation {
+    public:
+        enum class Outcome {
+            EVALUATED,      // the exit code is known; the program does not need to compute anything at run time
+            RESIDUAL,       // some values depend on what happens at run time (e.g. a division that may trap)
+            OUT_OF_FUEL,    // the evaluation was stopped; the program was not changed
+            UNSUPPORTED     // the program uses instructions the evaluator does not model; it was not changed
+        };
+
+        PartialEvaluation(Outcome _outcome, int _steps, int _folded);
+
+        Outcome outcome() const noexcept;
+
+        int steps() const noexcept;
+        /*  returns the number of instructions that were executed */
+
+        int folded() const noexcept;
+        /*  returns the number of instructions that were replaced by constants */
+
+    private:
+        Outcome evaluationOutcome;
+        int stepCount;
+        int foldedCount;
+};
+
+#endif//TUC_PARTIAL_EVALUATOR_HPP
@@ -0,0 +1,228 @@
+/*
+Project: TUC
+File: pass_manager.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_PASS_MANAGER_HPP
+#define TUC_PASS_MANAGER_HPP
+
+// project headers
+#include "ir.hpp"
+#include "asm_instruction.hpp"
+#include "superoptimizer.hpp"
+
+// standard libraries
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <typeindex>
+#include <iostream>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class AnalysisManager;  // computes and caches the results of analyses of a program
+    class IRPass;           // an abstract transform pass over the intermediate representation
+    class AsmPass;          // an abstract transform pass over the generated instructions
+    class PassManager;      // runs the enabled passes of a pipeline and generates code between them
+
+    const int max_optimization_level = 2;
+    const int max_worker_count = 64;
+
+    PassManager standard_pipeline();
+    /*  returns a pass manager with all the passes of the compiler registered (at the default optimization level) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+Computes and caches the results of analyses of a program (see ir_analysis.hpp). A cached result stays valid until
+`invalidate()` is called, which the pass manager does whenever a transform pass reports that it changed the program.
+*/
+class tuc::AnalysisManager {
+    public:
+        template <typename Analysis>
+        const typename Analysis::Result& get(const IRProgram& program);
+        /*  returns the result of `Analysis` for `program`, only running the analysis if its result is not cached */
+
+        void invalidate() noexcept;
+        /*  discards all the cached results */
+
+        int computation_count() const noexcept;
+        /*  returns the number of times an analysis was actually run */
+
+    private:
+        std::map<std::type_index, std::shared_ptr<void>> results;
+        int computations = 0;
+};
+
+/*
+An abstract transform pass over the intermediate representation.
+*/
+class tuc::IRPass {
+    public:
+        virtual ~IRPass() noexcept = default;
+
+        virtual std::string name() const = 0;
+
+        virtual bool run(IRProgram& program, AnalysisManager& analyses) = 0;
+        /*  transforms `program`; returns true if anything was changed */
+
+        virtual bool set_parameter(const std::string& parameter, int value);
+        /*  sets a tuning parameter of the pass; returns false if the pass has no such parameter (default has none) */
+
+        virtual void print_statistics(std::ostream& os) const;
+        /*  prints what the pass did in its previous runs (default prints nothing) */
+};
+
+/*
+An abstract transform pass over the generated instructions.
+*/
+class tuc::AsmPass {
+    public:
+        virtual ~AsmPass() noexcept = default;
+
+        virtual std::string name() const = 0;
+
+        virtual bool run(AsmList& code) = 0;
+        /*  transforms `code`; returns true if anything was changed */
+
+        virtual bool set_parameter(const std::string& parameter, int value);
+        /*  sets a tuning parameter of the pass; returns false if the pass has no such parameter (default has none) */
+
+        virtual void print_statistics(std::ostream& os) const;
+        /*  prints what the pass did in its previous runs (default prints nothing) */
+};
+
+/*
+Runs the passes of a pipeline. Every pass is registered with the lowest optimization level it is enabled at; the passes
+over the intermediate representation are run first (in the order they were registered), then the code is generated
+and the passes over the instructions are run. A pass can also be enabled or disabled regardless of the level.
+*/
+class tuc::PassManager {
+    public:
+        void add_pass(std::unique_ptr<IRPass> pass, int level);
+        /*  registers a pass over the intermediate representation, run from optimization level `level` */
+
+        void add_pass(std::unique_ptr<AsmPass> pass, int level);
+        /*  registers a pass over the generated instructions, run from optimization level `level` */
+
+        std::vector<std::string> pass_names() const;
+        /*  returns the names of all the registered passes, in the order they are run */
+
+        void set_level(int level);
+        /*  sets the optimization level (0 to `max_optimization_level`) */
+
+        int level() const noexcept;
+
+        void set_enabled(const std::string& passName, bool enabled);
+        /*  enables or disables a pass regardless of the optimization level */
+
+        bool is_enabled(const std::string& passName) const;
+        /*  returns true if the pass will be run */
+
+        void set_parameter(const std::string& parameter, int value);
+        /*  sets a tuning parameter of the pass that has it (throws if no pass has it) */
+
+        void set_superoptimizer_table(const SuperoptimizerTable* table) noexcept;
+        /*  sets the table of superoptimized sequences the code generator looks up (none if null) */
+
+        void set_target(Target target) noexcept;
+        /*  sets the instruction set code is generated for (x86 by default) */
+
+        Target target() const noexcept;
+
+        void set_worker_count(int workers);
+        /*  sets the number of threads the generated program starts to run spawned calls (0, the default, for one per
+            processor; at most `max_worker_count`) */
+
+        AsmList run(IRProgram& program);
+        /*  runs the enabled passes over `program` and returns its optimized instructions */
+
+        void optimize(IRProgram& program);
+        /*  runs the enabled passes over the intermediate representation of `program` (the first half of `run()`) */
+
+        AsmList gen_code(const IRProgram& program);
+        /*  generates the instructions of `program` and runs the enabled passes over them (the second half of
+            `run()`) */
+
+        AnalysisManager& analyses() noexcept;
+
+        void print_statistics(std::ostream& os) const;
+        /*  prints what each enabled pass did */
+
+    private:
+        template <typename Pass>
+        struct Registration {
+            std::unique_ptr<Pass> pass;
+            int level;
+        };
+
+        int pass_level(const std::string& passName) const;
+        /*  returns the level a pass was registered with (throws if there is no pass with that name) */
+
+        std::vector<Registration<IRPass>> irPasses;
+        std::vector<Registration<AsmPass>> asmPasses;
+        std::map<std::string, bool> overrides;
+        int optimizationLevel = 1;
+        AnalysisManager analysisManager;
+        const SuperoptimizerTable* superoptimizerTable = nullptr;
+        Target codeTarget = Target::X86;
+        int workerCount = 0;
+};
+
+
+
+//~template implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the result of `Analysis` for `program`, only running the analysis if its result is not cached
+*/
+template <typename Analysis>
+const typename Analysis::Result& tuc::AnalysisManager::get(const IRProgram& program) {
+    auto& result = results[std::type_index{typeid(Analysis)}];
+    if (!result) {
+        result = std::make_shared<typename Analysis::Result>(Analysis::run(program));
+        computations++;
+    }
+    return *std::static_pointer_cast<typename Analysis::Result>(result);
+}
+
+#endif//TUC_PASS_MANAGER_HPP
@@ -0,0 +1,88 @@
+/*
+Project: TUC
+File: scheduler.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_SCHEDULER_HPP
+#define TUC_SCHEDULER_HPP
+
+// project headers
+#include "asm_instruction.hpp"
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class ScheduleResult;   // what the instruction scheduler did
+
+    int instruction_latency(const AsmInstruction& instruction);
+    /*  returns the number of cycles before the result of an instruction can be used (from a table of typical
+        latencies on recent x86 cores) */
+
+    int estimate_cycles(const AsmList& code);
+    /*  returns the number of cycles a core issuing a few instructions per cycle, in order, would take to run `code`
+        straight through */
+
+    ScheduleResult schedule_instructions(AsmList& code);
+    /*  reorders independent instructions so that long latencies overlap with other work; returns what was done */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+What the instruction scheduler did: the number of instructions that changed position and the estimated number of
+cycles (see `estimate_cycles()`) of the code before and after scheduling.
+*/
+class tuc::ScheduleResult {
+    public:
+        ScheduleResult(int _moved, int _cyclesBefore, int _cyclesAfter);
+
+        int moved() const noexcept;
+
+        int cycles_before() const noexcept;
+
+        int cycles_after() const noexcept;
+
+    private:
+        int movedCount;
+        int cyclesBefore;
+        int cyclesAfter;
+};
+
+#endif//TUC_SCHEDULER_HPP
@@ -0,0 +1,118 @@
+/*
+Project: TUC
+File: strength_reduction.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_STRENGTH_REDUCTION_HPP
+#define TUC_STRENGTH_REDUCTION_HPP
+
+// standard libraries
+#include <cstdint>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class MultiplyStep;     // a single cheap instruction used to multiply a value by a constant
+    class DivisionMagic;    // the magic number and shift used to divide by a constant with a multiplication
+
+    bool is_cheap_multiply(std::int32_t constant) noexcept;
+    /*  returns true if multiplying by `constant` can be done with fewer and faster instructions than an `imul` */
+
+    std::vector<MultiplyStep> multiply_steps(std::int32_t constant);
+    /*  returns the sequence of shifts and scaled adds that multiply a value by `constant`; the list is empty when
+        `constant` is 1 and the result is only meaningful if `is_cheap_multiply(constant)` is true */
+
+    int power_of_two_exponent(std::int32_t constant) noexcept;
+    /*  returns `k` if `constant` is 2^k (with k > 0), or -1 otherwise */
+
+    DivisionMagic division_magic(std::int32_t divisor);
+    /*  computes the magic number for signed division by `divisor` (which must not be -1, 0, or 1) as described in
+        Hacker's Delight, chapter 10 */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+A single cheap instruction used to multiply a value by a constant. A SHIFT multiplies the value by 2^amount (`shl`), a
+SCALE multiplies it by 3, 5, or 9 (`lea r, [r + r*(amount - 1)]`), and a CLEAR multiplies it by 0.
+*/
+class tuc::MultiplyStep {
+    public:
+        enum class StepType {CLEAR, SHIFT, SCALE};
+
+        MultiplyStep(StepType _type, int _amount);
+
+        StepType type() const noexcept;
+
+        int amount() const noexcept;
+        /*  returns the shift count of a SHIFT or the scale factor of a SCALE */
+
+    private:
+        StepType stepType;
+        int stepAmount;
+};
+
+/*
+The magic number and shift used to divide by a constant. The quotient of `n / divisor` (rounded toward zero) is:
+
+    q = high 32 bits of (multiplier * n)
+    q = q + correction * n
+    q = q >> shift                      (arithmetic shift)
+    q = q + (q >> 31)                   (logical shift; adds 1 when q is negative)
+*/
+class tuc::DivisionMagic {
+    public:
+        DivisionMagic(std::int32_t _multiplier, int _shift, int _correction);
+
+        std::int32_t multiplier() const noexcept;
+
+        int shift() const noexcept;
+
+        int correction() const noexcept;
+        /*  returns 1 if the dividend must be added to the high part of the product, -1 if it must be subtracted from
+            it, and 0 if no correction is needed */
+
+    private:
+        std::int32_t magicMultiplier;
+        int magicShift;
+        int magicCorrection;
+};
+
+#endif//TUC_STRENGTH_REDUCTION_HPP
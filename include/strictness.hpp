@@ -0,0 +1,85 @@
+/*
+Project: TUC
+File: strictness.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef TUC_STRICTNESS_HPP
+#define TUC_STRICTNESS_HPP
+
+// project headers
+#include "ir.hpp"
+
+// standard libraries
+#include <string>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class StrictnessAnalysis;   // works out which parameters of each function of a program are evaluated
+
+    int eliminate_dead_arguments(IRProgram& program, const std::vector<std::vector<bool>>& strictness);
+    /*  removes the parameters that are not strict (see StrictnessAnalysis) from their functions and the arguments
+        passed for them from every call; returns the number of parameters removed
+
+        The instructions computing a removed argument are left in place, so the ones that may trap still do (and
+        the others are removed by the `dead-statements` pass). */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+Works out which parameters of each function are strict, meaning that a call evaluates them: the body uses the value
+of the parameter for something other than an argument, or passes it as a strict argument of another call.  U has no
+conditionals, so a call of a function evaluates its strict parameters every time and the others never; none of them
+ever needs to be passed unevaluated.
+
+The analysis starts from no strict parameter and adds them until nothing changes, so a parameter that a recursive
+function only passes on to itself (like `x` in `f x y = f x (y / 2)`) is not strict.  The parameters of a function
+are numbered up to the last one its body uses or its callers pass.
+*/
+class tuc::StrictnessAnalysis {
+    public:
+        using Result = std::vector<std::vector<bool>>;  // whether each parameter is strict, for each function
+
+        static std::string name();
+
+        static Result run(const IRProgram& program);
+};
+
+#endif//TUC_STRICTNESS_HPP
@@ -0,0 +1,143 @@
+/*
+Project: TUC
+File: superoptimizer.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+#ifndef TUC_SUPEROPTIMIZER_HPP
+#define TUC_SUPEROPTIMIZER_HPP
+
+// project headers
+#include "ir.hpp"
+#include "asm_instruction.hpp"
+
+// standard libraries
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class ExpressionShape;      // a small expression tree with its inputs abstracted away
+    class SuperoptimizerTable;  // the shortest known instruction sequence of each expression shape
+
+    /*################################################################################################################
+    ### The superoptimizer looks for the shortest instruction sequence computing an expression shape by trying    ##
+    ### every sequence of up to a few instructions.  Sequences read the first input of the shape from eax (where  ##
+    ### they also leave the result) and the second input from ecx; edx is a scratch register.  The code         ##
+    ### generator renames these registers to the ones it allocated.                                              ##
+    ################################################################################################################*/
+
+    const int superoptimizer_max_operations = 4;    // the largest trees that are looked up
+    const int superoptimizer_max_inputs = 2;
+    const int default_superoptimizer_length = 3;    // the longest sequences that are tried
+
+    std::vector<ExpressionShape> match_expression_shapes(const IRFunction& function,
+                                                         const std::function<bool(const ExpressionShape&)>& accept);
+    /*  finds the largest trees of additions, subtractions, and multiplications in a function that fit the limits
+        above, from the last instruction to the first; the nodes of a tree that `accept`s its shape are not part of
+        any other tree; returns the accepted shapes */
+
+    bool superoptimize(const std::string& shape, AsmList& sequence, int maxLength = default_superoptimizer_length);
+    /*  looks for the shortest sequence of at most `maxLength` instructions (and fewer than the operations of the
+        shape) computing `shape`; returns false if there is none */
+
+    int superoptimize_program(const IRProgram& program, SuperoptimizerTable& table,
+                              int maxLength = default_superoptimizer_length);
+    /*  superoptimizes the shapes of a program that are not in the table yet and adds them to it; returns the number
+        of shapes added */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+A tree of additions, subtractions, and multiplications over constants and at most two inputs (values computed outside
+the tree). Its key is the same for every tree computing the same expression: operands of commutative operations are
+put in a fixed order and inputs are named `$0` and `$1` in the order they appear, e.g. `(add (mul $0 3) $1)`.
+*/
+class tuc::ExpressionShape {
+    public:
+        ExpressionShape(std::string _key, ValueId _root, std::vector<ValueId> _inputs, std::vector<ValueId> _nodes);
+
+        std::string key() const noexcept;
+
+        ValueId root() const noexcept;
+
+        const std::vector<ValueId>& inputs() const noexcept;
+        /*  returns the values standing for `$0` and `$1` */
+
+        const std::vector<ValueId>& nodes() const noexcept;
+        /*  returns the operations of the tree, the root last */
+
+    private:
+        std::string shapeKey;
+        ValueId rootValue;
+        std::vector<ValueId> inputValues;
+        std::vector<ValueId> nodeValues;
+};
+
+/*
+The shortest known instruction sequence of each expression shape, kept in a text file with one shape per line:
+`<shape> = <instruction>; <instruction>...`, or `<shape> = -` when nothing shorter than the code generator's output was
+found (so that the search is not repeated).
+*/
+class tuc::SuperoptimizerTable {
+    public:
+        static SuperoptimizerTable load(const std::string& filePath);
+        /*  reads a table from a file; a missing file is an empty table */
+
+        void save(const std::string& filePath) const;
+
+        bool contains(const std::string& shape) const;
+
+        const AsmList* lookup(const std::string& shape) const;
+        /*  returns the sequence of a shape, or null if none is known */
+
+        void insert(const std::string& shape, const AsmList& sequence);
+        /*  adds a shape to the table; an empty sequence means nothing shorter is known */
+
+        int size() const noexcept;
+
+    private:
+        std::map<std::string, AsmList> sequences;
+};
+
+#endif//TUC_SUPEROPTIMIZER_HPP
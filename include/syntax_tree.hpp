@@ -58,16 +58,26 @@ namespace tuc {
 
     // generate a syntax tree and symbol table from a list of tokens
     std::tuple<std::unique_ptr<SyntaxNode>, SymbolTable> gen_syntax_tree(const std::vector<Token>& tokenList);
+
+    void check_symbols(const SyntaxNode* root, const SymbolTable& symTable);
+    /*  throws if an expression of a program uses a symbol that is neither a defined function nor a parameter of the
+        function it is in, or calls a function with the wrong number of arguments */
 }
 
 
 
 //~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+/*
+A node of a syntax tree. A function applied to arguments (`f x (y + 1)`) is a CALL node whose value is the name of the
+function and whose children are the arguments; a symbol used without arguments is an IDENTIFIER node. A definition
+(`f x y = x * y`) is an ASSIGN node whose children are the function with its parameters (a CALL, or an IDENTIFIER if
+there are none) and the body.
+*/
 class tuc::SyntaxNode {
     public:
         enum class NodeType {PROGRAM, TYPE, HASTYPE, ASSIGN, MAPTO, ADD, SUBTRACT, MULTIPLY, DIVIDE, INTEGER, LEFTPAREN, RIGHTPAREN, SEMICOL,
-                                IDENTIFIER, UNKNOWN};
+                                IDENTIFIER, CALL, UNKNOWN};
 
         SyntaxNode(NodeType _type);
 
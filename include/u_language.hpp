@@ -50,7 +50,7 @@ namespace tuc {
             Rule{TokenType::LCOMMENT, "//(.*)(\\n|$)", 0},
             Rule{TokenType::TYPE, "\\b(int)\\b", 0, 20, Associativity::LEFT},
             Rule{TokenType::HASTYPE, "\\:", 0, 9, Associativity::LEFT},
-            Rule{TokenType::ASSIGN, "\\=", 0, 1},
+            Rule{TokenType::ASSIGN, "\\=", 0, 1, Associativity::RIGHT},
             Rule{TokenType::MAPTO, "\\-\\>", 0, 10, Associativity::RIGHT},
             Rule{TokenType::ADD, "\\+", 0, 3, Associativity::LEFT},
             Rule{TokenType::SUBTRACT, "\\-", 0, 3, Associativity::LEFT},
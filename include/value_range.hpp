@@ -0,0 +1,131 @@
+/*
+Project: TUC
+File: value_range.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#ifndef TUC_VALUE_RANGE_HPP
+#define TUC_VALUE_RANGE_HPP
+
+// project headers
+#include "ir.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <iostream>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class ValueRange;           // what is known about the values an integer can take
+    class ValueRangeAnalysis;   // computes the range of every value of a program
+
+    bool division_may_trap(const ValueRange& dividend, const ValueRange& divisor) noexcept;
+    /*  returns true if a division with operands in the given ranges may divide by 0 or overflow */
+
+    void dump_value_ranges(std::ostream& os, const IRProgram& program, const std::vector<std::vector<ValueRange>>& ranges);
+    /*  prints the range of every integer value of a program (for debugging) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+What is known about the values a 32-bit integer can take: an interval (signed bounds) and the bits that are the same
+for all of them (known bits). The two are kept consistent with each other.
+*/
+class tuc::ValueRange {
+    public:
+        ValueRange() = default;
+        /*  any 32-bit value */
+
+        static ValueRange constant(std::int32_t value);
+
+        static ValueRange between(std::int64_t min, std::int64_t max);
+        /*  returns the range of the values from `min` to `max`, or any value if they do not fit in 32 bits */
+
+        std::int32_t min() const noexcept;
+
+        std::int32_t max() const noexcept;
+
+        std::uint32_t known_zeros() const noexcept;
+        /*  returns the bits that are 0 in every value of the range */
+
+        std::uint32_t known_ones() const noexcept;
+        /*  returns the bits that are 1 in every value of the range */
+
+        int trailing_zeros() const noexcept;
+        /*  returns the number of low bits known to be 0 */
+
+        bool contains(std::int32_t value) const noexcept;
+
+        bool is_non_negative() const noexcept;
+
+        ValueRange with_trailing_zeros(int count) const;
+        /*  returns the range with its `count` low bits known to be 0 */
+
+    private:
+        std::int32_t minValue = std::numeric_limits<std::int32_t>::min();
+        std::int32_t maxValue = std::numeric_limits<std::int32_t>::max();
+        std::uint32_t knownZeros = 0;
+        std::uint32_t knownOnes = 0;
+};
+
+/*
+Computes the range of every value of a program from the constants it uses, following the 32-bit semantics of the
+generated code: an operation that may wrap around gives any value.
+*/
+class tuc::ValueRangeAnalysis {
+    public:
+        using Result = std::vector<std::vector<ValueRange>>;    // the range of each value, for each function
+
+        static std::string name();
+
+        static Result run(const IRProgram& program);
+};
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::ostream& operator<< (std::ostream& os, const tuc::ValueRange& range);
+/*  puts a textual representation of a range (its interval and known bits) in an output stream */
+
+#endif//TUC_VALUE_RANGE_HPP
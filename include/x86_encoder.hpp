@@ -0,0 +1,112 @@
+/*
+Project: TUC
+File: x86_encoder.hpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+
+#ifndef TUC_X86_ENCODER_HPP
+#define TUC_X86_ENCODER_HPP
+
+// project headers
+#include "asm_instruction.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+
+//~declare namespace members~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace tuc {
+    class MachineCode;      // the encoded bytes of a list of instructions, the offsets of its labels, and its data
+
+    std::vector<std::uint8_t> encode_instruction(const AsmInstruction& instruction, Target target);
+    /*  returns the machine code of an instruction that is not a jump (throws if it cannot be encoded for `target`) */
+
+    MachineCode encode_instructions(const AsmList& code, Target target);
+    /*  returns the machine code of a list of instructions, encoded the way nasm assembles their text (the shortest
+        form of each instruction and of each jump) */
+}
+
+
+
+//~class declarations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+The encoded bytes of a list of instructions and the offset of each of its labels from the start of the bytes, in the
+order of the code. Local labels (starting with `.`) are named after the label before them, as nasm does (e.g.
+`_start.block0`).
+
+The memory reserved by the code (its data, zeroed when the program starts) is laid out in the order of the code too.
+Its address is not known until the code is loaded, so each instruction using it has a 4-byte field that must be
+relocated: the field holds the absolute address of the data on x86 and its distance from the end of the field on
+x86-64. Until then, the field holds the offset in the data on x86 and 0 on x86-64, as in the objects nasm writes.
+*/
+class tuc::MachineCode {
+    public:
+        using Label = std::pair<std::string, std::size_t>;
+        using Relocation = std::pair<std::size_t, std::size_t>;     // the offset of the field and of the data it refers to
+
+        MachineCode(std::vector<std::uint8_t> _bytes, std::vector<Label> _labels, std::size_t _dataSize = 0,
+                    std::vector<Label> _dataLabels = {}, std::vector<Relocation> _relocations = {});
+
+        const std::vector<std::uint8_t>& bytes() const noexcept;
+
+        const std::vector<Label>& labels() const noexcept;
+
+        std::size_t data_size() const noexcept;
+        /*  returns the number of bytes of data reserved by the code */
+
+        const std::vector<Label>& data_labels() const noexcept;
+        /*  returns the offset of each reservation in the data */
+
+        const std::vector<Relocation>& relocations() const noexcept;
+
+        std::vector<std::uint8_t> relocated_bytes(std::uint64_t codeAddress, std::uint64_t dataAddress, Target target) const;
+        /*  returns the bytes of the code loaded at `codeAddress` with its data at `dataAddress` */
+
+    private:
+        std::vector<std::uint8_t> codeBytes;
+        std::vector<Label> codeLabels;
+        std::size_t dataSize;
+        std::vector<Label> dataLabels;
+        std::vector<Relocation> codeRelocations;
+};
+
+#endif//TUC_X86_ENCODER_HPP
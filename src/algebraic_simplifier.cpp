@@ -0,0 +1,319 @@
+/*
+Project: TUC
+File: algebraic_simplifier.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "algebraic_simplifier.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::IROpcode;
+    using tuc::IRType;
+    using tuc::ValueId;
+
+    /*
+    An expression as a linear combination `c1*t1 + c2*t2 + ... + k` of terms (values that cannot be broken down any
+    further) and a constant. The arithmetic is done modulo 2^32, which is exactly what the wrapping 32-bit instructions
+    compute, so the rewritten expression always has the same value as the original.
+    */
+    class LinearForm {
+        public:
+            bool is_constant() const {
+                return terms.empty();
+            }
+
+            /*
+            adds `scale` times another form to this one
+            */
+            void add(const LinearForm& other, std::uint32_t scale) {
+                for (const auto& t : other.terms)
+                    add_term(t.first, t.second * scale);
+                constant += other.constant * scale;
+            }
+
+            void add_term(ValueId term, std::uint32_t coefficient) {
+                auto& c = terms[term];
+                c += coefficient;
+                if (c == 0)
+                    terms.erase(term);     // e.g. x - x or x*0
+            }
+
+            std::map<ValueId, std::uint32_t> terms;     // ordered by id so rewriting is deterministic
+            std::uint32_t constant = 0;
+    };
+
+    /*
+    returns true if a coefficient or constant is better subtracted than added (INT32_MIN is its own negation)
+    */
+    bool is_negative(std::uint32_t u) {
+        auto s = static_cast<std::int32_t>(u);
+        return s < 0 && s != std::numeric_limits<std::int32_t>::min();
+    }
+
+    bool is_arithmetic(IROpcode opcode) {
+        return opcode == IROpcode::ADD || opcode == IROpcode::SUBTRACT || opcode == IROpcode::MULTIPLY ||
+               opcode == IROpcode::DIVIDE;
+    }
+
+    /*
+    rewrites the expression trees of a function into their linear forms
+    */
+    class Simplifier {
+        public:
+            Simplifier(tuc::IRFunction& _function, const std::vector<int>& _uses)
+            : function(_function), uses(_uses), absorbed(_function.instruction_count(), false) {}
+
+            int run();
+
+        private:
+            LinearForm linearize(ValueId v, bool isRoot, std::vector<ValueId>& operations);
+
+            int cost(const LinearForm& form) const;
+
+            void rebuild(const LinearForm& form, tuc::BlockId block, ValueId root);
+
+            tuc::IRFunction& function;
+            const std::vector<int>& uses;
+            std::vector<bool> absorbed;     // operations that were replaced by the rewriting of a tree
+    };
+
+    /*
+    returns the linear form of the expression computed by `v`, adding the operations that are folded into it to
+    `operations` (the operations that are terms of the form are not included since they are kept)
+
+    An operation is only looked into if it is the root of the expression or if it has no other use; otherwise it is a
+    term, so that what it computes is not computed twice. A division is only evaluated when its operands are constants
+    and it does not trap, and `x/1` is `x`; any other division is a term.
+    */
+    LinearForm Simplifier::linearize(ValueId v, bool isRoot, std::vector<ValueId>& operations) {
+        auto form = LinearForm{};
+        const auto& instruction = function.instruction(v);
+        if (instruction.opcode() == IROpcode::CONSTANT) {
+            form.constant = static_cast<std::uint32_t>(instruction.immediate());
+            return form;
+        }
+        if (!is_arithmetic(instruction.opcode()) || (!isRoot && uses[v] != 1)) {
+            form.add_term(v, 1);
+            return form;
+        }
+
+        auto operationCount = operations.size();
+        auto left = linearize(function.operand(v, 0), false, operations);
+        auto right = linearize(function.operand(v, 1), false, operations);
+        auto isTerm = false;
+        switch (instruction.opcode()) {
+        case IROpcode::ADD:
+            form.add(left, 1);
+            form.add(right, 1);
+            break;
+        case IROpcode::SUBTRACT:
+            form.add(left, 1);
+            form.add(right, static_cast<std::uint32_t>(-1));
+            break;
+        case IROpcode::MULTIPLY:
+            if (right.is_constant())
+                form.add(left, right.constant);     // distributes the constant over the terms of `left`
+            else if (left.is_constant())
+                form.add(right, left.constant);
+            else
+                isTerm = true;
+            break;
+        default: {
+            auto dividend = static_cast<std::int32_t>(left.constant);
+            auto divisor = static_cast<std::int32_t>(right.constant);
+            if (right.is_constant() && divisor == 1)
+                form.add(left, 1);
+            else if (left.is_constant() && right.is_constant() && divisor != 0 &&
+                     !(dividend == std::numeric_limits<std::int32_t>::min() && divisor == -1))
+                form.constant = static_cast<std::uint32_t>(dividend / divisor);
+            else
+                isTerm = true;
+            break;
+        }
+        }
+
+        if (isTerm) {
+            form = LinearForm{};
+            form.add_term(v, 1);
+            operations.resize(operationCount);     // the operations below `v` are kept as they are
+        }
+        else {
+            operations.push_back(v);
+        }
+        return form;
+    }
+
+    /*
+    returns the number of operations `rebuild` generates for a linear form
+    */
+    int Simplifier::cost(const LinearForm& form) const {
+        if (form.terms.empty())
+            return 0;
+
+        auto operations = static_cast<int>(form.terms.size()) - 1;     // additions and subtractions between the terms
+        auto allNegative = true;
+        for (const auto& t : form.terms) {
+            auto c = static_cast<std::int32_t>(t.second);
+            if (c != 1 && c != -1)
+                operations++;   // the multiplication
+            allNegative = allNegative && is_negative(t.second);
+        }
+        if (allNegative)
+            operations++;       // the first term is subtracted from 0
+        if (form.constant != 0)
+            operations++;
+        return operations;
+    }
+
+    /*
+    generates the instructions computing a linear form in place of `root`
+
+    Terms with positive coefficients come first, terms with negative coefficients are subtracted, and the constant is
+    added (or subtracted) last so that it can be an immediate operand. The new instructions are inserted before the
+    root and the last one then replaces the root, so that the uses of the root do not change. If the form is a single
+    term, the uses of the root are made to use the term instead.
+    */
+    void Simplifier::rebuild(const LinearForm& form, tuc::BlockId block, ValueId root) {
+        auto& instructions = function.block(block).instructions();
+        auto index = 0;
+        while (instructions[index] != root)
+            index++;
+
+        auto firstNew = function.instruction_count();
+        auto insert = [&](IROpcode opcode, ValueId left, ValueId right) {
+            return function.insert(block, index++, opcode, IRType::INT32, {left, right});
+        };
+        auto constant = [&](std::uint32_t k) {
+            return function.insert(block, index++, IROpcode::CONSTANT, IRType::INT32, {}, static_cast<std::int32_t>(k));
+        };
+
+        auto result = tuc::no_value;
+        for (auto negative : {false, true}) {
+            for (const auto& t : form.terms) {
+                if (is_negative(t.second) != negative)
+                    continue;
+                auto magnitude = negative ? 0u - t.second : t.second;
+                auto term = magnitude == 1 ? t.first : insert(IROpcode::MULTIPLY, t.first, constant(magnitude));
+                if (result == tuc::no_value)
+                    result = negative ? insert(IROpcode::SUBTRACT, constant(0), term) : term;
+                else
+                    result = insert(negative ? IROpcode::SUBTRACT : IROpcode::ADD, result, term);
+            }
+        }
+        if (result == tuc::no_value)
+            result = constant(form.constant);
+        else if (is_negative(form.constant))
+            result = insert(IROpcode::SUBTRACT, result, constant(0u - form.constant));
+        else if (form.constant != 0)
+            result = insert(IROpcode::ADD, result, constant(form.constant));
+
+        if (result < firstNew) {
+            // like the rest of the old tree (see `run`), the root is turned into an unused constant
+            function.replace_uses(root, result);
+            function.redefine(root, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+            return;
+        }
+
+        auto last = function.instruction(result);
+        if (last.opcode() == IROpcode::CONSTANT)
+            function.redefine(root, IROpcode::CONSTANT, IRType::INT32, {}, last.immediate());
+        else
+            function.redefine(root, last.opcode(), IRType::INT32, {function.operand(result, 0), function.operand(result, 1)});
+        instructions.erase(instructions.begin() + index - 1);
+    }
+
+    /*
+    simplifies every expression tree of the function, visiting the root of each tree before its operands; returns the
+    number of trees that were rewritten
+
+    The operations of a tree that is not rewritten are visited again as the roots of smaller trees, which may still be
+    simplified (e.g. `(x*3 + 2*x) / y`).
+    */
+    int Simplifier::run() {
+        auto rewritten = 0;
+        for (tuc::BlockId b = 0, blockCount = function.block_count(); b < blockCount; b++) {
+            auto original = function.block(b).instructions();
+            for (auto i = original.rbegin(); i != original.rend(); ++i) {
+                auto v = *i;
+                if (absorbed[v] || !is_arithmetic(function.instruction(v).opcode()))
+                    continue;
+
+                auto operations = std::vector<ValueId>{};
+                auto form = linearize(v, true, operations);
+                if (cost(form) < static_cast<int>(operations.size())) {
+                    rebuild(form, b, v);
+                    rewritten++;
+
+                    // the operations of the old tree are no longer used; turning them into constants lets the dead
+                    // statement pass remove divisions it cannot tell are safe (e.g. the one in `x/(2-1)`)
+                    for (auto o : operations) {
+                        absorbed[o] = true;
+                        if (o != v)
+                            function.redefine(o, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+                    }
+                }
+            }
+        }
+        return rewritten;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+rewrites the integer expressions of a program as sums of scaled terms plus a single constant (e.g. `(x+3)+4` becomes
+`x+7` and `2*(x*5) - x*10` becomes `0`) when that takes fewer operations; returns the number of expressions rewritten
+
+Additions, subtractions, and multiplications by constants are gathered into a linear form across parentheses, which
+takes care of reassociating constants, distributing constant multiplications, and identities such as `x*1`, `x+0`,
+`x-x`, `x*0`, and `x/1`. The operations that are no longer used are left for the dead statement pass to remove.
+*/
+int tuc::simplify_algebra(IRProgram& program, const UseCountAnalysis::Result& uses) {
+    auto rewritten = 0;
+    for (int f = 0, count = program.size(); f < count; f++)
+        rewritten += Simplifier{program[f], uses[f]}.run();
+    return rewritten;
+}
@@ -3,7 +3,7 @@ Project: TUC
 File: asm_generator.cpp
 Author: Leonardo Banderali
 Created: October 6, 2015
-Last Modified: October 6, 2015
+Last Modified: October 18, 2026
 
 Description:
     TUC is a simple, experimental compiler designed for learning and experimenting.
@@ -36,82 +36,1566 @@ THE SOFTWARE.
 
 // project headers
 #include "asm_generator.hpp"
+#include "strength_reduction.hpp"
+#include "instruction_selector.hpp"
 
 // standard libraries
 #include <sstream>
+#include <vector>
+#include <unordered_map>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
 
 
 
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::Register;
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+    using OperandType = tuc::AsmOperand::OperandType;
+    using RegisterList = std::vector<Register>;
+
+    /*
+    the general purpose registers available for evaluating expressions, in order of preference (esp and ebp are
+    reserved for the stack); eax comes first so that results end up in it and edx comes last because `idiv` clobbers it
+    */
+    const auto generalRegisters = RegisterList{Register::AX, Register::CX, Register::BX, Register::SI, Register::DI, Register::DX};
+    const auto generalRegisters64 = RegisterList{Register::AX, Register::CX, Register::BX, Register::SI, Register::DI,
+                                                 Register::R8, Register::R9, Register::R10, Register::R11, Register::R12,
+                                                 Register::R13, Register::R14, Register::R15, Register::DX};
+
+    // the memo table of a memoized function has 2^memoTableBits entries, plus one for each probe past the last
+    const int memoTableBits = 10;
+    const int memoProbes = 4;                           // entries looked at before the result is computed again
+    const std::int32_t memoHashMultiplier = -1640531535;    // 0x9e3779b1, 2^32 divided by the golden ratio
+
+    // the runtime of parallel calls: a pool of worker threads, each with its own stack, started by the entry point
+    const int maxWorkers = 15;                  // when there is one per processor (besides the main thread)
+    const int workerStackSize = 1 << 20;
+    const int workerBoxSize = 32;               // the words a worker shares with the threads giving it calls
+    const int cloneThreadFlags = 0x350f00;      // CLONE_VM | FS | FILES | SIGHAND | THREAD | SYSVSEM | PARENT_SETTID |
+                                                // CHILD_CLEARTID
+    const int futexWait = 0;
+    const int futexWake = 1;
+    const int futexPrivate = 128;
+
+    AsmOperand reg(Register r) {
+        return AsmOperand::reg(r);
+    }
+
+    AsmOperand imm(std::int64_t value) {
+        return AsmOperand::imm(value);
+    }
+
+    void emit(tuc::AsmList& code, AsmOpcode opcode, std::initializer_list<AsmOperand> operands = {}, int size = 4) {
+        code.emplace_back(opcode, operands, size);
+    }
+
+    /*
+    generates an instruction operating on the stack pointer (or pushing or popping a whole register), whose size is
+    that of the target's addresses
+    */
+    void emit_stack(tuc::AsmList& code, tuc::Target target, AsmOpcode opcode, std::initializer_list<AsmOperand> operands) {
+        emit(code, opcode, operands, tuc::address_size(target));
+    }
+
+    bool is_free(const RegisterList& freeRegisters, Register r) {
+        return std::find(freeRegisters.cbegin(), freeRegisters.cend(), r) != freeRegisters.cend();
+    }
+
+    tuc::RegisterSet register_set(const RegisterList& registers) {
+        auto set = tuc::RegisterSet{};
+        for (auto r : registers)
+            set.set(static_cast<int>(r));
+        return set;
+    }
+
+    /*
+    returns the label of a function: the entry point is `_start` and the names of the others are prefixed so that they
+    never clash with the names nasm reserves (e.g. those of registers)
+    */
+    std::string function_label(const tuc::IRProgram& program, int index) {
+        return index == 0 ? "_start" : "u_" + program[index].name();
+    }
+
+    /*
+    returns the call whose result a block returns as soon as it is computed (a tail call), or `no_value` if the block
+    does not end that way
+    */
+    tuc::ValueId tail_call(const tuc::IRFunction& function, tuc::BlockId block) {
+        const auto& instructions = function.block(block).instructions();
+        if (instructions.size() < 2)
+            return tuc::no_value;
+        auto ret = instructions.back();
+        auto call = instructions[instructions.size() - 2];
+        if (function.instruction(ret).opcode() != tuc::IROpcode::RETURN ||
+            function.instruction(call).opcode() != tuc::IROpcode::CALL || function.operand(ret, 0) != call)
+            return tuc::no_value;
+        return call;
+    }
+
+    void visit_callees(const tuc::IRProgram& program, int index, std::vector<bool>& visited, std::vector<int>& order) {
+        visited[index] = true;
+        const auto& function = program[index];
+        for (auto v : function.linear_order()) {
+            const auto& instruction = function.instruction(v);
+            if ((instruction.opcode() == tuc::IROpcode::CALL || instruction.opcode() == tuc::IROpcode::SPAWN) &&
+                !visited[instruction.immediate()])
+                visit_callees(program, instruction.immediate(), visited, order);
+        }
+        order.push_back(index);
+    }
+
+    /*
+    returns true if a spawned call is run by a worker thread: the pool only exists on x86-64, and the arguments of the
+    call are passed in every register but edx, where the worker keeps the call (the others run as plain calls)
+    */
+    bool runs_in_parallel(const tuc::IRFunction& function, tuc::ValueId spawn, tuc::Target target) {
+        return target == tuc::Target::X86_64 &&
+               function.instruction(spawn).operand_count() < static_cast<int>(generalRegisters64.size());
+    }
+
+    /*
+    returns the functions whose calls are run by worker threads, with the number of arguments they are passed; none
+    means that the program needs no pool
+    */
+    std::map<int, int> parallel_callees(const tuc::IRProgram& program, tuc::Target target) {
+        auto callees = std::map<int, int>{};
+        for (const auto& function : program) {
+            for (auto v : function.linear_order()) {
+                const auto& instruction = function.instruction(v);
+                if (instruction.opcode() == tuc::IROpcode::SPAWN && runs_in_parallel(function, v, target))
+                    callees[instruction.immediate()] = std::max(callees[instruction.immediate()], instruction.operand_count());
+            }
+        }
+        return callees;
+    }
+
+    /*
+    returns the indices of the functions of a program, callees before their callers (except for recursive calls)
+    */
+    std::vector<int> generation_order(const tuc::IRProgram& program) {
+        auto visited = std::vector<bool>(program.size(), false);
+        auto order = std::vector<int>{};
+        for (int f = 0, count = program.size(); f < count; f++) {
+            if (!visited[f])
+                visit_callees(program, f, visited, order);
+        }
+        return order;
+    }
+
+    /*
+    `idiv` and the one operand `imul` use edx:eax and overwrite both, so any live value (one not in `freeRegisters`)
+    in those registers is saved on the stack; returns the list of saved registers
+    */
+    RegisterList save_eax_edx(tuc::AsmList& code, tuc::Target target, const RegisterList& freeRegisters) {
+        auto savedRegisters = RegisterList{};
+        for (auto r : {Register::AX, Register::DX}) {
+            if (!is_free(freeRegisters, r)) {
+                emit_stack(code, target, AsmOpcode::PUSH, {reg(r)});
+                savedRegisters.push_back(r);
+            }
+        }
+        return savedRegisters;
+    }
+
+    void restore_registers(tuc::AsmList& code, tuc::Target target, const RegisterList& savedRegisters) {
+        for (auto r = savedRegisters.crbegin(); r != savedRegisters.crend(); r++)
+            emit_stack(code, target, AsmOpcode::POP, {reg(*r)});
+    }
+
+    /*
+    generates moves putting each source in its destination register as if they were all done at once: a move is
+    generated once no other move reads its destination, and the cycles left are broken by copying one of their
+    registers to a free register, or when there is none, by pushing it and popping it into the destinations of the moves
+    reading it after all the others
+    */
+    void gen_parallel_move(tuc::AsmList& code, tuc::Target target, std::vector<std::pair<Register, AsmOperand>> moves,
+                           const RegisterList& freeRegisters) {
+        using Move = std::pair<Register, AsmOperand>;
+        moves.erase(std::remove_if(moves.begin(), moves.end(), [](const Move& m) { return m.second.is_register(m.first); }),
+                    moves.end());
+        auto is_read = [&](Register r) {
+            return std::any_of(moves.cbegin(), moves.cend(), [&](const Move& m) { return m.second.is_register(r); });
+        };
+        auto destinations = RegisterList{};
+        for (const auto& m : moves)
+            destinations.push_back(m.first);
+
+        auto popped = RegisterList{};
+        while (!moves.empty()) {
+            auto ready = std::find_if(moves.begin(), moves.end(), [&](const Move& m) { return !is_read(m.first); });
+            if (ready != moves.end()) {
+                emit(code, AsmOpcode::MOV, {reg(ready->first), ready->second});
+                moves.erase(ready);
+                continue;
+            }
+
+            auto blocked = moves.front().first;
+            auto scratch = std::find_if(freeRegisters.cbegin(), freeRegisters.cend(), [&](Register r) {
+                return !is_read(r) && std::find(destinations.cbegin(), destinations.cend(), r) == destinations.cend();
+            });
+            if (scratch != freeRegisters.cend()) {
+                emit(code, AsmOpcode::MOV, {reg(*scratch), reg(blocked)});
+                for (auto& m : moves) {
+                    if (m.second.is_register(blocked))
+                        m.second = reg(*scratch);
+                }
+            }
+            else {
+                for (auto m = moves.begin(); m != moves.end();) {
+                    if (m->second.is_register(blocked)) {
+                        emit_stack(code, target, AsmOpcode::PUSH, {reg(blocked)});
+                        popped.push_back(m->first);
+                        m = moves.erase(m);
+                    }
+                    else {
+                        m++;
+                    }
+                }
+            }
+        }
+        restore_registers(code, target, popped);
+    }
+
+    /*
+    returns a free register other than `dst`, eax, and edx; the second value is false if there are none
+    */
+    std::pair<Register, bool> find_scratch_register(const RegisterList& freeRegisters) {
+        auto scratch = std::find_if(freeRegisters.cbegin() + 1, freeRegisters.cend(), [](Register r) {
+            return r != Register::AX && r != Register::DX;
+        });
+        if (scratch == freeRegisters.cend())
+            return std::make_pair(Register::AX, false);
+        return std::make_pair(*scratch, true);
+    }
+
+    /*
+    generates `dst = dst / divisor`, where `dst` is the first free register and the divisor is a register, a memory
+    operand, or an immediate value; when both operands are known to be non-negative, the unsigned `div` is used since
+    it needs no sign extension of the dividend
+    */
+    void gen_divide(tuc::AsmList& code, tuc::Target target, const RegisterList& freeRegisters, AsmOperand divisor,
+                    bool nonNegative = false) {
+        auto dst = freeRegisters.front();
+
+        auto savedRegisters = save_eax_edx(code, target, freeRegisters);
+
+        // the divisor can be neither an immediate value nor in one of the registers clobbered by `idiv`
+        auto divisorPushed = false;
+        if (divisor.is_register(Register::AX) || divisor.is_register(Register::DX) || divisor.type() == OperandType::IMMEDIATE) {
+            auto scratch = find_scratch_register(freeRegisters);
+            if (scratch.second) {
+                emit(code, AsmOpcode::MOV, {reg(scratch.first), divisor});
+                divisor = reg(scratch.first);
+            }
+            else {
+                emit_stack(code, target, AsmOpcode::PUSH, {divisor});
+                divisor = AsmOperand::mem(Register::SP);
+                divisorPushed = true;
+            }
+        }
+
+        if (dst != Register::AX)
+            emit(code, AsmOpcode::MOV, {reg(Register::AX), reg(dst)});
+        if (nonNegative) {
+            emit(code, AsmOpcode::XOR, {reg(Register::DX), reg(Register::DX)});
+            emit(code, AsmOpcode::DIV, {divisor});
+        }
+        else {
+            emit(code, AsmOpcode::CDQ);
+            emit(code, AsmOpcode::IDIV, {divisor});
+        }
+        if (dst != Register::AX)
+            emit(code, AsmOpcode::MOV, {reg(dst), reg(Register::AX)});
+
+        if (divisorPushed)
+            emit_stack(code, target, AsmOpcode::ADD, {reg(Register::SP), imm(tuc::address_size(target))});
+        restore_registers(code, target, savedRegisters);
+    }
+
+    /*
+    generates `dst = dst * constant`, using shifts and `lea`s instead of `imul` when they are cheaper
+    */
+    void gen_multiply_by_constant(tuc::AsmList& code, Register dst, std::int32_t constant) {
+        using StepType = tuc::MultiplyStep::StepType;
+
+        if (!tuc::is_cheap_multiply(constant)) {
+            emit(code, AsmOpcode::IMUL, {reg(dst), imm(constant)});
+            return;
+        }
+
+        for (const auto& step : tuc::multiply_steps(constant)) {
+            if (step.type() == StepType::CLEAR)
+                emit(code, AsmOpcode::XOR, {reg(dst), reg(dst)});
+            else if (step.type() == StepType::SHIFT)
+                emit(code, AsmOpcode::SHL, {reg(dst), imm(step.amount())});
+            else if (step.type() == StepType::SCALE)
+                emit(code, AsmOpcode::LEA, {reg(dst), AsmOperand::mem(dst, dst, step.amount() - 1)});
+        }
+    }
+
+    /*
+    generates `dst = dst / constant` (rounded toward zero), using shifts for powers of two and a multiplication by a
+    magic number for other divisors instead of an `idiv`; the adjustments for negative dividends are left out when
+    the dividend is known to be non-negative
+
+    On x86-64, the magic number and its correction fit in a single 64-bit immediate (`magic + correction * 2^32`), so
+    the quotient is the high half of a 64-bit product computed in any two registers instead of edx:eax.
+    */
+    void gen_divide_by_constant(tuc::AsmList& code, tuc::Target target, const RegisterList& freeRegisters,
+                                std::int32_t constant, bool nonNegativeDividend = false) {
+        auto dst = freeRegisters.front();
+        auto exponent = tuc::power_of_two_exponent(constant);
+
+        if (constant == 1) {
+            return;
+        }
+        else if (exponent > 0 && nonNegativeDividend) {
+            emit(code, AsmOpcode::SHR, {reg(dst), imm(exponent)});
+        }
+        else if (exponent > 0 && freeRegisters.size() > 1) {
+            // add 2^k - 1 to negative dividends so that the arithmetic shift rounds toward zero
+            auto bias = freeRegisters[1];
+            emit(code, AsmOpcode::MOV, {reg(bias), reg(dst)});
+            if (exponent > 1)
+                emit(code, AsmOpcode::SAR, {reg(bias), imm(31)});
+            emit(code, AsmOpcode::SHR, {reg(bias), imm(32 - exponent)});
+            emit(code, AsmOpcode::ADD, {reg(dst), reg(bias)});
+            emit(code, AsmOpcode::SAR, {reg(dst), imm(exponent)});
+        }
+        else if (constant > 1 && target == tuc::Target::X86_64 && freeRegisters.size() > 1) {
+            auto magic = tuc::division_magic(constant);
+            auto product = freeRegisters[1];
+            auto multiplier = static_cast<std::int64_t>(magic.multiplier()) + magic.correction() * (std::int64_t{1} << 32);
+            emit(code, AsmOpcode::MOVSXD, {reg(product), reg(dst)}, 8);
+            emit(code, AsmOpcode::MOV, {reg(dst), imm(multiplier)}, 8);
+            emit(code, AsmOpcode::IMUL, {reg(product), reg(dst)}, 8);
+            emit(code, AsmOpcode::SAR, {reg(product), imm(32 + magic.shift())}, 8);
+            emit(code, AsmOpcode::MOV, {reg(dst), reg(product)});
+            if (!nonNegativeDividend) {
+                // add 1 to negative quotients, which the multiplication rounds toward negative infinity
+                emit(code, AsmOpcode::SHR, {reg(product), imm(31)});
+                emit(code, AsmOpcode::ADD, {reg(dst), reg(product)});
+            }
+        }
+        else if (constant > 1) {
+            auto magic = tuc::division_magic(constant);
+            auto savedRegisters = save_eax_edx(code, target, freeRegisters);
+
+            // the dividend is still needed after the multiplication if a correction must be applied
+            auto dividend = reg(dst);
+            auto dividendPushed = false;
+            if (magic.correction() != 0 && (dst == Register::AX || dst == Register::DX)) {
+                auto scratch = find_scratch_register(freeRegisters);
+                if (scratch.second) {
+                    emit(code, AsmOpcode::MOV, {reg(scratch.first), reg(dst)});
+                    dividend = reg(scratch.first);
+                }
+                else {
+                    emit_stack(code, target, AsmOpcode::PUSH, {reg(dst)});
+                    dividend = AsmOperand::mem(Register::SP);
+                    dividendPushed = true;
+                }
+            }
+
+            if (dst != Register::AX)
+                emit(code, AsmOpcode::MOV, {reg(Register::AX), reg(dst)});
+            emit(code, AsmOpcode::MOV, {reg(Register::DX), imm(magic.multiplier())});
+            emit(code, AsmOpcode::IMUL, {reg(Register::DX)});
+            if (magic.correction() > 0)
+                emit(code, AsmOpcode::ADD, {reg(Register::DX), dividend});
+            else if (magic.correction() < 0)
+                emit(code, AsmOpcode::SUB, {reg(Register::DX), dividend});
+            if (magic.shift() > 0)
+                emit(code, AsmOpcode::SAR, {reg(Register::DX), imm(magic.shift())});
+            if (!nonNegativeDividend) {
+                // add 1 to negative quotients, which the multiplication rounds toward negative infinity
+                emit(code, AsmOpcode::MOV, {reg(Register::AX), reg(Register::DX)});
+                emit(code, AsmOpcode::SHR, {reg(Register::AX), imm(31)});
+                emit(code, AsmOpcode::ADD, {reg(Register::DX), reg(Register::AX)});
+            }
+            if (dst != Register::DX)
+                emit(code, AsmOpcode::MOV, {reg(dst), reg(Register::DX)});
+
+            if (dividendPushed)
+                emit_stack(code, target, AsmOpcode::ADD, {reg(Register::SP), imm(tuc::address_size(target))});
+            restore_registers(code, target, savedRegisters);
+        }
+        else {
+            // division by zero is left to fault at run time
+            gen_divide(code, target, freeRegisters, imm(constant));
+        }
+    }
+
+    /*
+    Generates the instructions of a function in the intermediate representation. The instructions computing each value
+    are picked by the instruction selector, which covers the expression trees with the tiles of its rules. Registers
+    are assigned by a linear scan over the instructions: a value gets a register when it is defined and gives it back
+    after its last use. Since the IR generator orders expression trees by their Sethi-Ullman numbers, this uses as few
+    registers as possible; when none are left, the value used last is spilled to a stack slot. Constants never get a
+    register of their own: they are used as immediate operands or loaded directly into the register of the operation
+    using them. When the value ranges of the function are known, divisions of non-negative values use cheaper unsigned
+    sequences. The expression trees found in the superoptimizer table are replaced by the sequence of the table. The
+    operations inside a tile or a superoptimized tree get no register and the leaves live until the root. On x86-64,
+    values are still 32-bit but the eight extra registers are allocated too and the program exits with `syscall`.
+
+    The arguments of a call are passed in the registers in the order they are allocated (and pushed on the stack, the
+    last one first, when there are more) and the result is returned in eax. Instead of following a fixed convention on
+    which registers a call may overwrite, callees are generated before their callers so that a call only saves the
+    live values in the registers its callee actually writes (directly or through its own calls), by moving them to
+    registers it does not touch or to stack slots. A function only sets up a frame (saving ebp) when it has stack slots
+    or stack arguments. A call whose result is returned right away jumps to its callee instead (see `emit_tail_call()`),
+    so recursion in tail position runs in constant stack space. The entry of a memoized function looks its arguments up
+    in a memo table before running its body (see `gen_memo_lookup()`). A spawned call is handed to the pool of worker
+    threads and its join waits for it (see `emit_spawn()`); the entry point of a program with spawned calls starts the
+    pool and stops it before exiting.
+    */
+    class FunctionEmitter {
+        public:
+            FunctionEmitter(const tuc::IRProgram& _program, int _index, const std::vector<tuc::RegisterSet>& _clobbered,
+                            const std::vector<tuc::ValueRange>* _ranges, const tuc::SuperoptimizerTable* _superoptimizerTable,
+                            tuc::Target _target, bool _usesPool);
+            /*  `_clobbered` are the registers written by each function of the program (all of them for the functions
+                not generated yet); `_ranges` and `_superoptimizerTable` may be null if they are not known; `_usesPool`
+                is true if the program runs calls on worker threads */
+
+            tuc::AsmList gen_code();
+            /*  returns the instructions of the function */
+
+            tuc::RegisterSet clobbered_registers() const;
+            /*  returns the registers the function writes, including through its calls, once it is generated */
+
+            std::size_t memo_table_size() const noexcept;
+            /*  returns the size in bytes of the memo table of the function (0 if its results are not cached) */
+
+        private:
+            bool is_constant(tuc::ValueId value) const;
+
+            bool is_non_negative(tuc::ValueId value) const;
+
+            bool dies_at(tuc::ValueId value, int position) const;
+            /*  returns true if `value` is not used after `position` */
+
+            bool in_register(tuc::ValueId value) const;
+
+            AsmOperand operand(tuc::ValueId value) const;
+            /*  returns the register, memory operand, or immediate value holding `value` */
+
+            RegisterList free_registers() const;
+
+            AsmOperand new_slot();
+            /*  returns a stack slot that holds no value */
+
+            AsmOperand new_record(int words);
+            /*  returns the lowest of `words` consecutive stack slots that are never reused */
+
+            Register allocate(const std::vector<tuc::ValueId>& keep);
+            /*  returns a free register, spilling the value used last (other than those in `keep`) if there are none */
+
+            void release(tuc::ValueId value);
+            /*  frees the register or stack slot holding `value` */
+
+            void emit_tile(tuc::InstructionTile tile, int position);
+            /*  generates the instructions of a tile, or of each of its operations if the registers of an address are
+                not all available */
+
+            void emit_superoptimized(const tuc::ExpressionShape& shape, const tuc::AsmList& sequence, int position);
+            /*  generates the sequence of the superoptimizer table computing a tree, or the operations of the tree if
+                there are not enough free registers for it */
+
+            void save_live_registers(const tuc::RegisterSet& clobbers, int position);
+            /*  moves the values still used after `position` out of the registers in `clobbers` */
+
+            void emit_call(tuc::ValueId value, int position);
+
+            void emit_spawn(tuc::ValueId value, int position);
+
+            void emit_join(tuc::ValueId value, int position);
+
+            void emit_tail_call(tuc::ValueId value);
+            /*  generates a call whose result is returned right away as a jump */
+
+            void emit_return(tuc::ValueId value);
+
+            void emit_exit(tuc::ValueId value);
+
+            tuc::AsmList gen_memo_lookup(const RegisterList& keys, Register hash, Register slot);
+            /*  returns the code looking up the arguments in `keys` in the memo table of the function */
+
+            const tuc::IRProgram& program;
+            int index;                                                  // of the function in the program
+            const std::vector<tuc::RegisterSet>& clobbered;
+            const tuc::IRFunction& function;
+            const std::vector<tuc::ValueRange>* ranges;
+            const tuc::SuperoptimizerTable* superoptimizerTable;
+            const tuc::InstructionSelector* selector = nullptr;
+            tuc::Target target;
+            bool usesPool;
+            const RegisterList& registers;                              // the registers available to values
+            tuc::AsmList code;
+            std::vector<int> lastUse;                                   // position of the last use of each value
+            std::vector<AsmOperand> location;                           // where each value is held
+            std::unordered_map<int, tuc::ValueId> owners;               // the value held by each register
+            std::vector<AsmOperand> freeSlots;                          // stack slots that can be reused
+            int slotCount = 0;
+            tuc::RegisterSet callClobbers;                              // the registers written by the calls
+            std::vector<int> returns;                                   // the positions of the `ret`s and tail jumps
+            std::unordered_map<tuc::ValueId, AsmOperand> records;       // the record of each call run by a worker
+            std::size_t memoTableSize = 0;
+    };
+
+    FunctionEmitter::FunctionEmitter(const tuc::IRProgram& _program, int _index, const std::vector<tuc::RegisterSet>& _clobbered,
+                                     const std::vector<tuc::ValueRange>* _ranges,
+                                     const tuc::SuperoptimizerTable* _superoptimizerTable, tuc::Target _target,
+                                     bool _usesPool)
+    : program{_program}, index{_index}, clobbered{_clobbered}, function{_program[_index]}, ranges{_ranges},
+      superoptimizerTable{_superoptimizerTable}, target{_target}, usesPool{_usesPool},
+      registers{_target == tuc::Target::X86_64 ? generalRegisters64 : generalRegisters},
+      lastUse(function.instruction_count(), -1), location(function.instruction_count()) {
+        for (auto r : registers)
+            owners[static_cast<int>(r)] = tuc::no_value;
+    }
+
+    bool FunctionEmitter::is_constant(tuc::ValueId value) const {
+        return function.instruction(value).opcode() == tuc::IROpcode::CONSTANT;
+    }
+
+    bool FunctionEmitter::is_non_negative(tuc::ValueId value) const {
+        return ranges != nullptr && (*ranges)[value].is_non_negative();
+    }
+
+    /*
+    returns true if `value` is not used after `position`
+    */
+    bool FunctionEmitter::dies_at(tuc::ValueId value, int position) const {
+        return lastUse[value] <= position;
+    }
+
+    bool FunctionEmitter::in_register(tuc::ValueId value) const {
+        return location[value].type() == OperandType::REGISTER;
+    }
+
+    /*
+    returns the register, memory operand, or immediate value holding `value`
+    */
+    AsmOperand FunctionEmitter::operand(tuc::ValueId value) const {
+        if (is_constant(value))
+            return imm(function.instruction(value).immediate());
+        return location[value];
+    }
+
+    RegisterList FunctionEmitter::free_registers() const {
+        auto freeRegisters = RegisterList{};
+        for (auto r : registers) {
+            if (owners.at(static_cast<int>(r)) == tuc::no_value)
+                freeRegisters.push_back(r);
+        }
+        return freeRegisters;
+    }
+
+    /*
+    returns a stack slot that holds no value
+    */
+    AsmOperand FunctionEmitter::new_slot() {
+        if (freeSlots.empty()) {
+            slotCount++;
+            return AsmOperand::mem(Register::BP, -4 * slotCount);
+        }
+        auto slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    /*
+    returns the lowest of `words` consecutive stack slots that are never reused
+    */
+    AsmOperand FunctionEmitter::new_record(int words) {
+        slotCount += words;
+        return AsmOperand::mem(Register::BP, -4 * slotCount);
+    }
+
+    /*
+    returns a free register, spilling the value used last (other than those in `keep`) if there are none
+    */
+    Register FunctionEmitter::allocate(const std::vector<tuc::ValueId>& keep) {
+        auto freeRegisters = free_registers();
+        if (!freeRegisters.empty())
+            return freeRegisters.front();
+
+        auto victim = registers.front();
+        auto victimUse = -1;
+        for (auto r : registers) {
+            auto owner = owners.at(static_cast<int>(r));
+            if (std::find(keep.begin(), keep.end(), owner) == keep.end() && lastUse[owner] > victimUse) {
+                victim = r;
+                victimUse = lastUse[owner];
+            }
+        }
+
+        auto slot = new_slot();
+        emit(code, AsmOpcode::MOV, {slot, reg(victim)});
+        location[owners.at(static_cast<int>(victim))] = slot;
+        owners[static_cast<int>(victim)] = tuc::no_value;
+        return victim;
+    }
+
+    /*
+    frees the register or stack slot holding `value`
+    */
+    void FunctionEmitter::release(tuc::ValueId value) {
+        auto& l = location[value];
+        if (l.type() == OperandType::REGISTER)
+            owners[static_cast<int>(l.base())] = tuc::no_value;
+        else if (l.type() == OperandType::MEMORY && l.value() < 0)
+            freeSlots.push_back(l);     // stack arguments are above the frame and are not reused
+        l = AsmOperand{};
+    }
+
+    /*
+    generates the instructions of a tile, or of each of its operations if the registers of an address are not all
+    available
+
+    Most rules compute their result in two-address form (`dst = $0; dst = dst op $1`), so the register of the first leaf
+    is reused as `dst` when the leaf is not needed afterwards; the leaves of commutative operations are swapped when
+    only the second one can be reused. Rules computing an address read all their leaves before writing `dst`, which
+    can then take the register of any of them.
+    */
+    void FunctionEmitter::emit_tile(tuc::InstructionTile tile, int position) {
+        auto reusable = [&](tuc::ValueId leaf) { return !is_constant(leaf) && dies_at(leaf, position) && in_register(leaf); };
+        const auto& leaves = tile.leaves();
+        if (tile.commutes() && reusable(leaves[1]) && (is_constant(leaves[0]) || !dies_at(leaves[0], position)))
+            tile.swap_leaves();
+
+        if (tile.addresses_leaves() &&
+            std::any_of(leaves.cbegin(), leaves.cend(), [&](tuc::ValueId v) { return !is_constant(v) && !in_register(v); })) {
+            // spilled leaves must be kept until the operations using them are all generated
+            auto dying = std::vector<tuc::ValueId>{};
+            for (auto leaf : leaves) {
+                if (!is_constant(leaf) && dies_at(leaf, position) && std::find(dying.begin(), dying.end(), leaf) == dying.end()) {
+                    dying.push_back(leaf);
+                    lastUse[leaf] = position + 1;
+                }
+            }
+            for (auto v : tile.nodes())
+                emit_tile(selector->operation_tile(v), position);
+            for (auto leaf : dying) {
+                lastUse[leaf] = position;
+                release(leaf);
+            }
+            return;
+        }
+
+        auto dst = Register::AX;
+        auto reused = std::find_if(leaves.cbegin(), tile.addresses_leaves() ? leaves.cend() : leaves.cbegin() + 1, reusable);
+        if (reused != (tile.addresses_leaves() ? leaves.cend() : leaves.cbegin() + 1))
+            dst = location[*reused].base();
+        else
+            dst = allocate(leaves);
+
+        if (tile.action() == tuc::TileAction::INSTRUCTIONS) {
+            auto instructions = tile.expand(dst, [&](tuc::ValueId v) { return operand(v); });
+            code.insert(code.end(), instructions.cbegin(), instructions.cend());
+        }
+        else {
+            auto left = leaves[0];
+            auto right = leaves[1];
+            if (!operand(left).is_register(dst))
+                emit(code, AsmOpcode::MOV, {reg(dst), operand(left)});
+            if (tile.action() == tuc::TileAction::MULTIPLY_BY_CONSTANT) {
+                gen_multiply_by_constant(code, dst, function.instruction(right).immediate());
+            }
+            else {
+                // the registers that can be clobbered: `dst`, the free ones, and the divisor's if it is not used again
+                auto freeRegisters = RegisterList{dst};
+                for (auto r : registers) {
+                    auto owner = owners.at(static_cast<int>(r));
+                    if (r != dst && (owner == tuc::no_value || (owner == right && dies_at(right, position))))
+                        freeRegisters.push_back(r);
+                }
+                if (tile.action() == tuc::TileAction::DIVIDE_BY_CONSTANT)
+                    gen_divide_by_constant(code, target, freeRegisters, function.instruction(right).immediate(), is_non_negative(left));
+                else
+                    gen_divide(code, target, freeRegisters, operand(right), is_non_negative(left) && is_non_negative(right));
+            }
+        }
+
+        for (auto leaf = leaves.cbegin(); leaf != leaves.cend(); leaf++) {
+            if (!is_constant(*leaf) && dies_at(*leaf, position) && std::find(leaves.cbegin(), leaf, *leaf) == leaf)
+                release(*leaf);
+        }
+        auto value = tile.root();
+        owners[static_cast<int>(dst)] = value;
+        location[value] = reg(dst);
+        if (lastUse[value] < 0)
+            release(value);     // the result is never used
+    }
+
+    /*
+    generates the sequence of the superoptimizer table computing a tree, or the operations of the tree if there are not
+    enough free registers for it
+
+    The sequence expects the first input of the tree in eax (where it leaves the result), the second in ecx, and may
+    use edx as a scratch register; these are renamed to the registers of the inputs when they can be overwritten, or
+    to free registers otherwise.
+    */
+    void FunctionEmitter::emit_superoptimized(const tuc::ExpressionShape& shape, const tuc::AsmList& sequence, int position) {
+        auto reads = tuc::RegisterSet{};
+        auto writes = tuc::RegisterSet{};
+        for (const auto& instruction : sequence) {
+            reads |= tuc::registers_read(instruction);
+            writes |= tuc::registers_written(instruction);
+        }
+        auto used = [&](Register r) { return reads.test(static_cast<int>(r)) || writes.test(static_cast<int>(r)); };
+
+        const auto& inputs = shape.inputs();
+        auto first = inputs[0];
+        auto second = inputs.size() > 1 ? inputs[1] : tuc::no_value;
+        auto reuseFirst = dies_at(first, position) && in_register(first);
+        auto reuseSecond = second != tuc::no_value && in_register(second) &&
+                           (dies_at(second, position) || !writes.test(static_cast<int>(Register::CX)));
+        auto needed = (reuseFirst ? 0u : 1u) + (used(Register::CX) && !reuseSecond ? 1u : 0u) + (used(Register::DX) ? 1u : 0u);
+        auto freeRegisters = free_registers();
+        if (freeRegisters.size() < needed) {
+            // the inputs must outlive all the operations using them
+            auto dying = std::vector<tuc::ValueId>{};
+            for (auto input : inputs) {
+                if (dies_at(input, position)) {
+                    dying.push_back(input);
+                    lastUse[input] = position + 1;
+                }
+            }
+            for (auto v : shape.nodes())
+                emit_tile(selector->operation_tile(v), position);
+            for (auto input : dying) {
+                lastUse[input] = position;
+                release(input);
+            }
+            return;
+        }
+
+        auto next = freeRegisters.cbegin();
+        auto dst = reuseFirst ? location[first].base() : *next++;
+        if (!reuseFirst)
+            emit(code, AsmOpcode::MOV, {reg(dst), operand(first)});
+        auto renamed = std::unordered_map<int, Register>{{static_cast<int>(Register::AX), dst}};
+        if (used(Register::CX)) {
+            auto r = reuseSecond ? location[second].base() : *next++;
+            if (!reuseSecond && second != tuc::no_value)
+                emit(code, AsmOpcode::MOV, {reg(r), operand(second)});
+            renamed[static_cast<int>(Register::CX)] = r;
+        }
+        if (used(Register::DX))
+            renamed[static_cast<int>(Register::DX)] = *next++;
+
+        auto rename = [&](Register r) { return renamed.at(static_cast<int>(r)); };
+        for (auto instruction : sequence) {
+            for (int i = 0, count = instruction.operand_count(); i < count; i++) {
+                auto& o = instruction.operand(i);
+                if (o.type() == OperandType::REGISTER)
+                    o = reg(rename(o.base()));
+                else if (o.type() == OperandType::MEMORY && o.has_index())
+                    o = AsmOperand::mem(rename(o.base()), rename(o.index()), o.scale(), o.value());
+                else if (o.type() == OperandType::MEMORY)
+                    o = AsmOperand::mem(rename(o.base()), o.value());
+            }
+            code.push_back(instruction);
+        }
+
+        for (auto input : inputs) {
+            if (dies_at(input, position))
+                release(input);
+        }
+        auto value = shape.root();
+        owners[static_cast<int>(dst)] = value;
+        location[value] = reg(dst);
+        if (lastUse[value] < 0)
+            release(value);     // the result is never used
+    }
+
+    /*
+    moves the values still used after `position` out of the registers in `clobbers`, to registers outside of them or
+    to stack slots
+    */
+    void FunctionEmitter::save_live_registers(const tuc::RegisterSet& clobbers, int position) {
+        for (auto r : registers) {
+            auto owner = owners.at(static_cast<int>(r));
+            if (!clobbers.test(static_cast<int>(r)) || owner == tuc::no_value || dies_at(owner, position))
+                continue;
+            auto safe = std::find_if(registers.cbegin(), registers.cend(), [&](Register s) {
+                return owners.at(static_cast<int>(s)) == tuc::no_value && !clobbers.test(static_cast<int>(s));
+            });
+            auto destination = safe != registers.cend() ? reg(*safe) : new_slot();
+            emit(code, AsmOpcode::MOV, {destination, reg(r)});
+            owners[static_cast<int>(r)] = tuc::no_value;
+            if (safe != registers.cend())
+                owners[static_cast<int>(*safe)] = owner;
+            location[owner] = destination;
+        }
+    }
+
+    /*
+    generates a call: the live values in the registers written by the callee are moved out of them, then the arguments
+    are put in place and the result is taken from eax
+    */
+    void FunctionEmitter::emit_call(tuc::ValueId value, int position) {
+        const auto& call = function.instruction(value);
+        auto callee = call.immediate();
+        auto argumentCount = call.operand_count();
+        auto registerArgumentCount = std::min(argumentCount, static_cast<int>(registers.size()));
+
+        auto clobbers = clobbered[callee];
+        clobbers.set(static_cast<int>(Register::AX));
+        for (int i = 0; i < registerArgumentCount; i++)
+            clobbers.set(static_cast<int>(registers[i]));
+        callClobbers |= clobbers;
+        save_live_registers(clobbers, position);
+
+        for (auto i = argumentCount - 1; i >= registerArgumentCount; i--)
+            emit_stack(code, target, AsmOpcode::PUSH, {operand(function.operand(value, i))});
+        auto moves = std::vector<std::pair<Register, AsmOperand>>{};
+        for (int i = 0; i < registerArgumentCount; i++)
+            moves.emplace_back(registers[i], operand(function.operand(value, i)));
+        gen_parallel_move(code, target, moves, free_registers());
+        emit(code, AsmOpcode::CALL, {AsmOperand::label(function_label(program, callee))});
+        if (argumentCount > registerArgumentCount) {
+            auto stackSize = tuc::address_size(target) * (argumentCount - registerArgumentCount);
+            emit_stack(code, target, AsmOpcode::ADD, {reg(Register::SP), imm(stackSize)});
+        }
+
+        for (int i = 0; i < argumentCount; i++) {
+            auto argument = function.operand(value, i);
+            if (!is_constant(argument) && dies_at(argument, position) && location[argument].type() != OperandType::NONE)
+                release(argument);
+        }
+        owners[static_cast<int>(Register::AX)] = value;
+        location[value] = reg(Register::AX);
+        if (lastUse[value] < 0)
+            release(value);     // the result is never used
+    }
+
+    /*
+    generates a spawned call: the call is described by a record in the frame of the function (the callee, a word telling
+    whether it is done, its result, and its arguments) that `tuc_spawn` hands to a free worker thread, or marks as not
+    taken if there is none (see `gen_parallel_runtime()`); the calls that cannot run on a worker are plain calls
+    */
+    void FunctionEmitter::emit_spawn(tuc::ValueId value, int position) {
+        if (!runs_in_parallel(function, value, target)) {
+            emit_call(value, position);
+            return;
+        }
+
+        const auto& spawn = function.instruction(value);
+        auto argumentCount = spawn.operand_count();
+        auto clobbers = register_set({Register::AX, Register::CX, Register::DX, Register::SI, Register::DI, Register::R11});
+        callClobbers |= clobbers;
+        save_live_registers(clobbers, position);
+
+        // the arguments in memory are copied through eax once the others are stored
+        auto record = new_record(3 + argumentCount);
+        auto field = [&](int word) { return AsmOperand::mem(Register::BP, record.value() + 4 * word); };
+        for (auto inMemory : {false, true}) {
+            for (int i = 0; i < argumentCount; i++) {
+                auto argument = operand(function.operand(value, i));
+                if ((argument.type() == OperandType::MEMORY) != inMemory)
+                    continue;
+                if (inMemory) {
+                    emit(code, AsmOpcode::MOV, {reg(Register::AX), argument});
+                    argument = reg(Register::AX);
+                }
+                emit(code, AsmOpcode::MOV, {field(3 + i), argument});
+            }
+        }
+        emit(code, AsmOpcode::MOV, {field(0), imm(spawn.immediate())});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::AX), record});
+        emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_spawn")});
+
+        for (int i = 0; i < argumentCount; i++) {
+            auto argument = function.operand(value, i);
+            if (!is_constant(argument) && dies_at(argument, position) && location[argument].type() != OperandType::NONE)
+                release(argument);
+        }
+        records[value] = record;
+        location[value] = AsmOperand{};
+    }
+
+    /*
+    generates the join of a spawned call: `tuc_join` waits for the worker running the call to be done, or runs the call
+    itself if no worker took it, and returns the result in eax; the result of a plain call is just taken over
+    */
+    void FunctionEmitter::emit_join(tuc::ValueId value, int position) {
+        auto spawnValue = function.operand(value, 0);
+        const auto& spawn = function.instruction(spawnValue);
+        if (records.count(spawnValue) == 0) {
+            location[value] = location[spawnValue];
+            location[spawnValue] = AsmOperand{};
+            if (in_register(value))
+                owners[static_cast<int>(location[value].base())] = value;
+            if (lastUse[value] < 0)
+                release(value);     // the result is never used
+            return;
+        }
+
+        auto clobbers = clobbered[spawn.immediate()] |
+                        register_set({Register::AX, Register::CX, Register::DX, Register::SI, Register::DI, Register::R10, Register::R11});
+        for (int i = 0; i < spawn.operand_count(); i++)
+            clobbers.set(static_cast<int>(registers[i]));
+        callClobbers |= clobbers;
+        save_live_registers(clobbers, position);
+
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::AX), records.at(spawnValue)});
+        emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_join")});
+        owners[static_cast<int>(Register::AX)] = value;
+        location[value] = reg(Register::AX);
+        if (lastUse[value] < 0)
+            release(value);     // the result is never used
+    }
+
+    /*
+    generates a call whose result is returned right away (a tail call) as a jump, so that the callee returns straight to
+    the caller of the function and the stack does not grow: the arguments are moved to the registers of the parameters
+    and the frame is torn down before jumping; a call of the function itself jumps back to its first block instead,
+    which turns the recursion into a loop that keeps the frame
+    */
+    void FunctionEmitter::emit_tail_call(tuc::ValueId value) {
+        const auto& call = function.instruction(value);
+        auto callee = call.immediate();
+        auto moves = std::vector<std::pair<Register, AsmOperand>>{};
+        for (int i = 0, count = call.operand_count(); i < count; i++)
+            moves.emplace_back(registers[i], operand(function.operand(value, i)));
+        gen_parallel_move(code, target, moves, free_registers());
+        if (callee == index) {
+            emit(code, AsmOpcode::JMP, {AsmOperand::label(".block0")});
+            return;
+        }
+
+        // the registers the callee writes are written before the function returns
+        callClobbers |= clobbered[callee];
+        callClobbers.set(static_cast<int>(Register::AX));
+        returns.push_back(code.size());
+        emit(code, AsmOpcode::JMP, {AsmOperand::label(function_label(program, callee))});
+    }
+
+    void FunctionEmitter::emit_return(tuc::ValueId value) {
+        if (!operand(value).is_register(Register::AX))
+            emit(code, AsmOpcode::MOV, {reg(Register::AX), operand(value)});
+        returns.push_back(code.size());
+        emit(code, AsmOpcode::RET);
+    }
+
+    /*
+    generates the `exit` system call with `value` as the status: through `int 0x80` (system call 1, status in ebx) on
+    x86 and `syscall` (system call 60, status in edi) on x86-64, after stopping the worker threads if there are any
+    (`exit` only ends the thread making it)
+    */
+    void FunctionEmitter::emit_exit(tuc::ValueId value) {
+        if (target == tuc::Target::X86_64) {
+            if (!operand(value).is_register(Register::DI))
+                emit(code, AsmOpcode::MOV, {reg(Register::DI), operand(value)});
+            if (usesPool)
+                emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_stop_workers")});
+            emit(code, AsmOpcode::MOV, {reg(Register::AX), imm(60)});
+            emit(code, AsmOpcode::SYSCALL);
+            return;
+        }
+
+        if (!operand(value).is_register(Register::AX))
+            emit(code, AsmOpcode::MOV, {reg(Register::AX), operand(value)});
+        emit(code, AsmOpcode::MOV, {reg(Register::BX), reg(Register::AX)});
+        emit(code, AsmOpcode::MOV, {reg(Register::AX), imm(1)});
+        emit(code, AsmOpcode::INT, {imm(0x80)});
+    }
+
+    /*
+    returns the code looking up the arguments in `keys` in the memo table of the function, which returns the cached
+    result if it is there and otherwise calls the body of the function (at `.memo_compute`) and caches its result;
+    `hash` and `slot` are scratch registers holding no argument
+
+    The table is open addressed: the arguments are hashed (multiplicatively, keeping the top bits of the product) to
+    the first entry probed, and up to `memoProbes` consecutive entries are looked at, the table having enough entries
+    past the last one for probes never to wrap around. An entry is a flag set once the entry is filled, the arguments,
+    and the result. When all the entries probed hold other arguments, the last one is replaced. The arguments are
+    pushed across the call so that they can be stored with the result, and so is the address of the entry.
+    */
+    tuc::AsmList FunctionEmitter::gen_memo_lookup(const RegisterList& keys, Register hash, Register slot) {
+        auto lookup = tuc::AsmList{};
+        auto keyCount = static_cast<int>(keys.size());
+        auto entrySize = 4 * (keyCount + 2);
+        auto resultOffset = 4 * (keyCount + 1);
+        auto table = AsmOperand::label("memo_" + function.name());
+        memoTableSize = static_cast<std::size_t>(((1 << memoTableBits) + memoProbes - 1) * entrySize);
+
+        if (keyCount > 0) {
+            emit(lookup, AsmOpcode::MOV, {reg(hash), reg(keys.front())});
+            emit(lookup, AsmOpcode::IMUL, {reg(hash), imm(memoHashMultiplier)});
+            for (int i = 1; i < keyCount; i++) {
+                emit(lookup, AsmOpcode::ADD, {reg(hash), reg(keys[i])});
+                emit(lookup, AsmOpcode::IMUL, {reg(hash), imm(memoHashMultiplier)});
+            }
+            emit(lookup, AsmOpcode::SHR, {reg(hash), imm(32 - memoTableBits)});
+            emit(lookup, AsmOpcode::IMUL, {reg(hash), imm(entrySize)});
+        }
+        if (target == tuc::Target::X86_64)
+            emit_stack(lookup, target, AsmOpcode::LEA, {reg(slot), table});
+        else
+            emit(lookup, AsmOpcode::MOV, {reg(slot), table});
+        if (keyCount > 0)
+            emit_stack(lookup, target, AsmOpcode::ADD, {reg(slot), reg(hash)});
+
+        // a function without arguments only has one result to cache
+        auto probes = keyCount > 0 ? memoProbes : 1;
+        for (int p = 0; p < probes; p++) {
+            auto next = p + 1 < probes ? ".memo_probe" + std::to_string(p + 1) : std::string{".memo_miss"};
+            emit(lookup, AsmOpcode::CMP, {AsmOperand::mem(slot), imm(0)});
+            emit(lookup, AsmOpcode::JE, {AsmOperand::label(".memo_miss")});
+            for (int i = 0; i < keyCount; i++) {
+                emit(lookup, AsmOpcode::CMP, {AsmOperand::mem(slot, 4 * (i + 1)), reg(keys[i])});
+                emit(lookup, AsmOpcode::JNE, {AsmOperand::label(next)});
+            }
+            emit(lookup, AsmOpcode::MOV, {reg(Register::AX), AsmOperand::mem(slot, resultOffset)});
+            emit(lookup, AsmOpcode::RET);
+            if (p + 1 < probes) {
+                emit(lookup, AsmOpcode::LABEL, {AsmOperand::label(next)});
+                emit_stack(lookup, target, AsmOpcode::ADD, {reg(slot), imm(entrySize)});
+            }
+        }
+
+        emit(lookup, AsmOpcode::LABEL, {AsmOperand::label(".memo_miss")});
+        for (auto key : keys)
+            emit_stack(lookup, target, AsmOpcode::PUSH, {reg(key)});
+        emit_stack(lookup, target, AsmOpcode::PUSH, {reg(slot)});
+        emit(lookup, AsmOpcode::CALL, {AsmOperand::label(".memo_compute")});
+        emit_stack(lookup, target, AsmOpcode::POP, {reg(slot)});
+        emit(lookup, AsmOpcode::MOV, {AsmOperand::mem(slot, resultOffset), reg(Register::AX)});
+        for (int i = keyCount - 1; i >= 0; i--) {
+            emit_stack(lookup, target, AsmOpcode::POP, {reg(hash)});
+            emit(lookup, AsmOpcode::MOV, {AsmOperand::mem(slot, 4 * (i + 1)), reg(hash)});
+        }
+        emit(lookup, AsmOpcode::MOV, {AsmOperand::mem(slot), imm(1)});
+        emit(lookup, AsmOpcode::RET);
+        return lookup;
+    }
+
+    /*
+    returns the instructions of the function
+    */
+    tuc::AsmList FunctionEmitter::gen_code() {
+        auto order = function.linear_order();
+        auto positionOf = std::vector<int>(function.instruction_count(), -1);
+        for (int position = 0, count = order.size(); position < count; position++)
+            positionOf[order[position]] = position;
+
+        // the operations of superoptimized trees are all generated at the position of the root
+        auto shapes = std::vector<tuc::ExpressionShape>{};
+        if (superoptimizerTable != nullptr) {
+            shapes = tuc::match_expression_shapes(function, [&](const tuc::ExpressionShape& shape) {
+                return superoptimizerTable->lookup(shape.key()) != nullptr;
+            });
+        }
+        auto shapeOf = std::vector<int>(function.instruction_count(), -1);
+        for (int s = 0, count = shapes.size(); s < count; s++) {
+            auto nodes = shapes[s].nodes();
+            std::sort(nodes.begin(), nodes.end(), [&](tuc::ValueId a, tuc::ValueId b) { return positionOf[a] < positionOf[b]; });
+            shapes[s] = tuc::ExpressionShape{shapes[s].key(), shapes[s].root(), shapes[s].inputs(), nodes};
+            for (auto v : nodes) {
+                shapeOf[v] = s;
+                positionOf[v] = positionOf[shapes[s].root()];
+            }
+        }
+
+        // so are the operations covered by a tile; the superoptimized trees are left out of the tiles
+        auto fixed = std::vector<bool>(function.instruction_count(), false);
+        for (const auto& shape : shapes) {
+            for (auto v : shape.nodes())
+                fixed[v] = true;
+            for (auto v : shape.inputs())
+                fixed[v] = true;
+        }
+        auto instructionSelector = tuc::InstructionSelector{function, fixed};
+        selector = &instructionSelector;
+        for (auto v : order) {
+            auto tile = selector->tile(v);
+            if (tile != nullptr && shapeOf[v] < 0) {
+                for (auto node : tile->nodes())
+                    positionOf[node] = positionOf[v];
+            }
+        }
+
+        for (auto v : order) {
+            for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++)
+                lastUse[function.operand(v, i)] = std::max(lastUse[function.operand(v, i)], positionOf[v]);
+        }
+
+        // the arguments are where the caller put them; the results of a memoized function are cached for the ones
+        // its body uses
+        auto stackArguments = false;
+        auto keys = RegisterList{};
+        for (auto v : order) {
+            const auto& instruction = function.instruction(v);
+            if (instruction.opcode() != tuc::IROpcode::PARAMETER)
+                continue;
+            auto p = instruction.immediate();
+            if (p < static_cast<int>(registers.size())) {
+                location[v] = reg(registers[p]);
+                owners[static_cast<int>(registers[p])] = v;
+            }
+            else {
+                auto addressSize = tuc::address_size(target);
+                location[v] = AsmOperand::mem(Register::BP, 2 * addressSize + addressSize * (p - static_cast<int>(registers.size())));
+                stackArguments = true;
+            }
+            if (lastUse[v] < 0)
+                release(v);
+            else if (p < static_cast<int>(registers.size()))
+                keys.push_back(registers[p]);
+        }
+
+        if (index == 0 && usesPool)
+            emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_start_workers")});
+
+        auto position = 0;
+        for (tuc::BlockId b = 0, count = function.block_count(); b < count; b++) {
+            emit(code, AsmOpcode::LABEL, {AsmOperand::label(".block" + std::to_string(b))});
+
+            // tail calls whose arguments do not all fit in registers are left as calls, since the callee may need more
+            // stack arguments than the function got from its caller
+            auto tailCall = tail_call(function, b);
+            if (tailCall != tuc::no_value && function.instruction(tailCall).operand_count() > static_cast<int>(registers.size()))
+                tailCall = tuc::no_value;
+
+            for (auto v : function.block(b).instructions()) {
+                const auto& instruction = function.instruction(v);
+                switch (instruction.opcode()) {
+                case tuc::IROpcode::CONSTANT:
+                case tuc::IROpcode::PARAMETER:
+                    break;
+                case tuc::IROpcode::ADD:
+                case tuc::IROpcode::SUBTRACT:
+                case tuc::IROpcode::MULTIPLY:
+                case tuc::IROpcode::DIVIDE:
+                    if (shapeOf[v] < 0 && selector->tile(v) != nullptr)
+                        emit_tile(*selector->tile(v), position);
+                    else if (shapeOf[v] >= 0 && shapes[shapeOf[v]].root() == v)
+                        emit_superoptimized(shapes[shapeOf[v]], *superoptimizerTable->lookup(shapes[shapeOf[v]].key()), position);
+                    break;
+                case tuc::IROpcode::JUMP:
+                    if (instruction.immediate() != b + 1)
+                        emit(code, AsmOpcode::JMP, {AsmOperand::label(".block" + std::to_string(instruction.immediate()))});
+                    break;
+                case tuc::IROpcode::CALL:
+                    if (v == tailCall)
+                        emit_tail_call(v);
+                    else
+                        emit_call(v, position);
+                    break;
+                case tuc::IROpcode::SPAWN:
+                    emit_spawn(v, position);
+                    break;
+                case tuc::IROpcode::JOIN:
+                    emit_join(v, position);
+                    break;
+                case tuc::IROpcode::RETURN:
+                    if (function.operand(v, 0) != tailCall)
+                        emit_return(function.operand(v, 0));
+                    break;
+                case tuc::IROpcode::EXIT:
+                    emit_exit(function.operand(v, 0));
+                    break;
+                }
+                position++;
+            }
+        }
+
+        auto framed = slotCount > 0 || stackArguments;
+        auto functionCode = tuc::AsmList{};
+        emit(functionCode, AsmOpcode::LABEL, {AsmOperand::label(function_label(program, index))});
+
+        // the lookup needs two scratch registers, neither an argument nor eax (which holds the result), and the stack
+        // arguments would no longer be where the body expects them once it is called from the lookup
+        auto scratch = RegisterList{};
+        for (auto r : registers) {
+            if (r != Register::AX && std::find(keys.cbegin(), keys.cend(), r) == keys.cend())
+                scratch.push_back(r);
+        }
+        if (function.memoized() && index != 0 && !stackArguments && scratch.size() >= 2) {
+            auto lookup = gen_memo_lookup(keys, scratch[0], scratch[1]);
+            for (const auto& instruction : lookup) {
+                if (instruction.opcode() != AsmOpcode::CALL)
+                    callClobbers |= tuc::registers_written(instruction);
+            }
+            functionCode.insert(functionCode.end(), lookup.cbegin(), lookup.cend());
+            emit(functionCode, AsmOpcode::LABEL, {AsmOperand::label(".memo_compute")});
+        }
+
+        if (framed) {
+            if (index != 0)
+                emit_stack(functionCode, target, AsmOpcode::PUSH, {reg(Register::BP)});     // the entry point has no caller
+            emit_stack(functionCode, target, AsmOpcode::MOV, {reg(Register::BP), reg(Register::SP)});
+        }
+        if (slotCount > 0)
+            emit_stack(functionCode, target, AsmOpcode::SUB, {reg(Register::SP), imm(4 * slotCount)});
+        for (auto r = returns.crbegin(); framed && r != returns.crend(); r++) {
+            auto epilogue = tuc::AsmList{};
+            if (slotCount > 0)
+                emit_stack(epilogue, target, AsmOpcode::MOV, {reg(Register::SP), reg(Register::BP)});
+            emit_stack(epilogue, target, AsmOpcode::POP, {reg(Register::BP)});
+            code.insert(code.begin() + *r, epilogue.cbegin(), epilogue.cend());
+        }
+        functionCode.insert(functionCode.end(), code.cbegin(), code.cend());
+        return functionCode;
+    }
+
+    /*
+    returns the registers the function writes, including through its calls, once it is generated; the stack and frame
+    pointers are always restored and so are not part of them
+    */
+    tuc::RegisterSet FunctionEmitter::clobbered_registers() const {
+        auto written = callClobbers;
+        for (const auto& instruction : code) {
+            if (instruction.opcode() != AsmOpcode::CALL)
+                written |= tuc::registers_written(instruction);
+        }
+        return written & register_set(registers);
+    }
+
+    std::size_t FunctionEmitter::memo_table_size() const noexcept {
+        return memoTableSize;
+    }
+
+    /*
+    generates a system call other than the exit of the program (on x86-64), the number of the call being its operand
+    */
+    void emit_syscall(tuc::AsmList& code, int number) {
+        emit(code, AsmOpcode::MOV, {reg(Register::AX), imm(number)});
+        emit(code, AsmOpcode::SYSCALL, {imm(number)});
+    }
+
+    /*
+    generates `tuc_start_workers`, which starts `workerCount` worker threads, or one for each processor the program may
+    run on but the one of the main thread (counting the first 64, and starting `maxWorkers` at most) if it is 0
+
+    Each worker is a thread made by `clone` with its own stack, which starts at `tuc_worker` with the address of its box
+    on the stack. A box stays busy until its worker is waiting for calls.
+    */
+    tuc::AsmList gen_start_workers(int workerCount) {
+        const auto target = tuc::Target::X86_64;
+        auto code = tuc::AsmList{};
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_start_workers")});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::R14), AsmOperand::label("tuc_pool")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::R9), reg(Register::R14)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::R12), AsmOperand::label("tuc_stacks")});
+        emit(code, AsmOpcode::MOV, {reg(Register::R13), imm(workerCount > 0 ? workerCount : maxWorkers)});
+        if (workerCount > 0) {
+            emit(code, AsmOpcode::MOV, {reg(Register::BX), imm(workerCount + 1)});
+        }
+        else {
+            // the bits of the affinity mask are counted one at a time: x - 2 * (x >> 1) is the lowest bit of x
+            emit_stack(code, target, AsmOpcode::SUB, {reg(Register::SP), imm(128)});
+            emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SP), imm(0)});
+            emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SP, 4), imm(0)});
+            emit(code, AsmOpcode::XOR, {reg(Register::DI), reg(Register::DI)});
+            emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(128)});
+            emit_stack(code, target, AsmOpcode::MOV, {reg(Register::DX), reg(Register::SP)});
+            emit_syscall(code, 204);    // sched_getaffinity
+            emit(code, AsmOpcode::MOV, {reg(Register::AX), AsmOperand::mem(Register::SP)}, 8);
+            emit_stack(code, target, AsmOpcode::ADD, {reg(Register::SP), imm(128)});
+            emit(code, AsmOpcode::XOR, {reg(Register::BX), reg(Register::BX)});
+            emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_count")});
+            emit(code, AsmOpcode::CMP, {reg(Register::AX), imm(0)}, 8);
+            emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_next")});
+            emit(code, AsmOpcode::MOV, {reg(Register::DX), reg(Register::AX)}, 8);
+            emit(code, AsmOpcode::SHR, {reg(Register::AX), imm(1)}, 8);
+            emit(code, AsmOpcode::SUB, {reg(Register::DX), reg(Register::AX)}, 8);
+            emit(code, AsmOpcode::SUB, {reg(Register::DX), reg(Register::AX)}, 8);
+            emit(code, AsmOpcode::ADD, {reg(Register::BX), reg(Register::DX)});
+            emit(code, AsmOpcode::JMP, {AsmOperand::label(".pool_count")});
+        }
+
+        // ebx counts the threads left to start (including the main thread), r13 the boxes left, r9 points to the box
+        // of the worker and r12 to the top of its stack
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_next")});
+        emit(code, AsmOpcode::CMP, {reg(Register::BX), imm(1)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_started")});
+        emit(code, AsmOpcode::CMP, {reg(Register::BX), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_started")});
+        emit(code, AsmOpcode::CMP, {reg(Register::R13), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_started")});
+        emit(code, AsmOpcode::SUB, {reg(Register::BX), imm(1)});
+        emit(code, AsmOpcode::SUB, {reg(Register::R13), imm(1)});
+        emit_stack(code, target, AsmOpcode::ADD, {reg(Register::R9), imm(workerBoxSize)});
+        emit_stack(code, target, AsmOpcode::ADD, {reg(Register::R12), imm(workerStackSize)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::R9), imm(1)});
+        emit(code, AsmOpcode::MOV, {reg(Register::DI), imm(cloneThreadFlags)});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::SI), reg(Register::R12)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DX), AsmOperand::mem(Register::R9, 16)});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::R10), reg(Register::DX)});
+        emit(code, AsmOpcode::XOR, {reg(Register::R8), reg(Register::R8)});
+        emit_syscall(code, 56);         // clone
+        emit(code, AsmOpcode::CMP, {reg(Register::AX), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_worker")});
+        emit(code, AsmOpcode::ADD, {AsmOperand::mem(Register::R14), imm(1)});
+        emit(code, AsmOpcode::JMP, {AsmOperand::label(".pool_next")});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_worker")});
+        emit_stack(code, target, AsmOpcode::PUSH, {reg(Register::R9)});
+        emit(code, AsmOpcode::JMP, {AsmOperand::label("tuc_worker")});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_started")});
+        emit(code, AsmOpcode::RET);
+        return code;
+    }
+
+    /*
+    generates `tuc_worker`, the loop of a worker thread: it marks its box as free, sleeps until it is posted work, then
+    runs the call of the record it was given, marks its box as free again, and wakes up the thread waiting for the
+    call (if any) once the record says it is done; the thread ends when it is posted 2 instead of a call
+    */
+    tuc::AsmList gen_worker() {
+        const auto target = tuc::Target::X86_64;
+        auto code = tuc::AsmList{};
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_worker")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::SI), AsmOperand::mem(Register::SP)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SI), imm(0)});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_wait")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::SI), AsmOperand::mem(Register::SP)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::SI, 4)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWait | futexPrivate)});
+        emit(code, AsmOpcode::XOR, {reg(Register::DX), reg(Register::DX)});
+        emit(code, AsmOpcode::XOR, {reg(Register::R10), reg(Register::R10)});
+        emit_syscall(code, 202);        // futex
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::SI), AsmOperand::mem(Register::SP)});
+        emit(code, AsmOpcode::MOV, {reg(Register::CX), AsmOperand::mem(Register::SI, 4)});
+        emit(code, AsmOpcode::CMP, {reg(Register::CX), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SI, 4), imm(0)});
+        emit(code, AsmOpcode::CMP, {reg(Register::CX), imm(2)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_quit")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::DX), AsmOperand::mem(Register::SI, 8)});
+        emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_run_call")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::SI), AsmOperand::mem(Register::SP)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SI), imm(0)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::DX, 4), imm(1)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::DX, 4)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWake | futexPrivate)});
+        emit(code, AsmOpcode::MOV, {reg(Register::DX), imm(1)});
+        emit_syscall(code, 202);        // futex
+        emit(code, AsmOpcode::JMP, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_quit")});
+        emit(code, AsmOpcode::XOR, {reg(Register::DI), reg(Register::DI)});
+        emit_syscall(code, 60);         // exit (of the thread)
+        return code;
+    }
+
+    /*
+    generates `tuc_spawn` and `tuc_join`, which take the address of the record of a call in rax
+
+    `tuc_spawn` claims the first free worker by exchanging its busy word with 1, gives it the record and wakes it up;
+    when no worker is free, the record is marked as not taken (-1 instead of 0 for running) so that `tuc_join` runs the
+    call itself.  Otherwise `tuc_join` sleeps until the worker marks the record as done.
+    */
+    tuc::AsmList gen_spawn_and_join() {
+        const auto target = tuc::Target::X86_64;
+        auto code = tuc::AsmList{};
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_spawn")});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::SI), AsmOperand::label("tuc_pool")});
+        emit(code, AsmOpcode::MOV, {reg(Register::DI), AsmOperand::mem(Register::SI)});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_next")});
+        emit(code, AsmOpcode::CMP, {reg(Register::DI), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_none")});
+        emit(code, AsmOpcode::SUB, {reg(Register::DI), imm(1)});
+        emit_stack(code, target, AsmOpcode::ADD, {reg(Register::SI), imm(workerBoxSize)});
+        emit(code, AsmOpcode::MOV, {reg(Register::CX), imm(1)});
+        emit(code, AsmOpcode::XCHG, {AsmOperand::mem(Register::SI), reg(Register::CX)});
+        emit(code, AsmOpcode::CMP, {reg(Register::CX), imm(0)});
+        emit(code, AsmOpcode::JNE, {AsmOperand::label(".pool_next")});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::AX, 4), imm(0)});
+        emit_stack(code, target, AsmOpcode::MOV, {AsmOperand::mem(Register::SI, 8), reg(Register::AX)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::SI, 4), imm(1)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::SI, 4)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWake | futexPrivate)});
+        emit(code, AsmOpcode::MOV, {reg(Register::DX), imm(1)});
+        emit_syscall(code, 202);        // futex
+        emit(code, AsmOpcode::RET);
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_none")});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::AX, 4), imm(-1)});
+        emit(code, AsmOpcode::RET);
+
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_join")});
+        emit(code, AsmOpcode::CMP, {AsmOperand::mem(Register::AX, 4), imm(-1)});
+        emit(code, AsmOpcode::JNE, {AsmOperand::label(".pool_wait")});
+        emit_stack(code, target, AsmOpcode::MOV, {reg(Register::DX), reg(Register::AX)});
+        emit(code, AsmOpcode::CALL, {AsmOperand::label("tuc_run_call")});
+        emit(code, AsmOpcode::MOV, {reg(Register::AX), AsmOperand::mem(Register::DX, 8)});
+        emit(code, AsmOpcode::RET);
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::CMP, {AsmOperand::mem(Register::AX, 4), imm(0)});
+        emit(code, AsmOpcode::JNE, {AsmOperand::label(".pool_done")});
+        emit_stack(code, target, AsmOpcode::PUSH, {reg(Register::AX)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::AX, 4)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWait | futexPrivate)});
+        emit(code, AsmOpcode::XOR, {reg(Register::DX), reg(Register::DX)});
+        emit(code, AsmOpcode::XOR, {reg(Register::R10), reg(Register::R10)});
+        emit_syscall(code, 202);        // futex
+        emit_stack(code, target, AsmOpcode::POP, {reg(Register::AX)});
+        emit(code, AsmOpcode::JMP, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_done")});
+        emit(code, AsmOpcode::MOV, {reg(Register::AX), AsmOperand::mem(Register::AX, 8)});
+        emit(code, AsmOpcode::RET);
+        return code;
+    }
+
+    /*
+    generates `tuc_run_call`, which runs the call of the record whose address is in rdx: it jumps to the code calling
+    the function of the record (`tuc_call_<name>`), which loads the arguments in the registers they are passed in and
+    stores the result in the record, keeping rdx
+    */
+    tuc::AsmList gen_run_call(const tuc::IRProgram& program, const std::map<int, int>& callees) {
+        const auto target = tuc::Target::X86_64;
+        auto code = tuc::AsmList{};
+        auto call_label = [&](int callee) { return AsmOperand::label("tuc_call_" + program[callee].name()); };
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_run_call")});
+        for (auto c = callees.cbegin(); c != callees.cend(); c++) {
+            if (std::next(c) == callees.cend()) {
+                emit(code, AsmOpcode::JMP, {call_label(c->first)});
+                break;
+            }
+            emit(code, AsmOpcode::CMP, {AsmOperand::mem(Register::DX), imm(c->first)});
+            emit(code, AsmOpcode::JE, {call_label(c->first)});
+        }
+        for (const auto& c : callees) {
+            emit(code, AsmOpcode::LABEL, {call_label(c.first)});
+            for (int i = 0; i < c.second; i++)
+                emit(code, AsmOpcode::MOV, {reg(generalRegisters64[i]), AsmOperand::mem(Register::DX, 12 + 4 * i)});
+            emit_stack(code, target, AsmOpcode::PUSH, {reg(Register::DX)});
+            emit(code, AsmOpcode::CALL, {AsmOperand::label(function_label(program, c.first))});
+            emit_stack(code, target, AsmOpcode::POP, {reg(Register::DX)});
+            emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::DX, 8), reg(Register::AX)});
+            emit(code, AsmOpcode::RET);
+        }
+        return code;
+    }
+
+    /*
+    generates `tuc_stop_workers`, which posts 2 to every worker and waits for its thread to end (the kernel clears the
+    thread id in its box and wakes up the threads waiting on it), keeping the exit status in edi
+    */
+    tuc::AsmList gen_stop_workers() {
+        const auto target = tuc::Target::X86_64;
+        auto code = tuc::AsmList{};
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label("tuc_stop_workers")});
+        emit_stack(code, target, AsmOpcode::PUSH, {reg(Register::DI)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::R9), AsmOperand::label("tuc_pool")});
+        emit(code, AsmOpcode::MOV, {reg(Register::BX), AsmOperand::mem(Register::R9)});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_next")});
+        emit(code, AsmOpcode::CMP, {reg(Register::BX), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_stopped")});
+        emit(code, AsmOpcode::SUB, {reg(Register::BX), imm(1)});
+        emit_stack(code, target, AsmOpcode::ADD, {reg(Register::R9), imm(workerBoxSize)});
+        emit(code, AsmOpcode::MOV, {AsmOperand::mem(Register::R9, 4), imm(2)});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::R9, 4)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWake | futexPrivate)});
+        emit(code, AsmOpcode::MOV, {reg(Register::DX), imm(1)});
+        emit_syscall(code, 202);        // futex
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::MOV, {reg(Register::DX), AsmOperand::mem(Register::R9, 16)});
+        emit(code, AsmOpcode::CMP, {reg(Register::DX), imm(0)});
+        emit(code, AsmOpcode::JE, {AsmOperand::label(".pool_next")});
+        emit_stack(code, target, AsmOpcode::LEA, {reg(Register::DI), AsmOperand::mem(Register::R9, 16)});
+        emit(code, AsmOpcode::MOV, {reg(Register::SI), imm(futexWait)});
+        emit(code, AsmOpcode::XOR, {reg(Register::R10), reg(Register::R10)});
+        emit_syscall(code, 202);        // futex
+        emit(code, AsmOpcode::JMP, {AsmOperand::label(".pool_wait")});
+        emit(code, AsmOpcode::LABEL, {AsmOperand::label(".pool_stopped")});
+        emit_stack(code, target, AsmOpcode::POP, {reg(Register::DI)});
+        emit(code, AsmOpcode::RET);
+        return code;
+    }
+
+    /*
+    returns the code of the runtime running spawned calls on a pool of worker threads, for a program generated for
+    x86-64 whose spawned calls are those of `callees` (with their number of arguments), and the data it reserves
+
+    The generated programs have no C library, so the threads are made with the `clone` system call and sleep on futexes
+    when they have nothing to do. The pool (`tuc_pool`) starts with the number of workers, followed by a box for each of
+    them: a word telling whether the worker is busy, the word it sleeps on until it is posted a call (1) or told to stop
+    (2), the address of the record of its call, and its thread id. The stacks of the workers are reserved in
+    `tuc_stacks`. A call is run on whichever worker is free when it is spawned, and by the thread joining it otherwise,
+    so a program runs correctly (if not faster) however many workers there are, even none.
+    */
+    tuc::AsmList gen_parallel_runtime(const tuc::IRProgram& program, const std::map<int, int>& callees, int workerCount) {
+        auto code = gen_start_workers(workerCount);
+        for (const auto& part : {gen_worker(), gen_spawn_and_join(), gen_run_call(program, callees), gen_stop_workers()})
+            code.insert(code.end(), part.cbegin(), part.cend());
+        auto boxCount = workerCount > 0 ? workerCount : maxWorkers;
+        code.emplace_back(AsmOpcode::RESERVE, std::vector<AsmOperand>{AsmOperand::label("tuc_pool"),
+                                                                      imm(workerBoxSize * (boxCount + 1))});
+        code.emplace_back(AsmOpcode::RESERVE, std::vector<AsmOperand>{AsmOperand::label("tuc_stacks"),
+                                                                      imm(static_cast<std::int64_t>(workerStackSize) * boxCount)});
+        return code;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
 /*
-generates assembly code from a syntax tree and symbol table
+generates the instructions of a program in the intermediate representation for a target, using the ranges of its values
+and the superoptimizer table (if given) to pick cheaper instruction sequences; the spawned calls of the program run on
+a pool of `workerCount` threads, or one per processor if it is 0
 */
-std::string tuc::gen_expr_asm(SyntaxNode* node, const SymbolTable& symTable) {
-    using NodeType = tuc::SyntaxNode::NodeType;
-    auto outputASM = std::stringstream{};
-    auto firstOperand = node->child(0);
-    auto secondOperand = node->child(1);
-    auto firstIsOperator = firstOperand->is_operator();
-    auto secondIsOperator = secondOperand->is_operator();
-    auto firstIsLiteral = (firstOperand->type() == NodeType::INTEGER);
-    auto secondIsLiteral = (secondOperand->type() == NodeType::INTEGER);
-
-    if (firstIsOperator && secondIsOperator) {
-        outputASM << gen_expr_asm(secondOperand, symTable); // evaluate the right hand side first so that the result
-        outputASM << "push eax\n";                          //   from the left hand side ends up in eax. This makes it
-        outputASM << gen_expr_asm(firstOperand, symTable);  //   easy to ensures that the result of the current
-        outputASM << "pop ebx\n";                           //   operation also ends up in eax.
-
-        if (node->type() == NodeType::ADD)
-            outputASM << "add eax, ebx\n";
-        else if (node->type() == NodeType::SUBTRACT)
-            outputASM << "sub eax, ebx\n";
-        else if (node->type() == NodeType::MULTIPLY)
-            outputASM << "imul eax, ebx\n";
-        else if (node->type() == NodeType::DIVIDE)
-            outputASM << "idiv ebx\n";
-
-    } else if (firstIsLiteral && secondIsOperator) {
-        outputASM << gen_expr_asm(secondOperand, symTable); // result is put in eax so must be moved to ebx for
-                                                            //   some instructions
-
-        if (node->type() == NodeType::ADD) {
-            outputASM << "add eax, " << std::stoi(firstOperand->value()) << "\n";
-        } else if (node->type() == NodeType::SUBTRACT) {
-            outputASM << "mov ebx, eax\nmov eax, " << std::stoi(firstOperand->value()) << "\nsub eax, ebx\n";
-        } else if (node->type() == NodeType::MULTIPLY) {
-            outputASM << "imul eax, " << std::stoi(firstOperand->value()) << "\n";
-        } else if (node->type() == NodeType::DIVIDE) {
-            outputASM << "mov ebx, eax\nmov eax, " << std::stoi(firstOperand->value()) << "\nidiv ebx\n";
-        }
-
-    } else if (firstIsOperator && secondIsLiteral) {
-        outputASM << gen_expr_asm(firstOperand, symTable);
-
-        if (node->type() == NodeType::ADD) {
-            outputASM << "add eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::SUBTRACT) {
-            outputASM << "sub eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::MULTIPLY) {
-            outputASM << "imul eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::DIVIDE) {
-            outputASM << "mov ebx, " << std::stoi(secondOperand->value()) << "\nidiv ebx\n";
-        }
-
-    } else if (firstIsLiteral && secondIsLiteral) {
-        if (node->type() == NodeType::ADD) {
-            outputASM   << "mov eax, " << std::stoi(firstOperand->value())
-                        << "\nadd eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::SUBTRACT) {
-            outputASM   << "mov eax, " << std::stoi(firstOperand->value())
-                        << "\nsub eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::MULTIPLY) {
-            outputASM   << "mov eax, " << std::stoi(firstOperand->value())
-                        << "\nimul eax, " << std::stoi(secondOperand->value()) << "\n";
-        } else if (node->type() == NodeType::DIVIDE) {
-            outputASM   << "mov eax, " << std::stoi(firstOperand->value())
-                        << "\nmov ebx, " << std::stoi(secondOperand->value()) << "\nidiv ebx\n";
-        }
+tuc::AsmList tuc::gen_program_code(const IRProgram& program, const ValueRangeAnalysis::Result* ranges,
+                                   const SuperoptimizerTable* superoptimizerTable, Target target, int workerCount) {
+    // until a function is generated, calls to it (which can only be recursive) assume it writes every register
+    auto clobbered = std::vector<RegisterSet>(program.size(), register_set(target == Target::X86_64 ? generalRegisters64 : generalRegisters));
+    auto callees = parallel_callees(program, target);
+    auto functionCode = std::vector<AsmList>(program.size());
+    auto memoTableSizes = std::vector<std::size_t>(program.size(), 0);
+    for (auto f : generation_order(program)) {
+        auto rangesOfFunction = ranges != nullptr ? &(*ranges)[f] : nullptr;
+        auto emitter = FunctionEmitter{program, f, clobbered, rangesOfFunction, superoptimizerTable, target, !callees.empty()};
+        functionCode[f] = emitter.gen_code();
+        clobbered[f] = emitter.clobbered_registers();
+        memoTableSizes[f] = emitter.memo_table_size();
     }
 
+    // the memo tables are reserved after the code, and the runtime of parallel calls comes last
+    auto code = AsmList{};
+    for (const auto& instructions : functionCode)
+        code.insert(code.end(), instructions.cbegin(), instructions.cend());
+    for (int f = 0, count = program.size(); f < count; f++) {
+        if (memoTableSizes[f] > 0)
+            code.emplace_back(AsmOpcode::RESERVE, std::vector<AsmOperand>{AsmOperand::label("memo_" + program[f].name()),
+                                                                          imm(static_cast<std::int64_t>(memoTableSizes[f]))});
+    }
+    if (!callees.empty()) {
+        auto runtime = gen_parallel_runtime(program, callees, workerCount);
+        code.insert(code.end(), runtime.cbegin(), runtime.cend());
+    }
+    return code;
+}
+
+/*
+generates the nasm assembly code of a program from its instructions for a target
+*/
+std::string tuc::gen_program_asm(const AsmList& code, Target target) {
+    auto outputASM = std::ostringstream{};
+    if (target == Target::X86_64)
+        outputASM << "bits 64\n";
+    outputASM << "section .text\nglobal _start\n\n";
+    auto data = AsmList{};
+    for (const auto& instruction : code) {
+        if (instruction.opcode() == AsmOpcode::RESERVE)
+            data.push_back(instruction);
+        else
+            put_instruction(outputASM, instruction, target) << "\n";
+    }
+    if (!data.empty()) {
+        outputASM << "\nsection .bss\n";
+        for (const auto& instruction : data)
+            put_instruction(outputASM << "alignb 16\n", instruction, target) << "\n";
+    }
     return outputASM.str();
 }
@@ -0,0 +1,535 @@
+/*
+Project: TUC
+File: asm_instruction.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "asm_instruction.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <sstream>
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::AsmOperand tuc::AsmOperand::reg(Register r) {
+    auto o = AsmOperand{};
+    o.operandType = OperandType::REGISTER;
+    o.baseRegister = r;
+    return o;
+}
+
+tuc::AsmOperand tuc::AsmOperand::imm(std::int64_t value) {
+    auto o = AsmOperand{};
+    o.operandType = OperandType::IMMEDIATE;
+    o.operandValue = value;
+    return o;
+}
+
+tuc::AsmOperand tuc::AsmOperand::mem(Register base, std::int32_t displacement) {
+    auto o = AsmOperand{};
+    o.operandType = OperandType::MEMORY;
+    o.baseRegister = base;
+    o.operandValue = displacement;
+    return o;
+}
+
+tuc::AsmOperand tuc::AsmOperand::mem(Register base, Register index, int scale, std::int32_t displacement) {
+    auto o = mem(base, displacement);
+    o.indexRegister = index;
+    o.hasIndex = true;
+    o.indexScale = scale;
+    return o;
+}
+
+tuc::AsmOperand tuc::AsmOperand::label(const std::string& name) {
+    auto o = AsmOperand{};
+    o.operandType = OperandType::LABEL;
+    o.labelName = name;
+    return o;
+}
+
+tuc::AsmOperand::OperandType tuc::AsmOperand::type() const noexcept {
+    return operandType;
+}
+
+/*
+returns true if the operand is the register `r`
+*/
+bool tuc::AsmOperand::is_register(Register r) const noexcept {
+    return operandType == OperandType::REGISTER && baseRegister == r;
+}
+
+/*
+returns the register of a REGISTER operand or the base register of a MEMORY operand
+*/
+tuc::Register tuc::AsmOperand::base() const noexcept {
+    return baseRegister;
+}
+
+bool tuc::AsmOperand::has_index() const noexcept {
+    return hasIndex;
+}
+
+tuc::Register tuc::AsmOperand::index() const noexcept {
+    return indexRegister;
+}
+
+int tuc::AsmOperand::scale() const noexcept {
+    return indexScale;
+}
+
+/*
+returns the value of an IMMEDIATE operand or the displacement of a MEMORY operand
+*/
+std::int64_t tuc::AsmOperand::value() const noexcept {
+    return operandValue;
+}
+
+/*
+returns the name of a LABEL operand
+*/
+std::string tuc::AsmOperand::name() const noexcept {
+    return labelName;
+}
+
+bool tuc::AsmOperand::operator==(const AsmOperand& other) const noexcept {
+    if (operandType != other.operandType)
+        return false;
+    switch (operandType) {
+    case OperandType::REGISTER:     return baseRegister == other.baseRegister;
+    case OperandType::IMMEDIATE:    return operandValue == other.operandValue;
+    case OperandType::LABEL:        return labelName == other.labelName;
+    case OperandType::MEMORY:       return baseRegister == other.baseRegister && hasIndex == other.hasIndex &&
+                                           (!hasIndex || (indexRegister == other.indexRegister && indexScale == other.indexScale)) &&
+                                           operandValue == other.operandValue;
+    default:                        return true;
+    }
+}
+
+bool tuc::AsmOperand::operator!=(const AsmOperand& other) const noexcept {
+    return !(*this == other);
+}
+
+
+
+tuc::AsmInstruction::AsmInstruction(AsmOpcode _opcode, std::vector<AsmOperand> _operands, int _size)
+: instructionOpcode{_opcode}, instructionOperands{std::move(_operands)}, operandSize{_size} {}
+
+tuc::AsmOpcode tuc::AsmInstruction::opcode() const noexcept {
+    return instructionOpcode;
+}
+
+int tuc::AsmInstruction::operand_count() const noexcept {
+    return instructionOperands.size();
+}
+
+const tuc::AsmOperand& tuc::AsmInstruction::operand(int i) const noexcept {
+    return instructionOperands[i];
+}
+
+tuc::AsmOperand& tuc::AsmInstruction::operand(int i) noexcept {
+    return instructionOperands[i];
+}
+
+int tuc::AsmInstruction::size() const noexcept {
+    return operandSize;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the name of a register when used with operands of `size` bytes (4 or 8)
+*/
+std::string tuc::register_name(Register r, int size) {
+    static const char* legacyNames[] = {"ax", "cx", "dx", "bx", "sp", "bp", "si", "di"};
+    auto n = static_cast<int>(r);
+    if (n < 8)
+        return (size == 8 ? "r" : "e") + std::string{legacyNames[n]};
+    return "r" + std::to_string(n) + (size == 8 ? "" : "d");
+}
+
+/*
+returns the registers (and flags) read by an instruction, including implicit operands
+*/
+tuc::RegisterSet tuc::registers_read(const AsmInstruction& instruction) {
+    auto read = RegisterSet{};
+    auto bit = [](Register r) { return static_cast<int>(r); };
+
+    // registers used to compute memory addresses are always read
+    for (int i = 0, c = instruction.operand_count(); i < c; i++) {
+        const auto& o = instruction.operand(i);
+        if (o.type() == AsmOperand::OperandType::MEMORY) {
+            read.set(bit(o.base()));
+            if (o.has_index())
+                read.set(bit(o.index()));
+        }
+    }
+
+    // a register source operand is read; a register destination is read unless it is only written
+    auto readRegisterOperand = [&](int i) {
+        if (i < instruction.operand_count() && instruction.operand(i).type() == AsmOperand::OperandType::REGISTER)
+            read.set(bit(instruction.operand(i).base()));
+    };
+
+    switch (instruction.opcode()) {
+    case AsmOpcode::MOV:
+    case AsmOpcode::LEA:
+    case AsmOpcode::MOVSXD:
+        readRegisterOperand(1);
+        break;
+    case AsmOpcode::XOR:
+        if (instruction.operand(0) != instruction.operand(1)) {  // `xor r, r` does not depend on `r`
+            readRegisterOperand(0);
+            readRegisterOperand(1);
+        }
+        break;
+    case AsmOpcode::ADD:
+    case AsmOpcode::SUB:
+    case AsmOpcode::SHL:
+    case AsmOpcode::SHR:
+    case AsmOpcode::SAR:
+    case AsmOpcode::CMP:
+        readRegisterOperand(0);
+        readRegisterOperand(1);
+        break;
+    case AsmOpcode::IMUL:
+        if (instruction.operand_count() == 1) {
+            read.set(bit(Register::AX));
+            readRegisterOperand(0);
+        }
+        else if (instruction.operand_count() == 2) {
+            readRegisterOperand(0);
+            readRegisterOperand(1);
+        }
+        else {
+            readRegisterOperand(1);
+        }
+        break;
+    case AsmOpcode::IDIV:
+    case AsmOpcode::DIV:
+        read.set(bit(Register::AX));
+        read.set(bit(Register::DX));
+        readRegisterOperand(0);
+        break;
+    case AsmOpcode::CDQ:
+        read.set(bit(Register::AX));
+        break;
+    case AsmOpcode::NEG:
+        readRegisterOperand(0);
+        break;
+    case AsmOpcode::PUSH:
+        readRegisterOperand(0);
+        read.set(bit(Register::SP));
+        break;
+    case AsmOpcode::POP:
+        read.set(bit(Register::SP));
+        break;
+    case AsmOpcode::INT:
+        // the only system call made by generated code is exit, which takes its status in ebx
+        read.set(bit(Register::AX));
+        read.set(bit(Register::BX));
+        break;
+    case AsmOpcode::SYSCALL:
+        // on x86-64, exit takes its status in edi; the other system calls take up to six arguments
+        read.set(bit(Register::AX));
+        read.set(bit(Register::DI));
+        if (instruction.operand_count() > 0) {
+            for (auto r : {Register::SI, Register::DX, Register::R10, Register::R8, Register::R9})
+                read.set(bit(r));
+        }
+        break;
+    case AsmOpcode::XCHG:
+        readRegisterOperand(0);
+        readRegisterOperand(1);
+        break;
+    case AsmOpcode::JMP:
+        read.set();     // the code at the target may use any register
+        read.reset(flags_bit);
+        break;
+    case AsmOpcode::JE:
+    case AsmOpcode::JNE:
+        read.set();     // the flags, and any register the code at the target may use
+        break;
+    case AsmOpcode::RET:
+        // the caller gets the value returned in eax and keeps its own values in the registers the function does not
+        // write, so their content must be what it was on entry
+        read.set();
+        read.reset(flags_bit);
+        break;
+    case AsmOpcode::CALL:
+        // the arguments may be in any register
+        read.set();
+        read.reset(flags_bit);
+        break;
+    default:
+        break;
+    }
+    return read;
+}
+
+/*
+returns the registers (and flags) written by an instruction, including implicit operands
+*/
+tuc::RegisterSet tuc::registers_written(const AsmInstruction& instruction) {
+    auto written = RegisterSet{};
+    auto bit = [](Register r) { return static_cast<int>(r); };
+    auto writeRegisterOperand = [&]() {
+        if (instruction.operand_count() > 0 && instruction.operand(0).type() == AsmOperand::OperandType::REGISTER)
+            written.set(bit(instruction.operand(0).base()));
+    };
+
+    switch (instruction.opcode()) {
+    case AsmOpcode::MOV:
+    case AsmOpcode::LEA:
+    case AsmOpcode::MOVSXD:
+        writeRegisterOperand();
+        break;
+    case AsmOpcode::ADD:
+    case AsmOpcode::SUB:
+    case AsmOpcode::XOR:
+    case AsmOpcode::NEG:
+    case AsmOpcode::SHL:
+    case AsmOpcode::SHR:
+    case AsmOpcode::SAR:
+        writeRegisterOperand();
+        written.set(flags_bit);
+        break;
+    case AsmOpcode::IMUL:
+        if (instruction.operand_count() == 1) {
+            written.set(bit(Register::AX));
+            written.set(bit(Register::DX));
+        }
+        else {
+            writeRegisterOperand();
+        }
+        written.set(flags_bit);
+        break;
+    case AsmOpcode::IDIV:
+    case AsmOpcode::DIV:
+        written.set(bit(Register::AX));
+        written.set(bit(Register::DX));
+        written.set(flags_bit);
+        break;
+    case AsmOpcode::CDQ:
+        written.set(bit(Register::DX));
+        break;
+    case AsmOpcode::CMP:
+        written.set(flags_bit);
+        break;
+    case AsmOpcode::PUSH:
+        written.set(bit(Register::SP));
+        break;
+    case AsmOpcode::POP:
+        writeRegisterOperand();
+        written.set(bit(Register::SP));
+        break;
+    case AsmOpcode::XCHG:
+        for (int i = 0, c = instruction.operand_count(); i < c; i++) {
+            if (instruction.operand(i).type() == AsmOperand::OperandType::REGISTER)
+                written.set(bit(instruction.operand(i).base()));
+        }
+        break;
+    case AsmOpcode::RET:
+        written.set(bit(Register::SP));
+        break;
+    case AsmOpcode::CALL:
+        written.set();  // the function may overwrite any register
+        break;
+    case AsmOpcode::SYSCALL:
+        written.set(bit(Register::AX));
+        written.set(bit(Register::CX));
+        written.set(bit(Register::R11));
+        break;
+    default:
+        break;
+    }
+    return written;
+}
+
+/*
+returns the size in bytes of addresses (and of the registers pushed on the stack) on a target
+*/
+int tuc::address_size(Target target) noexcept {
+    return target == Target::X86_64 ? 8 : 4;
+}
+
+/*
+returns true if an instruction is the system call ending the program; the other system calls (those of the runtime of
+parallel calls) have the number of the call as their operand
+*/
+bool tuc::is_exit(const AsmInstruction& instruction) noexcept {
+    return instruction.opcode() == AsmOpcode::INT ||
+           (instruction.opcode() == AsmOpcode::SYSCALL && instruction.operand_count() == 0);
+}
+
+/*
+returns true if an instruction does more than write registers
+*/
+bool tuc::has_side_effects(const AsmInstruction& instruction) {
+    switch (instruction.opcode()) {
+    case AsmOpcode::MOV:
+    case AsmOpcode::ADD:
+    case AsmOpcode::SUB:
+    case AsmOpcode::IMUL:
+    case AsmOpcode::XOR:
+    case AsmOpcode::NEG:
+    case AsmOpcode::SHL:
+    case AsmOpcode::SHR:
+    case AsmOpcode::SAR:
+        // writing to memory is a side effect
+        return instruction.operand(0).type() == AsmOperand::OperandType::MEMORY;
+    case AsmOpcode::LEA:
+    case AsmOpcode::CDQ:
+    case AsmOpcode::MOVSXD:
+    case AsmOpcode::CMP:
+        return false;
+    default:
+        return true;    // labels, stack operations, control flow, and divisions (which may trap)
+    }
+}
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+puts an instruction in an output stream using nasm syntax (with 32-bit addresses)
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::AsmInstruction& instruction) {
+    return tuc::put_instruction(os, instruction, tuc::Target::X86);
+}
+
+/*
+puts a list of instructions in an output stream using nasm syntax, one per line
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::AsmList& code) {
+    for (const auto& instruction : code)
+        os << instruction << "\n";
+    return os;
+}
+
+/*
+puts an instruction in an output stream using nasm syntax, with the registers of memory operands named for the
+addresses of `target`
+*/
+std::ostream& tuc::put_instruction(std::ostream& os, const AsmInstruction& instruction, Target target) {
+    using OperandType = tuc::AsmOperand::OperandType;
+
+    if (instruction.opcode() == AsmOpcode::LABEL)
+        return os << instruction.operand(0).name() << ":";
+    if (instruction.opcode() == AsmOpcode::RESERVE)
+        return os << instruction.operand(0).name() << ": resb " << instruction.operand(1).value();
+
+    switch (instruction.opcode()) {
+    case AsmOpcode::MOV:    os << "mov"; break;
+    case AsmOpcode::ADD:    os << "add"; break;
+    case AsmOpcode::SUB:    os << "sub"; break;
+    case AsmOpcode::IMUL:   os << "imul"; break;
+    case AsmOpcode::IDIV:   os << "idiv"; break;
+    case AsmOpcode::DIV:    os << "div"; break;
+    case AsmOpcode::CDQ:    os << (instruction.size() == 8 ? "cqo" : "cdq"); break;
+    case AsmOpcode::NEG:    os << "neg"; break;
+    case AsmOpcode::XOR:    os << "xor"; break;
+    case AsmOpcode::SHL:    os << "shl"; break;
+    case AsmOpcode::SHR:    os << "shr"; break;
+    case AsmOpcode::SAR:    os << "sar"; break;
+    case AsmOpcode::LEA:    os << "lea"; break;
+    case AsmOpcode::PUSH:   os << "push"; break;
+    case AsmOpcode::POP:    os << "pop"; break;
+    case AsmOpcode::JMP:    os << "jmp"; break;
+    case AsmOpcode::INT:    os << "int"; break;
+    case AsmOpcode::SYSCALL: os << "syscall"; break;
+    case AsmOpcode::MOVSXD: os << "movsxd"; break;
+    case AsmOpcode::RET:    os << "ret"; break;
+    case AsmOpcode::CALL:   os << "call"; break;
+    case AsmOpcode::CMP:    os << "cmp"; break;
+    case AsmOpcode::JE:     os << "je"; break;
+    case AsmOpcode::JNE:    os << "jne"; break;
+    case AsmOpcode::XCHG:   os << "xchg"; break;
+    default:                os << "???"; break;
+    }
+
+    // the number of a system call is only there for the code generator: it is already in eax
+    if (instruction.opcode() == AsmOpcode::SYSCALL)
+        return os;
+
+    for (int i = 0, c = instruction.operand_count(); i < c; i++) {
+        const auto& o = instruction.operand(i);
+        os << (i == 0 ? " " : ", ");
+        switch (o.type()) {
+        case OperandType::REGISTER:
+            // the source of `movsxd` is the 32-bit register being sign extended
+            os << tuc::register_name(o.base(), instruction.opcode() == AsmOpcode::MOVSXD && i > 0 ? 4 : instruction.size());
+            break;
+        case OperandType::IMMEDIATE:
+            if (instruction.opcode() == AsmOpcode::INT)
+                os << std::hex << o.value() << std::dec << "h";
+            else
+                os << o.value();
+            break;
+        case OperandType::MEMORY:
+            if (instruction.opcode() != AsmOpcode::LEA)
+                os << (instruction.size() == 8 ? "qword " : "dword ");
+            os << "[" << tuc::register_name(o.base(), address_size(target));
+            if (o.has_index())
+                os << " + " << tuc::register_name(o.index(), address_size(target)) << "*" << o.scale();
+            if (o.value() > 0)
+                os << " + " << o.value();
+            else if (o.value() < 0)
+                os << " - " << -o.value();
+            os << "]";
+            break;
+        case OperandType::LABEL:
+            // an address in the data of a program, relative to the instruction on x86-64
+            if (instruction.opcode() == AsmOpcode::LEA)
+                os << "[rel " << o.name() << "]";
+            else
+                os << o.name();
+            break;
+        default: {
+            // a value the code generator has no location for, which would be printed as nothing
+            auto text = std::ostringstream{};
+            put_instruction(text, AsmInstruction{instruction.opcode(), {}, instruction.size()}, target);
+            throw CompilerException::InvalidInstruction{text.str(), "operand " + std::to_string(i + 1) + " has no location"};
+        }
+        }
+    }
+    return os;
+}
@@ -0,0 +1,367 @@
+/*
+Project: TUC
+File: bytecode.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+// project headers
+#include "bytecode.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+
+// the virtual machine jumps straight from one instruction's code to the next one's through a table of label addresses
+// (a GNU extension) where it can, and loops over a switch statement where it cannot
+#ifndef TUC_THREADED_DISPATCH
+#if defined(__GNUC__)
+#define TUC_THREADED_DISPATCH 1
+#else
+#define TUC_THREADED_DISPATCH 0
+#endif
+#endif
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+    using tuc::BytecodeOpcode;
+    using NeedMap = std::unordered_map<const tuc::SyntaxNode*, int>;
+
+    bool is_literal(const tuc::SyntaxNode* node) {
+        return node->type() == NodeType::INTEGER;
+    }
+
+    bool is_expression(const tuc::SyntaxNode* node) {
+        return node->is_operator() || is_literal(node) || node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL;
+    }
+
+    /*
+    returns the opcodes of an operation on two registers, on a register and an immediate value, and on an immediate
+    value and a register
+    */
+    struct OperationOpcodes {
+        BytecodeOpcode registers;
+        BytecodeOpcode immediate;
+        BytecodeOpcode reverseImmediate;
+    };
+
+    OperationOpcodes opcodes_of(const tuc::SyntaxNode* node) {
+        switch (node->type()) {
+        case NodeType::ADD:
+            return {BytecodeOpcode::ADD, BytecodeOpcode::ADD_IMMEDIATE, BytecodeOpcode::ADD_IMMEDIATE};
+        case NodeType::SUBTRACT:
+            return {BytecodeOpcode::SUBTRACT, BytecodeOpcode::SUBTRACT_IMMEDIATE, BytecodeOpcode::REVERSE_SUBTRACT_IMMEDIATE};
+        case NodeType::MULTIPLY:
+            return {BytecodeOpcode::MULTIPLY, BytecodeOpcode::MULTIPLY_IMMEDIATE, BytecodeOpcode::MULTIPLY_IMMEDIATE};
+        default:
+            return {BytecodeOpcode::DIVIDE, BytecodeOpcode::DIVIDE_IMMEDIATE, BytecodeOpcode::REVERSE_DIVIDE_IMMEDIATE};
+        }
+    }
+
+    /*
+    records the number of registers needed to evaluate every node of an expression tree; a literal operand of an
+    operation is an immediate value and needs none, so only a literal on its own needs a register
+    */
+    int label_tree(const tuc::SyntaxNode* node, NeedMap& needs) {
+        auto need = 1;
+        if (node->is_operator()) {
+            auto left = label_tree(node->child(0), needs);
+            auto right = label_tree(node->child(1), needs);
+            if (is_literal(node->child(0)) || is_literal(node->child(1)))
+                need = std::max(left, right);
+            else
+                need = left == right ? left + 1 : std::max(left, right);
+        }
+        needs[node] = need;
+        return need;
+    }
+
+    /*
+    lowers an expression tree into the instructions computing its value in register `target`, using only the
+    registers after it for intermediate values; the operand needing the most registers is computed first
+    */
+    void gen_expression(tuc::Bytecode& code, const tuc::SyntaxNode* node, int target, const NeedMap& needs) {
+        if (target >= tuc::Bytecode::max_registers) {
+            throw tuc::CompilerException::UnimplementedFeature{node->position(), "very deeply nested expressions",
+                "the expression needs more than " + std::to_string(tuc::Bytecode::max_registers) + " bytecode registers"};
+        }
+
+        if (is_literal(node)) {
+            code.append_with_immediate(BytecodeOpcode::LOAD, target, 0, std::stoi(node->value()));
+            return;
+        }
+        else if (node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL) {
+            throw tuc::CompilerException::UnimplementedFeature{node->position(), "function calls in bytecode",
+                "`" + node->value() + "` cannot be called because the interpreter only evaluates arithmetic"};
+        }
+
+        auto left = node->child(0);
+        auto right = node->child(1);
+        auto opcodes = opcodes_of(node);
+        if (is_literal(right)) {
+            gen_expression(code, left, target, needs);
+            code.append_with_immediate(opcodes.immediate, target, target, std::stoi(right->value()));
+        }
+        else if (is_literal(left)) {
+            gen_expression(code, right, target, needs);
+            code.append_with_immediate(opcodes.reverseImmediate, target, target, std::stoi(left->value()));
+        }
+        else if (needs.at(left) >= needs.at(right)) {
+            gen_expression(code, left, target, needs);
+            gen_expression(code, right, target + 1, needs);
+            code.append(opcodes.registers, target, target, target + 1);
+        }
+        else {
+            gen_expression(code, right, target, needs);
+            gen_expression(code, left, target + 1, needs);
+            code.append(opcodes.registers, target, target + 1, target);
+        }
+    }
+
+    const char* operator_of(BytecodeOpcode opcode) {
+        switch (opcode) {
+        case BytecodeOpcode::ADD:
+        case BytecodeOpcode::ADD_IMMEDIATE:
+            return "+";
+        case BytecodeOpcode::SUBTRACT:
+        case BytecodeOpcode::SUBTRACT_IMMEDIATE:
+        case BytecodeOpcode::REVERSE_SUBTRACT_IMMEDIATE:
+            return "-";
+        case BytecodeOpcode::MULTIPLY:
+        case BytecodeOpcode::MULTIPLY_IMMEDIATE:
+            return "*";
+        default:
+            return "/";
+        }
+    }
+
+    bool has_immediate(BytecodeOpcode opcode) {
+        return opcode == BytecodeOpcode::LOAD || (opcode >= BytecodeOpcode::ADD_IMMEDIATE && opcode <= BytecodeOpcode::REVERSE_DIVIDE_IMMEDIATE);
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+appends an instruction on registers `a`, `b`, and `c`
+*/
+void tuc::Bytecode::append(BytecodeOpcode opcode, int a, int b, int c) {
+    codeWords.push_back(static_cast<Word>(opcode) | static_cast<Word>(a) << 8 | static_cast<Word>(b) << 16 |
+                        static_cast<Word>(c) << 24);
+    registerCount = std::max({registerCount, a + 1, b + 1, c + 1});
+}
+
+/*
+appends an instruction on registers `a` and `b` followed by its immediate value
+*/
+void tuc::Bytecode::append_with_immediate(BytecodeOpcode opcode, int a, int b, std::int32_t immediate) {
+    append(opcode, a, b);
+    codeWords.push_back(static_cast<Word>(immediate));
+}
+
+const std::vector<tuc::Bytecode::Word>& tuc::Bytecode::words() const noexcept {
+    return codeWords;
+}
+
+int tuc::Bytecode::register_count() const noexcept {
+    return registerCount;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+lowers a program's syntax tree to bytecode; each top-level expression is computed in register 0 (so that the
+registers of one are free for the next) and the program exits with the last value computed there
+*/
+tuc::Bytecode tuc::gen_bytecode(const SyntaxNode* root) {
+    auto code = Bytecode{};
+    auto hasValue = false;
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (!is_expression(statement))
+            continue;   // declarations and definitions are not evaluated
+
+        auto needs = NeedMap{};
+        label_tree(statement, needs);
+        gen_expression(code, statement, 0, needs);
+        hasValue = true;
+    }
+
+    if (!hasValue)
+        code.append_with_immediate(BytecodeOpcode::LOAD, 0, 0, 0);
+    code.append(BytecodeOpcode::EXIT, 0);
+    return code;
+}
+
+/*
+runs a program with exact 32-bit (wrapping) arithmetic and sets `exitValue` to the value it exits with; returns false
+if the program traps instead
+
+Registers hold unsigned values so that additions, subtractions, and multiplications wrap around the way the machine's
+do (signed overflow is undefined in C++); only division needs the signed values. Each instruction's code ends by
+dispatching the next one: with threaded dispatch, by jumping to the address of its code in `handlers` (which is in the
+order of the opcodes), so that every instruction has its own indirect jump for the branch predictor to learn.
+*/
+bool tuc::run_bytecode(const Bytecode& code, std::int32_t& exitValue) {
+    auto registers = std::vector<std::uint32_t>(std::max(code.register_count(), 1), 0);
+    auto r = registers.data();
+    auto pc = code.words().data();
+    auto word = Bytecode::Word{};
+    auto a = [&]() { return (word >> 8) & 0xff; };
+    auto b = [&]() { return (word >> 16) & 0xff; };
+    auto c = [&]() { return word >> 24; };
+    auto traps = [](std::uint32_t dividend, std::uint32_t divisor) {
+        return divisor == 0 || (dividend == 0x80000000u && divisor == 0xffffffffu);
+    };
+    auto divide = [](std::uint32_t dividend, std::uint32_t divisor) {
+        return static_cast<std::uint32_t>(static_cast<std::int32_t>(dividend) / static_cast<std::int32_t>(divisor));
+    };
+
+#if TUC_THREADED_DISPATCH
+    static void* const handlers[] = {&&LOAD, &&ADD, &&SUBTRACT, &&MULTIPLY, &&DIVIDE, &&ADD_IMMEDIATE,
+                                     &&SUBTRACT_IMMEDIATE, &&MULTIPLY_IMMEDIATE, &&DIVIDE_IMMEDIATE,
+                                     &&REVERSE_SUBTRACT_IMMEDIATE, &&REVERSE_DIVIDE_IMMEDIATE, &&EXIT};
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == static_cast<int>(BytecodeOpcode::EXIT) + 1,
+                  "every opcode needs a handler");
+#define NEXT() do { word = *pc++; goto *handlers[word & 0xff]; } while (false)
+#define OPERATION(opcode) opcode
+    NEXT();
+#else
+#define NEXT() goto next
+#define OPERATION(opcode) case BytecodeOpcode::opcode
+    next:
+    word = *pc++;
+    switch (static_cast<BytecodeOpcode>(word & 0xff)) {
+#endif
+
+    OPERATION(LOAD):
+        r[a()] = *pc++;
+        NEXT();
+    OPERATION(ADD):
+        r[a()] = r[b()] + r[c()];
+        NEXT();
+    OPERATION(SUBTRACT):
+        r[a()] = r[b()] - r[c()];
+        NEXT();
+    OPERATION(MULTIPLY):
+        r[a()] = r[b()] * r[c()];
+        NEXT();
+    OPERATION(DIVIDE):
+        if (traps(r[b()], r[c()]))
+            return false;
+        r[a()] = divide(r[b()], r[c()]);
+        NEXT();
+    OPERATION(ADD_IMMEDIATE):
+        r[a()] = r[b()] + *pc++;
+        NEXT();
+    OPERATION(SUBTRACT_IMMEDIATE):
+        r[a()] = r[b()] - *pc++;
+        NEXT();
+    OPERATION(MULTIPLY_IMMEDIATE):
+        r[a()] = r[b()] * *pc++;
+        NEXT();
+    OPERATION(DIVIDE_IMMEDIATE):
+        if (traps(r[b()], *pc))
+            return false;
+        r[a()] = divide(r[b()], *pc++);
+        NEXT();
+    OPERATION(REVERSE_SUBTRACT_IMMEDIATE):
+        r[a()] = *pc++ - r[b()];
+        NEXT();
+    OPERATION(REVERSE_DIVIDE_IMMEDIATE):
+        if (traps(*pc, r[b()]))
+            return false;
+        r[a()] = divide(*pc++, r[b()]);
+        NEXT();
+    OPERATION(EXIT):
+        exitValue = static_cast<std::int32_t>(r[a()]);
+        return true;
+
+#if !TUC_THREADED_DISPATCH
+    }
+    return false;
+#endif
+#undef NEXT
+#undef OPERATION
+}
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+puts a textual representation of a program's bytecode in an output stream, one instruction per line
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::Bytecode& code) {
+    const auto& words = code.words();
+    for (std::size_t i = 0; i < words.size(); i++) {
+        auto word = words[i];
+        auto opcode = static_cast<tuc::BytecodeOpcode>(word & 0xff);
+        auto a = (word >> 8) & 0xff;
+        auto b = (word >> 16) & 0xff;
+        auto c = word >> 24;
+        auto immediate = has_immediate(opcode) ? static_cast<std::int32_t>(words[++i]) : 0;
+        switch (opcode) {
+        case tuc::BytecodeOpcode::LOAD:
+            os << "r" << a << " = " << immediate;
+            break;
+        case tuc::BytecodeOpcode::EXIT:
+            os << "exit r" << a;
+            break;
+        case tuc::BytecodeOpcode::REVERSE_SUBTRACT_IMMEDIATE:
+        case tuc::BytecodeOpcode::REVERSE_DIVIDE_IMMEDIATE:
+            os << "r" << a << " = " << immediate << " " << operator_of(opcode) << " r" << b;
+            break;
+        default:
+            os << "r" << a << " = r" << b << " " << operator_of(opcode) << " ";
+            if (has_immediate(opcode))
+                os << immediate;
+            else
+                os << "r" << c;
+            break;
+        }
+        os << "\n";
+    }
+    return os;
+}
@@ -0,0 +1,200 @@
+/*
+Project: TUC
+File: c_generator.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+// project headers
+#include "c_generator.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <sstream>
+#include <unordered_set>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+
+    bool is_literal(const tuc::SyntaxNode* node) {
+        return node->type() == NodeType::INTEGER;
+    }
+
+    bool is_expression(const tuc::SyntaxNode* node) {
+        return node->is_operator() || is_literal(node) || node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL;
+    }
+
+    /*
+    the C names of the functions and parameters of the source are prefixed so that they never clash with keywords or
+    with the names of the C library
+    */
+    std::string c_name(const std::string& name) {
+        return "u_" + name;
+    }
+
+    /*
+    puts the C declaration of the function defined by an assignment (without the `;` or the body)
+    */
+    void put_function_head(std::ostream& os, const tuc::SyntaxNode* definition) {
+        auto head = definition->child(0);
+        os << "static uint32_t " << c_name(head->value()) << "(";
+        for (int i = 0, count = head->child_count(); i < count; i++)
+            os << (i > 0 ? ", " : "") << "uint32_t " << c_name(head->child(i)->value());
+        os << (head->child_count() == 0 ? "void)" : ")");
+    }
+
+    /*
+    the division of programs that divide: values are `uint32_t`, so that arithmetic wraps around instead of
+    overflowing (which is undefined for signed integers in C), and division works on the signed values after checking
+    for the cases where x86's `idiv` traps
+    */
+    const char* divideFunction =
+        "static uint32_t tuc_divide(uint32_t dividend, uint32_t divisor) {\n"
+        "    if (divisor == 0 || (dividend == UINT32_C(0x80000000) && divisor == UINT32_C(0xffffffff)))\n"
+        "        raise(SIGFPE);\n"
+        "    return (uint32_t)((int32_t)dividend / (int32_t)divisor);\n"
+        "}\n"
+        "\n";
+
+    /*
+    puts the C expression computing the value of an expression tree in an output stream, setting `divides` if it has a
+    division; identifiers are the `parameters` of the function the expression is in or calls
+
+    Operands are converted to `uint32_t` explicitly at each operation: a product goes through `unsigned long long` so
+    that it is computed unsigned even where `int` is wider than 32 bits (where `uint32_t` operands would be promoted
+    to `int` and could overflow).
+    */
+    void put_expression(std::ostream& os, const tuc::SyntaxNode* node, const std::unordered_set<std::string>& parameters,
+                        bool& divides) {
+        if (is_literal(node)) {
+            os << "UINT32_C(" << std::stoi(node->value()) << ")";
+            return;
+        }
+        else if (node->type() == NodeType::IDENTIFIER && parameters.count(node->value()) > 0) {
+            os << c_name(node->value());
+            return;
+        }
+        else if (node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL) {
+            os << c_name(node->value()) << "(";
+            for (int i = 0, count = node->child_count(); i < count; i++) {
+                os << (i > 0 ? ", " : "");
+                put_expression(os, node->child(i), parameters, divides);
+            }
+            os << ")";
+            return;
+        }
+
+        switch (node->type()) {
+        case NodeType::ADD:
+        case NodeType::SUBTRACT:
+            os << "(uint32_t)(";
+            put_expression(os, node->child(0), parameters, divides);
+            os << (node->type() == NodeType::ADD ? " + " : " - ");
+            put_expression(os, node->child(1), parameters, divides);
+            os << ")";
+            break;
+        case NodeType::MULTIPLY:
+            os << "(uint32_t)((unsigned long long)";
+            put_expression(os, node->child(0), parameters, divides);
+            os << " * ";
+            put_expression(os, node->child(1), parameters, divides);
+            os << ")";
+            break;
+        default:
+            divides = true;
+            os << "tuc_divide(";
+            put_expression(os, node->child(0), parameters, divides);
+            os << ", ";
+            put_expression(os, node->child(1), parameters, divides);
+            os << ")";
+            break;
+        }
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+lowers a program's syntax tree to portable C whose `main` computes every top-level expression and exits with the
+value of the last one; each function definition becomes a static C function
+
+The values of all but the last expression are unused, but they are still computed, since computing them may trap;
+the C compiler keeps the divisions that may (they call `raise`) and drops the rest. The exit status is the low 8 bits
+of the value, which is what the exit system call keeps of it.
+*/
+std::string tuc::gen_program_c(const SyntaxNode* root) {
+    auto prototypes = std::stringstream{};
+    auto c = std::stringstream{};
+    auto divides = false;
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (statement->type() != SyntaxNode::NodeType::ASSIGN)
+            continue;
+
+        auto parameters = std::unordered_set<std::string>{};
+        for (int p = 0, parameterCount = statement->child(0)->child_count(); p < parameterCount; p++)
+            parameters.insert(statement->child(0)->child(p)->value());
+        put_function_head(prototypes, statement);
+        prototypes << ";\n";
+        put_function_head(c, statement);
+        c << " {\n    return ";
+        put_expression(c, statement->child(1), parameters, divides);
+        c << ";\n}\n\n";
+    }
+    if (prototypes.tellp() > 0)
+        prototypes << "\n";
+
+    c << "int main(void) {\n";
+    c << "    uint32_t value = 0;\n";
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (!is_expression(statement))
+            continue;   // declarations and definitions are not evaluated
+
+        c << "    value = ";
+        put_expression(c, statement, std::unordered_set<std::string>{}, divides);
+        c << ";\n";
+    }
+    c << "    return (int)(value & 0xff);\n";
+    c << "}\n";
+
+    auto headers = std::string{divides ? "#include <signal.h>\n" : ""} + "#include <stdint.h>\n\n";
+    return headers + (divides ? divideFunction : "") + prototypes.str() + c.str();
+}
@@ -0,0 +1,429 @@
+/*
+Project: TUC
+File: column_kernel.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+// project headers
+#include "column_kernel.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <algorithm>
+
+// the vector code is only built for x86, where the functions using each instruction set are compiled for it
+// separately (with the `target` attribute) and picked when the program runs
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TUC_X86_SIMD 1
+#include <immintrin.h>
+#else
+#define TUC_X86_SIMD 0
+#endif
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+
+    /*################################################################################################################
+    ### The operations on blocks of rows for each instruction set.  Each computes `d[i] = a[i] op b[i]` for `n`    ##
+    ### rows (`d` may be `a` or `b`); the divisions return false if some row traps.  The rows after the last full  ##
+    ### vector are done one at a time, the way the scalar functions do all of them.                               ##
+    ################################################################################################################*/
+
+    using Column = std::int32_t*;
+    using ConstColumn = const std::int32_t*;
+
+    // values are added, subtracted, and multiplied as unsigned integers so that they wrap around
+    std::int32_t wrap(std::uint32_t value) {
+        return static_cast<std::int32_t>(value);
+    }
+
+    bool divide_traps(std::int32_t dividend, std::int32_t divisor) {
+        return divisor == 0 || (dividend == INT32_MIN && divisor == -1);
+    }
+
+    void add_scalar(Column d, ConstColumn a, ConstColumn b, std::size_t n, std::size_t i = 0) {
+        for (; i < n; i++)
+            d[i] = wrap(static_cast<std::uint32_t>(a[i]) + static_cast<std::uint32_t>(b[i]));
+    }
+
+    void subtract_scalar(Column d, ConstColumn a, ConstColumn b, std::size_t n, std::size_t i = 0) {
+        for (; i < n; i++)
+            d[i] = wrap(static_cast<std::uint32_t>(a[i]) - static_cast<std::uint32_t>(b[i]));
+    }
+
+    void multiply_scalar(Column d, ConstColumn a, ConstColumn b, std::size_t n, std::size_t i = 0) {
+        for (; i < n; i++)
+            d[i] = wrap(static_cast<std::uint32_t>(a[i]) * static_cast<std::uint32_t>(b[i]));
+    }
+
+    bool divide_scalar(Column d, ConstColumn a, ConstColumn b, std::size_t n, std::size_t i = 0) {
+        for (; i < n; i++) {
+            if (divide_traps(a[i], b[i]))
+                return false;
+            d[i] = a[i] / b[i];
+        }
+        return true;
+    }
+
+#if TUC_X86_SIMD
+    /*
+    SSE2 has no 32-bit multiplication keeping the low halves of the products (it came with SSE4.1), so the even and
+    the odd lanes are multiplied into 64-bit products separately and their low halves interleaved again
+    */
+    __attribute__((target("sse2")))
+    __m128i multiply_sse2_lanes(__m128i a, __m128i b) {
+        auto even = _mm_mul_epu32(a, b);
+        auto odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    /*
+    returns the lanes where a division traps: the divisor is 0, or the dividend is the smallest integer and the
+    divisor is -1
+    */
+    __attribute__((target("sse2")))
+    __m128i trapping_lanes_sse2(__m128i a, __m128i b) {
+        auto zero = _mm_cmpeq_epi32(b, _mm_setzero_si128());
+        auto overflow = _mm_and_si128(_mm_cmpeq_epi32(a, _mm_set1_epi32(INT32_MIN)), _mm_cmpeq_epi32(b, _mm_set1_epi32(-1)));
+        return _mm_or_si128(zero, overflow);
+    }
+
+    /*
+    there is no vector integer division either: the lanes are divided as doubles and the quotients truncated, which
+    is exact for 32-bit integers (the rounding error of the quotient is smaller than its distance to the next integer)
+    */
+    __attribute__((target("sse2")))
+    __m128i divide_sse2_lanes(__m128i a, __m128i b) {
+        auto low = _mm_div_pd(_mm_cvtepi32_pd(a), _mm_cvtepi32_pd(b));
+        auto high = _mm_div_pd(_mm_cvtepi32_pd(_mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2))),
+                               _mm_cvtepi32_pd(_mm_shuffle_epi32(b, _MM_SHUFFLE(1, 0, 3, 2))));
+        return _mm_unpacklo_epi64(_mm_cvttpd_epi32(low), _mm_cvttpd_epi32(high));
+    }
+
+    __attribute__((target("sse2")))
+    void add_sse2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 4 <= n; i += 4) {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_add_epi32(x, y));
+        }
+        add_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("sse2")))
+    void subtract_sse2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 4 <= n; i += 4) {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), _mm_sub_epi32(x, y));
+        }
+        subtract_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("sse2")))
+    void multiply_sse2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 4 <= n; i += 4) {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), multiply_sse2_lanes(x, y));
+        }
+        multiply_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("sse2")))
+    bool divide_sse2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        auto traps = _mm_setzero_si128();
+        for (; i + 4 <= n; i += 4) {
+            auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            traps = _mm_or_si128(traps, trapping_lanes_sse2(x, y));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), divide_sse2_lanes(x, y));
+        }
+        return _mm_movemask_epi8(traps) == 0 && divide_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("avx2")))
+    void add_avx2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 8 <= n; i += 8) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_add_epi32(x, y));
+        }
+        add_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("avx2")))
+    void subtract_avx2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 8 <= n; i += 8) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_sub_epi32(x, y));
+        }
+        subtract_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("avx2")))
+    void multiply_avx2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        for (; i + 8 <= n; i += 8) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), _mm256_mullo_epi32(x, y));
+        }
+        multiply_scalar(d, a, b, n, i);
+    }
+
+    __attribute__((target("avx2")))
+    bool divide_avx2(Column d, ConstColumn a, ConstColumn b, std::size_t n) {
+        auto i = std::size_t{0};
+        auto traps = _mm256_setzero_si256();
+        for (; i + 8 <= n; i += 8) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            auto y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            auto zero = _mm256_cmpeq_epi32(y, _mm256_setzero_si256());
+            auto overflow = _mm256_and_si256(_mm256_cmpeq_epi32(x, _mm256_set1_epi32(INT32_MIN)),
+                                             _mm256_cmpeq_epi32(y, _mm256_set1_epi32(-1)));
+            traps = _mm256_or_si256(traps, _mm256_or_si256(zero, overflow));
+
+            // as with SSE2, the lanes are divided as doubles, four at a time
+            auto low = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_castsi256_si128(x)),
+                                     _mm256_cvtepi32_pd(_mm256_castsi256_si128(y)));
+            auto high = _mm256_div_pd(_mm256_cvtepi32_pd(_mm256_extracti128_si256(x, 1)),
+                                      _mm256_cvtepi32_pd(_mm256_extracti128_si256(y, 1)));
+            auto quotient = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(low)), _mm256_cvttpd_epi32(high), 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), quotient);
+        }
+        return _mm256_testz_si256(traps, traps) && divide_scalar(d, a, b, n, i);
+    }
+#endif
+
+    /*
+    returns the number of temporary columns needed to compute an expression tree (its Sethi-Ullman number, columns and
+    constants needing none)
+    */
+    int temporaries_needed(const tuc::SyntaxNode* node) {
+        if (!node->is_operator())
+            return 0;
+        auto left = temporaries_needed(node->child(0));
+        auto right = temporaries_needed(node->child(1));
+        return left == right ? left + 1 : std::max(left, right);
+    }
+
+    /*
+    the operations of one instruction set
+    */
+    struct Operations {
+        void (*add)(Column, ConstColumn, ConstColumn, std::size_t);
+        void (*subtract)(Column, ConstColumn, ConstColumn, std::size_t);
+        void (*multiply)(Column, ConstColumn, ConstColumn, std::size_t);
+        bool (*divide)(Column, ConstColumn, ConstColumn, std::size_t);
+    };
+
+    Operations operations_of(tuc::SimdLevel level) {
+        switch (level) {
+#if TUC_X86_SIMD
+        case tuc::SimdLevel::AVX2:
+            return {add_avx2, subtract_avx2, multiply_avx2, divide_avx2};
+        case tuc::SimdLevel::SSE2:
+            return {add_sse2, subtract_sse2, multiply_sse2, divide_sse2};
+#endif
+        default:
+            return {[](Column d, ConstColumn a, ConstColumn b, std::size_t n) { add_scalar(d, a, b, n); },
+                    [](Column d, ConstColumn a, ConstColumn b, std::size_t n) { subtract_scalar(d, a, b, n); },
+                    [](Column d, ConstColumn a, ConstColumn b, std::size_t n) { multiply_scalar(d, a, b, n); },
+                    [](Column d, ConstColumn a, ConstColumn b, std::size_t n) { return divide_scalar(d, a, b, n); }};
+        }
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+const std::size_t tuc::ColumnKernel::block_size;
+
+/*
+compiles an expression whose identifiers are among the names of the input columns
+
+The last operation writes its values straight into the output column; an expression that is only a column or a
+constant is copied there.
+*/
+tuc::ColumnKernel::ColumnKernel(const SyntaxNode* expression, const std::vector<std::string>& columns, SimdLevel level)
+    : kernelLevel{std::min(level, best_simd_level())} {
+    auto freeTemporaries = std::vector<int>{};
+    auto result = compile(expression, columns, freeTemporaries);
+    if (steps.empty() || result.type != SlotType::TEMPORARY)
+        steps.push_back(Step{Operation::COPY, Slot{SlotType::OUTPUT, 0}, result, result});
+    else
+        steps.back().destination = Slot{SlotType::OUTPUT, 0};
+}
+
+/*
+computes the expression for `rows` rows of the input columns into the output column; returns false if the expression
+traps on some row
+*/
+bool tuc::ColumnKernel::evaluate(const std::vector<const std::int32_t*>& inputs, std::int32_t* output, std::size_t rows) const {
+    auto operations = operations_of(kernelLevel);
+    auto temporaries = std::vector<std::int32_t>(temporaryCount * block_size);
+    for (std::size_t start = 0; start < rows; start += block_size) {
+        auto n = std::min(block_size, rows - start);
+        auto column = [&](const Slot& slot) -> std::int32_t* {
+            switch (slot.type) {
+            case SlotType::INPUT:       return const_cast<std::int32_t*>(inputs[slot.index]) + start;
+            case SlotType::CONSTANT:    return const_cast<std::int32_t*>(constants[slot.index].data());
+            case SlotType::TEMPORARY:   return temporaries.data() + slot.index * block_size;
+            default:                    return output + start;
+            }
+        };
+
+        for (const auto& step : steps) {
+            auto d = column(step.destination);
+            auto a = column(step.left);
+            auto b = column(step.right);
+            switch (step.operation) {
+            case Operation::ADD:        operations.add(d, a, b, n); break;
+            case Operation::SUBTRACT:   operations.subtract(d, a, b, n); break;
+            case Operation::MULTIPLY:   operations.multiply(d, a, b, n); break;
+            case Operation::DIVIDE:
+                if (!operations.divide(d, a, b, n))
+                    return false;
+                break;
+            case Operation::COPY:       std::copy(a, a + n, d); break;
+            }
+        }
+    }
+    return true;
+}
+
+tuc::SimdLevel tuc::ColumnKernel::simd_level() const noexcept {
+    return kernelLevel;
+}
+
+int tuc::ColumnKernel::operation_count() const noexcept {
+    return steps.size();
+}
+
+/*
+appends the operations computing an expression tree to the kernel and returns where its values are
+
+Intermediate values go in temporary columns, which are reused as soon as the operation using them is done; the
+operand needing more temporaries is computed first, so that the kernel needs as few as the tree's Sethi-Ullman number.
+*/
+tuc::ColumnKernel::Slot tuc::ColumnKernel::compile(const SyntaxNode* node, const std::vector<std::string>& columns,
+                                                   std::vector<int>& freeTemporaries) {
+    if (node->type() == NodeType::INTEGER) {
+        constants.emplace_back(block_size, std::stoi(node->value()));
+        return Slot{SlotType::CONSTANT, static_cast<int>(constants.size()) - 1};
+    }
+    else if (node->type() == NodeType::IDENTIFIER) {
+        auto column = std::find(columns.cbegin(), columns.cend(), node->value());
+        if (column == columns.cend())
+            throw CompilerException::UnknownSymbol{node->text()};
+        return Slot{SlotType::INPUT, static_cast<int>(column - columns.cbegin())};
+    }
+    else if (!node->is_operator()) {
+        throw CompilerException::UnimplementedFeature{node->position(), "column expressions",
+            "only arithmetic on integers and identifiers of columns can be computed over columns"};
+    }
+
+    auto left = Slot{};
+    auto right = Slot{};
+    if (temporaries_needed(node->child(0)) >= temporaries_needed(node->child(1))) {
+        left = compile(node->child(0), columns, freeTemporaries);
+        right = compile(node->child(1), columns, freeTemporaries);
+    }
+    else {
+        right = compile(node->child(1), columns, freeTemporaries);
+        left = compile(node->child(0), columns, freeTemporaries);
+    }
+
+    for (const auto& operand : {left, right}) {
+        if (operand.type == SlotType::TEMPORARY)
+            freeTemporaries.push_back(operand.index);
+    }
+    auto destination = Slot{SlotType::TEMPORARY, temporaryCount};
+    if (freeTemporaries.empty()) {
+        temporaryCount++;
+    }
+    else {
+        destination.index = freeTemporaries.back();
+        freeTemporaries.pop_back();
+    }
+
+    auto operation = Operation::DIVIDE;
+    switch (node->type()) {
+    case NodeType::ADD:         operation = Operation::ADD; break;
+    case NodeType::SUBTRACT:    operation = Operation::SUBTRACT; break;
+    case NodeType::MULTIPLY:    operation = Operation::MULTIPLY; break;
+    default:                    break;
+    }
+    steps.push_back(Step{operation, destination, left, right});
+    return destination;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the most capable instruction set the machine running tuc supports
+*/
+tuc::SimdLevel tuc::best_simd_level() noexcept {
+#if TUC_X86_SIMD
+    if (__builtin_cpu_supports("avx2"))
+        return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return SimdLevel::SSE2;
+#endif
+    return SimdLevel::SCALAR;
+}
+
+std::string tuc::simd_level_name(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::AVX2:   return "avx2";
+    case SimdLevel::SSE2:   return "sse2";
+    default:                return "scalar";
+    }
+}
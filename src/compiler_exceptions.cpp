@@ -3,7 +3,7 @@ Project: TUC
 File: compiler_exceptions.cpp
 Author: Leonardo Banderali
 Created: October 9, 2015
-Last Modified: January 5, 2016
+Last Modified: October 18, 2026
 
 Description:
     TUC is a simple, experimental compiler designed for learning and experimenting.
@@ -113,6 +113,32 @@ std::string tuc::CompilerException::MismatchedParenthesis::error() const noexcep
 
 
 
+tuc::CompilerException::ArgumentCountMismatch::ArgumentCountMismatch(const TextEntity& _symbol, int _expected, int _given)
+    : CompilationError{_symbol.position()} {
+    std::stringstream text;
+    text << "`" << _symbol.text() << "` takes " << _expected << (_expected == 1 ? " argument" : " arguments") << " but is given "
+         << _given;
+    errorMsg = text.str();
+}
+
+std::string tuc::CompilerException::ArgumentCountMismatch::error() const noexcept {
+    return errorMsg;
+}
+
+
+
+tuc::CompilerException::Redefinition::Redefinition(const TextEntity& _symbol) : CompilationError{_symbol.position()} {
+    std::stringstream text;
+    text << "Redefinition of symbol `" << _symbol.text() << "`";
+    errorMsg = text.str();
+}
+
+std::string tuc::CompilerException::Redefinition::error() const noexcept {
+    return errorMsg;
+}
+
+
+
 tuc::CompilerException::UnimplementedFeature::UnimplementedFeature(FilePosition _position, std::string _feature, std::string _cause)
     : position{_position}, featureName{_feature}, faultCause{_cause} {}
 
@@ -150,3 +176,83 @@ returns the column number where the error was found
 unsigned int tuc::CompilerException::UnimplementedFeature::column() const noexcept {
     return position.column();
 }
+
+
+
+tuc::CompilerException::InvalidOption::InvalidOption(std::string _option, std::string _cause)
+    : optionText{_option}, faultCause{_cause} {}
+
+std::string tuc::CompilerException::InvalidOption::title() const noexcept {
+    std::stringstream text;
+    text << "Invalid option -- " << option();
+    return text.str();
+}
+
+std::string tuc::CompilerException::InvalidOption::cause() const noexcept {
+    return faultCause;
+}
+
+std::string tuc::CompilerException::InvalidOption::option() const noexcept {
+    return optionText;
+}
+
+
+
+tuc::CompilerException::InvalidTable::InvalidTable(std::string _file, unsigned int _line, std::string _cause)
+    : filePath{_file}, lineNumber{_line}, faultCause{_cause} {}
+
+std::string tuc::CompilerException::InvalidTable::title() const noexcept {
+    std::stringstream text;
+    text << "Invalid table -- " << file() << ":" << line();
+    return text.str();
+}
+
+std::string tuc::CompilerException::InvalidTable::cause() const noexcept {
+    return faultCause;
+}
+
+std::string tuc::CompilerException::InvalidTable::file() const noexcept {
+    return filePath;
+}
+
+unsigned int tuc::CompilerException::InvalidTable::line() const noexcept {
+    return lineNumber;
+}
+
+
+
+tuc::CompilerException::InvalidInstruction::InvalidInstruction(std::string _instruction, std::string _cause)
+    : instructionText{_instruction}, faultCause{_cause} {}
+
+std::string tuc::CompilerException::InvalidInstruction::title() const noexcept {
+    std::stringstream text;
+    text << "Invalid instruction -- " << instruction();
+    return text.str();
+}
+
+std::string tuc::CompilerException::InvalidInstruction::cause() const noexcept {
+    return faultCause;
+}
+
+std::string tuc::CompilerException::InvalidInstruction::instruction() const noexcept {
+    return instructionText;
+}
+
+
+
+tuc::CompilerException::JitFailure::JitFailure(std::string _operation, std::string _cause)
+    : operationName{_operation}, faultCause{_cause} {}
+
+std::string tuc::CompilerException::JitFailure::title() const noexcept {
+    std::stringstream text;
+    text << "JIT failure -- " << operation();
+    return text.str();
+}
+
+std::string tuc::CompilerException::JitFailure::cause() const noexcept {
+    return faultCause;
+}
+
+std::string tuc::CompilerException::JitFailure::operation() const noexcept {
+    return operationName;
+}
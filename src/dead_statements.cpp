@@ -0,0 +1,89 @@
+/*
+Project: TUC
+File: dead_statements.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "dead_statements.hpp"
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+removes the instructions whose values are never used and that have no side effects (e.g. every statement but the last
+of a program without procedures); returns the number of instructions removed
+
+Each block is scanned backward so that, when an instruction is removed, its operands (which come before it) lose a use
+before they are looked at. The whole subtree of a statement that is thrown away is removed this way. Values used in
+other blocks are only removed once they are dead everywhere, so the scan is repeated until nothing changes.
+
+A division is kept for its trap unless its divisor is a safe constant or the value ranges show that neither division
+by zero nor overflow can happen. Removing instructions does not change the values of the others, so the ranges stay
+valid throughout.
+*/
+int tuc::eliminate_dead_statements(IRProgram& program, const UseCountAnalysis::Result& uses,
+                                   const ValueRangeAnalysis::Result* ranges) {
+    auto removed = 0;
+    for (int f = 0, functionCount = program.size(); f < functionCount; f++) {
+        auto& function = program[f];
+        auto useCount = uses[f];
+        auto removable = [&](ValueId v) {
+            if (!has_side_effects(function, v))
+                return true;
+            return ranges != nullptr && function.instruction(v).opcode() == IROpcode::DIVIDE &&
+                   !division_may_trap((*ranges)[f][function.operand(v, 0)], (*ranges)[f][function.operand(v, 1)]);
+        };
+
+        auto changed = true;
+        while (changed) {
+            changed = false;
+            for (BlockId b = 0, blockCount = function.block_count(); b < blockCount; b++) {
+                auto& instructions = function.block(b).instructions();
+                for (int i = instructions.size() - 1; i >= 0; i--) {
+                    auto v = instructions[i];
+                    if (useCount[v] > 0 || !removable(v))
+                        continue;
+
+                    for (int o = 0, c = function.instruction(v).operand_count(); o < c; o++)
+                        useCount[function.operand(v, o)]--;
+                    instructions.erase(instructions.begin() + i);
+                    removed++;
+                    changed = true;
+                }
+            }
+        }
+    }
+    return removed;
+}
@@ -0,0 +1,407 @@
+/*
+Project: TUC
+File: elf_writer.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "elf_writer.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    // values of the ELF format (see the System V ABI and elf.h)
+    const int elfHeaderSize32 = 52;
+    const int elfHeaderSize64 = 64;
+    const int sectionHeaderSize32 = 40;
+    const int sectionHeaderSize64 = 64;
+    const int symbolSize32 = 16;
+    const int symbolSize64 = 24;
+    const int programHeaderSize32 = 32;
+    const int programHeaderSize64 = 56;
+
+    const std::uint16_t typeRelocatable = 1;
+    const std::uint16_t typeExecutable = 2;
+    const std::uint16_t machine386 = 3;
+    const std::uint16_t machineX86_64 = 62;
+
+    const std::uint32_t sectionProgramData = 1;
+    const std::uint32_t sectionSymbolTable = 2;
+    const std::uint32_t sectionStringTable = 3;
+    const std::uint32_t sectionRelocationsWithAddends = 4;
+    const std::uint32_t sectionNoBits = 8;
+    const std::uint32_t sectionRelocations = 9;
+    const std::uint64_t sectionWritable = 0x1;
+    const std::uint64_t sectionAllocated = 0x2;
+    const std::uint64_t sectionExecutable = 0x4;
+    const int relocationSize32 = 8;
+    const int relocationSize64 = 24;
+    const std::uint32_t relocation386_32 = 1;          // the absolute address of the symbol plus the field
+    const std::uint32_t relocationX86_64_PC32 = 2;     // the address of the symbol plus the addend, less the field's
+
+    const std::uint8_t symbolLocal = 0;
+    const std::uint8_t symbolGlobal = 1;
+    const std::uint8_t symbolNoType = 0;
+    const std::uint8_t symbolSection = 3;
+
+    const std::uint32_t segmentLoadable = 1;
+    const std::uint32_t segmentExecutable = 0x1;
+    const std::uint32_t segmentWritable = 0x2;
+    const std::uint32_t segmentReadable = 0x4;
+
+    const int textAlignment = 16;
+    const std::uint64_t pageSize = 0x1000;
+
+    // where executables are loaded, as `ld` does by default
+    const std::uint64_t baseAddress32 = 0x08048000;
+    const std::uint64_t baseAddress64 = 0x400000;
+
+    // the sections of the object, in order (the first one is the null section every ELF file starts with); the last
+    // two are only there when the code reserves data, and executables have no relocations
+    enum Section {NULL_SECTION, TEXT, SECTION_NAMES, SYMBOLS, SYMBOL_NAMES, BSS, RELOCATIONS, SECTION_COUNT};
+
+    /*
+    The bytes of an ELF file being written, with the fields whose size depends on the class of the file (addresses
+    and offsets, 4 bytes in 32-bit files and 8 in 64-bit ones).
+    */
+    class ElfBuffer {
+        public:
+            explicit ElfBuffer(bool _is64) : is64{_is64} {}
+
+            void put(std::uint64_t value, int size) {
+                for (int i = 0; i < size; i++)
+                    bytes.push_back(static_cast<char>(value >> (8 * i)));
+            }
+
+            void put_address(std::uint64_t value) {
+                put(value, is64 ? 8 : 4);
+            }
+
+            void align(std::size_t alignment) {
+                while (bytes.size() % alignment != 0)
+                    bytes.push_back('\0');
+            }
+
+            std::size_t size() const noexcept {
+                return bytes.size();
+            }
+
+            std::string bytes;
+            const bool is64;
+    };
+
+    /*
+    adds a name to a string table and returns its offset
+    */
+    std::uint32_t add_string(std::string& table, const std::string& name) {
+        auto offset = static_cast<std::uint32_t>(table.size());
+        table += name;
+        table += '\0';
+        return offset;
+    }
+
+    void put_symbol(ElfBuffer& buffer, std::uint32_t name, std::uint64_t value, std::uint8_t binding, std::uint8_t type,
+                    std::uint16_t section) {
+        auto info = static_cast<std::uint8_t>((binding << 4) | type);
+        buffer.put(name, 4);
+        if (buffer.is64) {
+            buffer.put(info, 1);
+            buffer.put(0, 1);           // visibility
+            buffer.put(section, 2);
+            buffer.put(value, 8);
+            buffer.put(0, 8);           // size
+        }
+        else {
+            buffer.put(value, 4);
+            buffer.put(0, 4);           // size
+            buffer.put(info, 1);
+            buffer.put(0, 1);           // visibility
+            buffer.put(section, 2);
+        }
+    }
+
+    /*
+    puts the program header of a loadable segment
+    */
+    void put_segment(ElfBuffer& buffer, std::uint64_t offset, std::uint64_t address, std::uint64_t fileSize,
+                     std::uint64_t memorySize, std::uint32_t flags) {
+        buffer.put(segmentLoadable, 4);
+        if (buffer.is64)
+            buffer.put(flags, 4);
+        buffer.put_address(offset);                     // offset in the file
+        buffer.put_address(address);                    // virtual address
+        buffer.put_address(address);                    // physical address
+        buffer.put_address(fileSize);
+        buffer.put_address(memorySize);
+        if (!buffer.is64)
+            buffer.put(flags, 4);
+        buffer.put_address(pageSize);
+    }
+
+    struct SectionHeader {
+        std::uint32_t name = 0;
+        std::uint32_t type = 0;
+        std::uint64_t flags = 0;
+        std::uint64_t address = 0;
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;
+        std::uint32_t link = 0;
+        std::uint32_t info = 0;
+        std::uint64_t alignment = 0;
+        std::uint64_t entrySize = 0;
+    };
+
+    void put_section_header(ElfBuffer& buffer, const SectionHeader& header) {
+        buffer.put(header.name, 4);
+        buffer.put(header.type, 4);
+        buffer.put_address(header.flags);
+        buffer.put_address(header.address);
+        buffer.put_address(header.offset);
+        buffer.put_address(header.size);
+        buffer.put(header.link, 4);
+        buffer.put(header.info, 4);
+        buffer.put_address(header.alignment);
+        buffer.put_address(header.entrySize);
+    }
+
+    /*
+    returns the contents of an ELF file (32-bit for x86, 64-bit for x86-64) with the machine code in its `.text`
+    section and the labels of the code as symbols, `_start` being the only global one; the file is either a
+    relocatable object or an executable starting at `_start`
+
+    The file is laid out as the ELF header, the program headers of executables, the sections (the code, the section
+    names, the symbol table, the symbol names, and the relocations of objects), then the section header table. Jumps
+    are all resolved by the encoder, so the only relocations are those of the instructions using the data reserved by
+    the code, which is in a `.bss` section (and refers to it through its section symbol, as nasm does). An executable
+    has a segment mapping the start of the file, up to the end of the code, at the base address, and one more for the
+    data, at the first page after the code, whose addresses are filled in.
+    */
+    std::string gen_elf_file(const tuc::MachineCode& code, tuc::Target target, bool executable) {
+        auto is64 = target == tuc::Target::X86_64;
+        auto buffer = ElfBuffer{is64};
+        auto hasData = code.data_size() > 0;
+        auto sectionCount = !hasData ? BSS : executable ? RELOCATIONS : SECTION_COUNT;
+        auto segmentCount = hasData ? 2 : 1;
+        auto headers = std::vector<SectionHeader>(sectionCount);
+
+        // the code follows the headers; its address (and that of the data) is only known in executables
+        auto elfHeaderSize = is64 ? elfHeaderSize64 : elfHeaderSize32;
+        auto programHeaderSize = executable ? (is64 ? programHeaderSize64 : programHeaderSize32) : 0;
+        auto textOffset = static_cast<std::uint64_t>((elfHeaderSize + programHeaderSize * segmentCount + textAlignment - 1) /
+                                                     textAlignment * textAlignment);
+        auto baseAddress = executable ? (is64 ? baseAddress64 : baseAddress32) : 0;
+        auto textAddress = executable ? baseAddress + textOffset : 0;
+        auto dataAddress = executable ? (textAddress + code.bytes().size() + pageSize - 1) / pageSize * pageSize : 0;
+        auto bytes = executable ? code.relocated_bytes(textAddress, dataAddress, target) : code.bytes();
+        auto entry = textAddress;
+        for (const auto& label : code.labels()) {
+            if (label.first == "_start")
+                entry = textAddress + label.second;
+        }
+
+        // the names of the sections
+        auto sectionNames = std::string(1, '\0');
+        headers[TEXT].name = add_string(sectionNames, ".text");
+        headers[SECTION_NAMES].name = add_string(sectionNames, ".shstrtab");
+        headers[SYMBOLS].name = add_string(sectionNames, ".symtab");
+        headers[SYMBOL_NAMES].name = add_string(sectionNames, ".strtab");
+        if (hasData)
+            headers[BSS].name = add_string(sectionNames, ".bss");
+        if (sectionCount > RELOCATIONS)
+            headers[RELOCATIONS].name = add_string(sectionNames, is64 ? ".rela.text" : ".rel.text");
+
+        // the symbols: the null symbol, the sections, the local labels (of the code, then of the data), then the
+        // global ones
+        auto symbolNames = std::string(1, '\0');
+        auto symbols = ElfBuffer{is64};
+        put_symbol(symbols, 0, 0, symbolLocal, symbolNoType, 0);
+        put_symbol(symbols, 0, textAddress, symbolLocal, symbolSection, TEXT);
+        auto symbolCount = 2u;
+        auto dataSymbol = symbolCount;
+        if (hasData) {
+            put_symbol(symbols, 0, dataAddress, symbolLocal, symbolSection, BSS);
+            symbolCount++;
+        }
+        for (auto global : {false, true}) {
+            if (global)
+                headers[SYMBOLS].info = symbolCount;    // the index of the first global symbol
+            for (const auto& label : code.labels()) {
+                if ((label.first == "_start") != global)
+                    continue;
+                put_symbol(symbols, add_string(symbolNames, label.first), textAddress + label.second,
+                           global ? symbolGlobal : symbolLocal, symbolNoType, TEXT);
+                symbolCount++;
+            }
+            for (const auto& label : code.data_labels()) {
+                if (global)
+                    break;
+                put_symbol(symbols, add_string(symbolNames, label.first), dataAddress + label.second, symbolLocal,
+                           symbolNoType, BSS);
+                symbolCount++;
+            }
+        }
+
+        // the ELF header, filled in once the offset of the section header table is known
+        buffer.bytes = std::string("\x7f" "ELF", 4);
+        buffer.put(is64 ? 2 : 1, 1);                    // class
+        buffer.put(1, 1);                               // little endian
+        buffer.put(1, 1);                               // version
+        buffer.align(16);
+        buffer.put(executable ? typeExecutable : typeRelocatable, 2);
+        buffer.put(is64 ? machineX86_64 : machine386, 2);
+        buffer.put(1, 4);                               // version
+        buffer.put_address(entry);
+        buffer.put_address(executable ? elfHeaderSize : 0);     // program header table
+        auto sectionHeadersField = buffer.size();
+        buffer.put_address(0);                          // section header table
+        buffer.put(0, 4);                               // flags
+        buffer.put(elfHeaderSize, 2);
+        buffer.put(programHeaderSize, 2);
+        buffer.put(executable ? segmentCount : 0, 2);   // program header count
+        buffer.put(is64 ? sectionHeaderSize64 : sectionHeaderSize32, 2);
+        buffer.put(sectionCount, 2);
+        buffer.put(SECTION_NAMES, 2);
+
+        if (executable) {
+            // the code, readable and executable, then the data, readable and writable and not in the file
+            auto segmentSize = textOffset + bytes.size();
+            put_segment(buffer, 0, baseAddress, segmentSize, segmentSize, segmentReadable | segmentExecutable);
+            if (hasData)
+                put_segment(buffer, 0, dataAddress, 0, code.data_size(), segmentReadable | segmentWritable);
+        }
+
+        buffer.align(textAlignment);
+        headers[TEXT].type = sectionProgramData;
+        headers[TEXT].flags = sectionAllocated | sectionExecutable;
+        headers[TEXT].address = textAddress;
+        headers[TEXT].offset = buffer.size();
+        headers[TEXT].size = bytes.size();
+        headers[TEXT].alignment = textAlignment;
+        buffer.bytes.append(bytes.cbegin(), bytes.cend());
+
+        buffer.align(textAlignment);
+        headers[SECTION_NAMES].type = sectionStringTable;
+        headers[SECTION_NAMES].offset = buffer.size();
+        headers[SECTION_NAMES].size = sectionNames.size();
+        headers[SECTION_NAMES].alignment = 1;
+        buffer.bytes += sectionNames;
+
+        buffer.align(textAlignment);
+        headers[SYMBOLS].type = sectionSymbolTable;
+        headers[SYMBOLS].offset = buffer.size();
+        headers[SYMBOLS].size = symbols.size();
+        headers[SYMBOLS].link = SYMBOL_NAMES;
+        headers[SYMBOLS].alignment = is64 ? 8 : 4;
+        headers[SYMBOLS].entrySize = is64 ? symbolSize64 : symbolSize32;
+        buffer.bytes += symbols.bytes;
+
+        buffer.align(textAlignment);
+        headers[SYMBOL_NAMES].type = sectionStringTable;
+        headers[SYMBOL_NAMES].offset = buffer.size();
+        headers[SYMBOL_NAMES].size = symbolNames.size();
+        headers[SYMBOL_NAMES].alignment = 1;
+        buffer.bytes += symbolNames;
+
+        if (hasData) {
+            buffer.align(textAlignment);
+            headers[BSS].type = sectionNoBits;
+            headers[BSS].flags = sectionAllocated | sectionWritable;
+            headers[BSS].address = dataAddress;
+            headers[BSS].offset = buffer.size();
+            headers[BSS].size = code.data_size();
+            headers[BSS].alignment = textAlignment;
+        }
+
+        if (sectionCount > RELOCATIONS) {
+            // x86 relocations add the field (which holds the offset in the data) to the address of the data; x86-64 ones
+            // have the offset in their addend, less the size of the field since the address is relative to its end
+            auto relocations = ElfBuffer{is64};
+            for (const auto& relocation : code.relocations()) {
+                relocations.put_address(relocation.first);
+                if (is64) {
+                    relocations.put((static_cast<std::uint64_t>(dataSymbol) << 32) | relocationX86_64_PC32, 8);
+                    relocations.put(static_cast<std::uint64_t>(static_cast<std::int64_t>(relocation.second) - 4), 8);
+                }
+                else {
+                    relocations.put((dataSymbol << 8) | relocation386_32, 4);
+                }
+            }
+            buffer.align(textAlignment);
+            headers[RELOCATIONS].type = is64 ? sectionRelocationsWithAddends : sectionRelocations;
+            headers[RELOCATIONS].offset = buffer.size();
+            headers[RELOCATIONS].size = relocations.size();
+            headers[RELOCATIONS].link = SYMBOLS;
+            headers[RELOCATIONS].info = TEXT;
+            headers[RELOCATIONS].alignment = is64 ? 8 : 4;
+            headers[RELOCATIONS].entrySize = is64 ? relocationSize64 : relocationSize32;
+            buffer.bytes += relocations.bytes;
+        }
+
+        buffer.align(textAlignment);
+        auto sectionHeaders = ElfBuffer{is64};
+        sectionHeaders.put_address(buffer.size());
+        buffer.bytes.replace(sectionHeadersField, sectionHeaders.size(), sectionHeaders.bytes);
+        for (const auto& header : headers)
+            put_section_header(buffer, header);
+
+        return buffer.bytes;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the contents of an ELF relocatable object file (32-bit for x86, 64-bit for x86-64) with the machine code in
+its `.text` section, the data it reserves in its `.bss` section, and the labels of the code as symbols, `_start` being
+the only global one
+*/
+std::string tuc::gen_elf_object(const MachineCode& code, Target target) {
+    return gen_elf_file(code, target, false);
+}
+
+/*
+returns the contents of a static ELF executable (32-bit for x86, 64-bit for x86-64) running the machine code from
+`_start`, the way `ld` would link the object of the code
+*/
+std::string tuc::gen_elf_executable(const MachineCode& code, Target target) {
+    return gen_elf_file(code, target, true);
+}
@@ -0,0 +1,286 @@
+/*
+Project: TUC
+File: inliner.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "inliner.hpp"
+
+// standard libraries
+#include <utility>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::IROpcode;
+    using CallGraph = std::vector<std::vector<int>>;    // the indices of the functions each function calls
+
+    /*
+    the instructions a call costs, not counting the moves of its arguments: the call, the return, and the move of the
+    result
+    */
+    const int call_cost = 3;
+
+    /*
+    returns the functions called by the instructions of each function of a program
+    */
+    CallGraph call_graph(const tuc::IRProgram& program) {
+        auto callees = CallGraph(program.size());
+        for (int f = 0, count = program.size(); f < count; f++) {
+            for (auto v : program[f].linear_order()) {
+                const auto& instruction = program[f].instruction(v);
+                if (instruction.opcode() == IROpcode::CALL)
+                    callees[f].push_back(instruction.immediate());
+            }
+        }
+        return callees;
+    }
+
+    /*
+    appends the functions reachable from `index` that were not visited yet to `order`, callees before their callers
+    */
+    void visit_callees(const CallGraph& callees, int index, std::vector<bool>& visited, std::vector<int>& order) {
+        visited[index] = true;
+        for (auto callee : callees[index]) {
+            if (!visited[callee])
+                visit_callees(callees, callee, visited, order);
+        }
+        order.push_back(index);
+    }
+
+    /*
+    returns true if function `index` can call itself, directly or through other functions
+    */
+    bool is_recursive(const CallGraph& callees, int index) {
+        auto visited = std::vector<bool>(callees.size(), false);
+        auto reachable = std::vector<int>{};
+        for (auto callee : callees[index]) {
+            if (!visited[callee])
+                visit_callees(callees, callee, visited, reachable);
+        }
+        return visited[index];
+    }
+
+    /*
+    returns true if the body of a function is a single block returning its result, which is what the code generated
+    for every function defined in the source looks like
+    */
+    bool is_inlinable(const tuc::IRFunction& function) {
+        if (function.block_count() != 1 || function.block(0).instructions().empty())
+            return false;
+        return function.instruction(function.block(0).instructions().back()).opcode() == IROpcode::RETURN;
+    }
+
+    /*
+    returns by how many instructions the program grows if `call` (in `caller`) is replaced by the body of `callee`
+
+    The operations of the body that only depend on constants (including constant arguments) are not counted since
+    they are folded once the body is inlined. Divisions are always counted because they may trap.
+    */
+    int inlining_cost(const tuc::IRFunction& caller, tuc::ValueId call, const tuc::IRFunction& callee) {
+        auto constant = std::vector<bool>(callee.instruction_count(), false);
+        auto cost = -call_cost - caller.instruction(call).operand_count();
+        for (auto v : callee.block(0).instructions()) {
+            const auto& instruction = callee.instruction(v);
+            switch (instruction.opcode()) {
+            case IROpcode::CONSTANT:
+                constant[v] = true;
+                break;
+            case IROpcode::PARAMETER: {
+                auto argument = caller.operand(call, instruction.immediate());
+                constant[v] = caller.instruction(argument).opcode() == IROpcode::CONSTANT;
+                break;
+            }
+            case IROpcode::ADD:
+            case IROpcode::SUBTRACT:
+            case IROpcode::MULTIPLY:
+                constant[v] = constant[callee.operand(v, 0)] && constant[callee.operand(v, 1)];
+                cost += constant[v] ? 0 : 1;
+                break;
+            case IROpcode::RETURN:
+                break;
+            default:
+                cost++;
+                break;
+            }
+        }
+        return cost;
+    }
+
+    /*
+    replaces the call at position `index` of `block` in `caller` by a copy of the body of `callee`, whose parameters
+    become the arguments of the call; returns the number of instructions inserted
+    */
+    int inline_call(tuc::IRFunction& caller, tuc::BlockId block, int index, const tuc::IRFunction& callee) {
+        auto call = caller.block(block).instructions()[index];
+        auto copies = std::vector<tuc::ValueId>(callee.instruction_count(), tuc::no_value);
+        auto result = tuc::no_value;
+        auto inserted = 0;
+        for (auto v : callee.block(0).instructions()) {
+            const auto& instruction = callee.instruction(v);
+            if (instruction.opcode() == IROpcode::PARAMETER) {
+                copies[v] = caller.operand(call, instruction.immediate());
+            }
+            else if (instruction.opcode() == IROpcode::RETURN) {
+                result = copies[callee.operand(v, 0)];
+            }
+            else {
+                auto operands = std::vector<tuc::ValueId>{};
+                for (int i = 0; i < instruction.operand_count(); i++)
+                    operands.push_back(copies[callee.operand(v, i)]);
+                copies[v] = caller.insert(block, index + inserted, instruction.opcode(), instruction.type(), operands,
+                                          instruction.immediate());
+                inserted++;
+            }
+        }
+        caller.replace_uses(call, result);
+        auto& instructions = caller.block(block).instructions();
+        instructions.erase(instructions.begin() + index + inserted);
+        return inserted;
+    }
+
+    /*
+    removes the functions that the entry point can no longer call (directly or through other functions) now that their
+    calls were inlined, and renumbers the calls of the others; memoized functions and the functions called by a SPAWN
+    are kept like those reached by a CALL
+
+    Every instruction is renumbered, including those that were removed from their block: the calls replaced by the
+    body of their callee still refer to it, and those whose callee is gone become constants, so that no instruction
+    of the program refers to a function that does not exist.
+    */
+    void remove_unreachable_functions(tuc::IRProgram& program) {
+        auto reachable = std::vector<bool>(program.size(), false);
+        auto pending = std::vector<int>{0};
+        for (int f = 1, count = program.size(); f < count; f++) {
+            if (program[f].memoized())
+                pending.push_back(f);
+        }
+        while (!pending.empty()) {
+            auto f = pending.back();
+            pending.pop_back();
+            if (reachable[f])
+                continue;
+            reachable[f] = true;
+            for (auto v : program[f].linear_order()) {
+                const auto& instruction = program[f].instruction(v);
+                if (instruction.opcode() == IROpcode::CALL || instruction.opcode() == IROpcode::SPAWN)
+                    pending.push_back(instruction.immediate());
+            }
+        }
+
+        auto indices = std::vector<int>(program.size(), -1);
+        auto kept = 0;
+        for (int f = 0, count = program.size(); f < count; f++) {
+            if (reachable[f])
+                indices[f] = kept++;
+        }
+        if (kept == static_cast<int>(program.size()))
+            return;
+
+        auto remaining = tuc::IRProgram{};
+        for (int f = 0, count = program.size(); f < count; f++) {
+            if (!reachable[f])
+                continue;
+            auto& function = program[f];
+            for (tuc::ValueId v = 0, count = function.instruction_count(); v < count; v++) {
+                const auto& instruction = function.instruction(v);
+                if (instruction.opcode() != IROpcode::CALL && instruction.opcode() != IROpcode::SPAWN)
+                    continue;
+                auto callee = indices[instruction.immediate()];
+                if (callee < 0) {
+                    function.redefine(v, IROpcode::CONSTANT, instruction.type(), {}, 0);
+                    continue;
+                }
+                auto arguments = std::vector<tuc::ValueId>{};
+                for (int i = 0; i < instruction.operand_count(); i++)
+                    arguments.push_back(function.operand(v, i));
+                function.redefine(v, instruction.opcode(), instruction.type(), arguments, callee);
+            }
+            remaining.push_back(std::move(function));
+        }
+        program = std::move(remaining);
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+replaces calls to small functions by a copy of the body of the function (the functions of the language are pure, so a
+call is just the computation of its result); returns the number of calls replaced
+
+The functions are visited callees first, so the body copied into a caller already has its own small calls inlined and
+its size is what the callee really costs. The cost model counts the instructions of the body that cannot be folded given
+the constant arguments of the call, less what the call itself costs (see `inlining_cost()`). Recursive functions are
+left alone since their bodies would be copied forever, and so are memoized ones since their results would no longer be
+cached. The folding is left to the simplification and partial evaluation passes, which run after this one. The functions
+that are no longer called once their calls are inlined are removed from the program.
+*/
+int tuc::inline_calls(IRProgram& program, int threshold) {
+    auto callees = call_graph(program);
+    auto visited = std::vector<bool>(program.size(), false);
+    auto order = std::vector<int>{};
+    for (int f = 0, count = program.size(); f < count; f++) {
+        if (!visited[f])
+            visit_callees(callees, f, visited, order);
+    }
+
+    auto recursive = std::vector<bool>(program.size(), false);
+    for (int f = 0, count = program.size(); f < count; f++)
+        recursive[f] = is_recursive(callees, f);
+
+    auto inlined = 0;
+    for (auto f : order) {
+        auto& caller = program[f];
+        for (BlockId b = 0; b < caller.block_count(); b++) {
+            for (int i = 0; i < static_cast<int>(caller.block(b).instructions().size()); i++) {
+                auto v = caller.block(b).instructions()[i];
+                if (caller.instruction(v).opcode() != IROpcode::CALL)
+                    continue;
+                auto callee = caller.instruction(v).immediate();
+                if (recursive[callee] || program[callee].memoized() || !is_inlinable(program[callee]) ||
+                    inlining_cost(caller, v, program[callee]) > threshold)
+                    continue;
+                i += inline_call(caller, b, i, program[callee]) - 1;  // continue after the copied body
+                inlined++;
+            }
+        }
+    }
+    remove_unreachable_functions(program);
+    return inlined;
+}
@@ -0,0 +1,414 @@
+/*
+Project: TUC
+File: instruction_selector.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "instruction_selector.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <limits>
+#include <utility>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::AsmOperand;
+
+    /*
+    The types of the tables generated from src/x86.burs. Patterns are stored as arrays of nodes in prefix order: an
+    operator node is followed by the nodes of its operands, a nonterminal node is a leaf.
+    */
+    enum class PatternKind {OPERATOR, NONTERMINAL};
+
+    struct PatternNode {
+        PatternKind kind;
+        int symbol;                 // the IR opcode or the nonterminal
+        int arity;
+        int leaf;                   // the number of a nonterminal leaf
+    };
+
+    enum class OperandKind {RESULT, LEAF, ADDRESS};
+
+    /*
+    an operand of the instructions of a rule; `leaf` is the base register of an address and its other parts are -1
+    when missing
+    */
+    struct TemplateOperand {
+        OperandKind kind;
+        int leaf;
+        int index;
+        int scale;
+        int displacement;
+    };
+
+    struct TemplateInstruction {
+        tuc::AsmOpcode opcode;
+        std::vector<TemplateOperand> operands;
+    };
+
+    enum class Predicate {NONE, SCALE};
+
+    struct SelectionRule {
+        int lhs;                    // the nonterminal computed
+        int cost;
+        int firstNode;              // of the pattern
+        int nodeCount;
+        int operatorCount;          // 0 for chain rules
+        int leafCount;
+        Predicate predicate;        // on the root of the pattern
+        tuc::TileAction action;
+        int firstInstruction;
+        int instructionCount;
+        bool commutes;
+        bool addresses;
+        const char* text;
+    };
+
+    #include "x86_burs.inc"
+
+    const int infiniteCost = std::numeric_limits<int>::max() / 2;
+
+    /*
+    returns true if an instruction satisfies the predicate of a rule
+    */
+    bool satisfies(Predicate predicate, const tuc::IRInstruction& instruction) {
+        switch (predicate) {
+        case Predicate::SCALE:
+            // the scales of x86 addresses
+            return instruction.opcode() == tuc::IROpcode::CONSTANT && (instruction.immediate() == 1 ||
+                   instruction.immediate() == 2 || instruction.immediate() == 4 || instruction.immediate() == 8);
+        default:
+            return true;
+        }
+    }
+
+    bool is_tree_operation(const tuc::IRFunction& function, tuc::ValueId value) {
+        auto opcode = function.instruction(value).opcode();
+        return opcode == tuc::IROpcode::ADD || opcode == tuc::IROpcode::SUBTRACT || opcode == tuc::IROpcode::MULTIPLY ||
+               opcode == tuc::IROpcode::DIVIDE;
+    }
+
+    /*
+    returns true if a value is put in a register by the code generator itself rather than by a tile (a parameter or
+    the result of a call or a join)
+    */
+    bool is_register_value(const tuc::IRFunction& function, tuc::ValueId value) {
+        auto opcode = function.instruction(value).opcode();
+        return opcode == tuc::IROpcode::PARAMETER || opcode == tuc::IROpcode::CALL || opcode == tuc::IROpcode::JOIN;
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::InstructionTile::InstructionTile(int _rule, ValueId _root, std::vector<ValueId> _leaves, std::vector<ValueId> _nodes)
+: ruleIndex{_rule}, rootValue{_root}, leafValues{std::move(_leaves)}, nodeValues{std::move(_nodes)} {}
+
+int tuc::InstructionTile::rule() const noexcept {
+    return ruleIndex;
+}
+
+/*
+returns the pattern of the rule, e.g. "reg: ADD(reg, MULTIPLY(reg, scale))"
+*/
+std::string tuc::InstructionTile::rule_text() const {
+    return selectionRules[ruleIndex].text;
+}
+
+tuc::ValueId tuc::InstructionTile::root() const noexcept {
+    return rootValue;
+}
+
+const std::vector<tuc::ValueId>& tuc::InstructionTile::leaves() const noexcept {
+    return leafValues;
+}
+
+/*
+returns the operations covered, operands first and the root last
+*/
+const std::vector<tuc::ValueId>& tuc::InstructionTile::nodes() const noexcept {
+    return nodeValues;
+}
+
+tuc::TileAction tuc::InstructionTile::action() const noexcept {
+    return selectionRules[ruleIndex].action;
+}
+
+/*
+returns true if the two leaves can be swapped (the root is commutative and both leaves are alike)
+*/
+bool tuc::InstructionTile::commutes() const noexcept {
+    return selectionRules[ruleIndex].commutes;
+}
+
+/*
+returns true if leaves which are not constants are used as the registers of an address
+*/
+bool tuc::InstructionTile::addresses_leaves() const noexcept {
+    return selectionRules[ruleIndex].addresses;
+}
+
+void tuc::InstructionTile::swap_leaves() {
+    std::swap(leafValues[0], leafValues[1]);
+}
+
+/*
+returns the instructions of the rule computing the tile into `result`, where `operandOf` gives the operand holding each
+leaf; moves of a register to itself are left out
+*/
+tuc::AsmList tuc::InstructionTile::expand(Register result, const std::function<AsmOperand(ValueId)>& operandOf) const {
+    const auto& rule = selectionRules[ruleIndex];
+    auto code = AsmList{};
+    for (auto i = rule.firstInstruction; i < rule.firstInstruction + rule.instructionCount; i++) {
+        auto operands = std::vector<AsmOperand>{};
+        for (const auto& o : templateInstructions[i].operands) {
+            if (o.kind == OperandKind::RESULT) {
+                operands.push_back(AsmOperand::reg(result));
+            }
+            else if (o.kind == OperandKind::LEAF) {
+                operands.push_back(operandOf(leafValues[o.leaf]));
+            }
+            else {
+                auto base = operandOf(leafValues[o.leaf]).base();
+                auto displacement = o.displacement >= 0 ? operandOf(leafValues[o.displacement]).value() : 0;
+                if (o.index < 0) {
+                    operands.push_back(AsmOperand::mem(base, displacement));
+                }
+                else {
+                    auto scale = o.scale >= 0 ? operandOf(leafValues[o.scale]).value() : 1;
+                    operands.push_back(AsmOperand::mem(base, operandOf(leafValues[o.index]).base(), scale, displacement));
+                }
+            }
+        }
+        auto opcode = templateInstructions[i].opcode;
+        if (opcode != AsmOpcode::MOV || !(operands[0] == operands[1]))
+            code.emplace_back(opcode, operands);
+    }
+    return code;
+}
+
+
+
+/*
+labels every value of a function, then reduces the trees from the last value to the first so that users pick the tiles
+of their operands
+*/
+tuc::InstructionSelector::InstructionSelector(const IRFunction& _function, std::vector<bool> _fixed)
+: function{_function}, fixed{std::move(_fixed)}, useCount(_function.instruction_count(), 0),
+  blockOf(_function.instruction_count(), -1), userBlock(_function.instruction_count(), -1),
+  labels(_function.instruction_count() * nonterminalCount, Label{infiniteCost, -1}),
+  operationLabels(_function.instruction_count(), Label{infiniteCost, -1}), tileOf(_function.instruction_count(), -1),
+  covered(_function.instruction_count(), false) {
+    fixed.resize(function.instruction_count(), false);
+    for (BlockId b = 0, count = function.block_count(); b < count; b++) {
+        for (auto v : function.block(b).instructions()) {
+            blockOf[v] = b;
+            for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++) {
+                useCount[function.operand(v, i)]++;
+                userBlock[function.operand(v, i)] = b;
+            }
+        }
+    }
+
+    auto order = function.linear_order();
+    for (auto v : order)
+        label(v);
+    for (auto v = order.rbegin(); v != order.rend(); v++) {
+        if (is_tree_operation(function, *v) && !covered[*v] && tileOf[*v] < 0)
+            reduce(*v, startNonterminal);
+    }
+}
+
+/*
+returns the tile computing `value`, or null if it is a constant or it is covered by another tile
+*/
+const tuc::InstructionTile* tuc::InstructionSelector::tile(ValueId value) const {
+    if (tileOf[value] < 0 || covered[value])
+        return nullptr;
+    return &tiles[tileOf[value]];
+}
+
+/*
+returns the cheapest tile covering only the operation defining `value`; its leaves are the operands
+*/
+tuc::InstructionTile tuc::InstructionSelector::operation_tile(ValueId value) const {
+    auto rule = operationLabels[value].rule;
+    auto cost = 0;
+    auto leaves = std::vector<ValueId>{};
+    auto nodes = std::vector<ValueId>{};
+    match(rule, value, cost, &leaves, &nodes);
+    return InstructionTile{rule, value, leaves, nodes};
+}
+
+/*
+returns the cost of computing `value` in a register
+*/
+int tuc::InstructionSelector::cost(ValueId value) const {
+    return state(value, startNonterminal).cost;
+}
+
+/*
+returns true if `value` can be covered by a pattern rooted at `root`
+*/
+bool tuc::InstructionSelector::is_inlinable(ValueId value, ValueId root) const {
+    if (function.instruction(value).opcode() == IROpcode::CONSTANT)
+        return true;    // constants generate no code
+    return is_tree_operation(function, value) && useCount[value] == 1 && userBlock[value] == blockOf[root] && !fixed[value];
+}
+
+/*
+returns true if the pattern of `rule` matches the tree of `root`, adding the cost of the nonterminals at its leaves to
+`cost` and collecting the leaves and covered operations (if not null)
+*/
+bool tuc::InstructionSelector::match(int rule, ValueId root, int& cost, std::vector<ValueId>* leaves,
+                                     std::vector<ValueId>* nodes) const {
+    const auto& r = selectionRules[rule];
+    if (!satisfies(r.predicate, function.instruction(root)))
+        return false;
+    if (leaves != nullptr)
+        leaves->assign(r.leafCount, no_value);
+
+    // the nodes of the pattern are in prefix order, so the tree is walked with a stack of the values left to match
+    auto pending = std::vector<ValueId>{root};
+    auto operations = std::vector<ValueId>{};
+    for (auto n = r.firstNode; n < r.firstNode + r.nodeCount; n++) {
+        const auto& node = patternNodes[n];
+        auto v = pending.back();
+        pending.pop_back();
+        if (node.kind == PatternKind::NONTERMINAL) {
+            auto leafCost = state(v, node.symbol).cost;
+            if (leafCost >= infiniteCost)
+                return false;
+            cost += leafCost;
+            if (leaves != nullptr)
+                (*leaves)[node.leaf] = v;
+            continue;
+        }
+
+        const auto& instruction = function.instruction(v);
+        if (static_cast<int>(instruction.opcode()) != node.symbol || instruction.operand_count() != node.arity ||
+            (v != root && !is_inlinable(v, root)))
+            return false;
+        for (auto i = node.arity - 1; i >= 0; i--)
+            pending.push_back(function.operand(v, i));
+        if (instruction.opcode() != IROpcode::CONSTANT)
+            operations.insert(operations.begin(), v);
+    }
+    if (nodes != nullptr)
+        *nodes = operations;
+    return true;
+}
+
+/*
+finds the cheapest rule deriving each nonterminal from `value`, once its operands are labeled
+*/
+void tuc::InstructionSelector::label(ValueId value) {
+    if (is_register_value(function, value))
+        state(value, startNonterminal) = Label{0, -1};
+    for (auto rule : rules_of(function.instruction(value).opcode())) {
+        const auto& r = selectionRules[rule];
+        auto cost = r.cost;
+        if (!match(rule, value, cost, nullptr, nullptr))
+            continue;
+        if (cost < state(value, r.lhs).cost)
+            state(value, r.lhs) = Label{cost, rule};
+        if (r.operatorCount == 1 && r.lhs == startNonterminal && cost < operationLabels[value].cost)
+            operationLabels[value] = Label{cost, rule};
+    }
+
+    // chain rules derive a nonterminal from another one, which may enable other chain rules
+    for (auto changed = true; changed;) {
+        changed = false;
+        for (auto rule : chainRules) {
+            const auto& r = selectionRules[rule];
+            auto cost = state(value, patternNodes[r.firstNode].symbol).cost + r.cost;
+            if (cost < state(value, r.lhs).cost) {
+                state(value, r.lhs) = Label{cost, rule};
+                changed = true;
+            }
+        }
+    }
+}
+
+/*
+makes the tile of the cheapest rule deriving `nonterminal` from `value` and reduces its leaves to the nonterminals of
+the pattern
+*/
+void tuc::InstructionSelector::reduce(ValueId value, int nonterminal) {
+    auto rule = state(value, nonterminal).rule;
+    while (rule >= 0 && selectionRules[rule].operatorCount == 0) {
+        nonterminal = patternNodes[selectionRules[rule].firstNode].symbol;
+        rule = state(value, nonterminal).rule;
+    }
+    if (rule < 0 && is_register_value(function, value))
+        return;     // already in a register
+    if (rule < 0) {
+        throw CompilerException::InvalidTable{"x86.burs", 0, std::string{"no rule derives `"} +
+                                              nonterminalNames[nonterminal] + "` from `" +
+                                              opcode_name(function.instruction(value).opcode()) + "`"};
+    }
+    if (selectionRules[rule].action == TileAction::NONE || tileOf[value] >= 0)
+        return;
+
+    auto cost = 0;
+    auto leaves = std::vector<ValueId>{};
+    auto nodes = std::vector<ValueId>{};
+    match(rule, value, cost, &leaves, &nodes);
+    tileOf[value] = tiles.size();
+    tiles.emplace_back(rule, value, leaves, nodes);
+    for (auto v : nodes) {
+        if (v != value)
+            covered[v] = true;
+    }
+
+    const auto& r = selectionRules[rule];
+    for (auto n = r.firstNode; n < r.firstNode + r.nodeCount; n++) {
+        if (patternNodes[n].kind == PatternKind::NONTERMINAL)
+            reduce(leaves[patternNodes[n].leaf], patternNodes[n].symbol);
+    }
+}
+
+tuc::InstructionSelector::Label& tuc::InstructionSelector::state(ValueId value, int nonterminal) {
+    return labels[value * nonterminalCount + nonterminal];
+}
+
+const tuc::InstructionSelector::Label& tuc::InstructionSelector::state(ValueId value, int nonterminal) const {
+    return labels[value * nonterminalCount + nonterminal];
+}
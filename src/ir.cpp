@@ -0,0 +1,319 @@
+/*
+Project: TUC
+File: ir.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "ir.hpp"
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::IRInstruction::IRInstruction(IROpcode _opcode, IRType _type, int _firstOperand, int _operandCount, std::int32_t _immediate)
+: instructionOpcode{_opcode}, valueType{_type}, firstOperand{_firstOperand}, operandCount{_operandCount},
+  immediateValue{_immediate} {}
+
+tuc::IROpcode tuc::IRInstruction::opcode() const noexcept {
+    return instructionOpcode;
+}
+
+/*
+returns the type of the value defined by the instruction (VOID if it does not define one)
+*/
+tuc::IRType tuc::IRInstruction::type() const noexcept {
+    return valueType;
+}
+
+/*
+returns the index of the first operand in the function's operand array
+*/
+int tuc::IRInstruction::first_operand() const noexcept {
+    return firstOperand;
+}
+
+int tuc::IRInstruction::operand_count() const noexcept {
+    return operandCount;
+}
+
+std::int32_t tuc::IRInstruction::immediate() const noexcept {
+    return immediateValue;
+}
+
+
+
+/*
+returns the instructions of the block in execution order
+*/
+const std::vector<tuc::ValueId>& tuc::IRBlock::instructions() const noexcept {
+    return blockInstructions;
+}
+
+std::vector<tuc::ValueId>& tuc::IRBlock::instructions() noexcept {
+    return blockInstructions;
+}
+
+
+
+tuc::IRFunction::IRFunction(const std::string& _name) : functionName{_name} {}
+
+std::string tuc::IRFunction::name() const noexcept {
+    return functionName;
+}
+
+bool tuc::IRFunction::memoized() const noexcept {
+    return isMemoized;
+}
+
+void tuc::IRFunction::set_memoized(bool memoized) noexcept {
+    isMemoized = memoized;
+}
+
+/*
+appends a new empty block to the function and returns its id
+*/
+tuc::BlockId tuc::IRFunction::add_block() {
+    blocks.push_back(IRBlock{});
+    return blocks.size() - 1;
+}
+
+/*
+creates an instruction, appends it to the end of `block`, and returns the id of the value it defines
+*/
+tuc::ValueId tuc::IRFunction::append(BlockId block, IROpcode opcode, IRType type, std::initializer_list<ValueId> _operands,
+                                     std::int32_t immediate) {
+    return append(block, opcode, type, std::vector<ValueId>(_operands), immediate);
+}
+
+tuc::ValueId tuc::IRFunction::append(BlockId block, IROpcode opcode, IRType type, const std::vector<ValueId>& _operands,
+                                     std::int32_t immediate) {
+    auto value = static_cast<ValueId>(instructions.size());
+    instructions.emplace_back(opcode, type, operands.size(), _operands.size(), immediate);
+    operands.insert(operands.end(), _operands.cbegin(), _operands.cend());
+    blocks[block].instructions().push_back(value);
+    return value;
+}
+
+/*
+creates an instruction, inserts it in `block` before the instruction at `index`, and returns the id of the value it
+defines
+*/
+tuc::ValueId tuc::IRFunction::insert(BlockId block, int index, IROpcode opcode, IRType type,
+                                     std::initializer_list<ValueId> _operands, std::int32_t immediate) {
+    return insert(block, index, opcode, type, std::vector<ValueId>(_operands), immediate);
+}
+
+tuc::ValueId tuc::IRFunction::insert(BlockId block, int index, IROpcode opcode, IRType type,
+                                     const std::vector<ValueId>& _operands, std::int32_t immediate) {
+    auto value = static_cast<ValueId>(instructions.size());
+    instructions.emplace_back(opcode, type, operands.size(), _operands.size(), immediate);
+    operands.insert(operands.end(), _operands.cbegin(), _operands.cend());
+    auto& blockInstructions = blocks[block].instructions();
+    blockInstructions.insert(blockInstructions.begin() + index, value);
+    return value;
+}
+
+/*
+replaces the instruction defining `value` (keeping its place in its block) so that every use of `value` now uses the
+result of the new instruction
+*/
+void tuc::IRFunction::redefine(ValueId value, IROpcode opcode, IRType type, std::initializer_list<ValueId> _operands,
+                               std::int32_t immediate) {
+    redefine(value, opcode, type, std::vector<ValueId>(_operands), immediate);
+}
+
+void tuc::IRFunction::redefine(ValueId value, IROpcode opcode, IRType type, const std::vector<ValueId>& _operands,
+                               std::int32_t immediate) {
+    instructions[value] = IRInstruction{opcode, type, static_cast<int>(operands.size()), static_cast<int>(_operands.size()),
+                                        immediate};
+    operands.insert(operands.end(), _operands.cbegin(), _operands.cend());
+}
+
+/*
+returns the number of instructions ever created in the function (including any that were removed from their block)
+*/
+int tuc::IRFunction::instruction_count() const noexcept {
+    return instructions.size();
+}
+
+/*
+returns the instruction defining `value`
+*/
+const tuc::IRInstruction& tuc::IRFunction::instruction(ValueId value) const noexcept {
+    return instructions[value];
+}
+
+/*
+returns operand `i` of the instruction defining `value`
+*/
+tuc::ValueId tuc::IRFunction::operand(ValueId value, int i) const noexcept {
+    return operands[instructions[value].first_operand() + i];
+}
+
+void tuc::IRFunction::set_operand(ValueId value, int i, ValueId operandValue) noexcept {
+    operands[instructions[value].first_operand() + i] = operandValue;
+}
+
+/*
+makes every instruction using `value` use `replacement` instead
+*/
+void tuc::IRFunction::replace_uses(ValueId value, ValueId replacement) noexcept {
+    for (auto& operand : operands) {
+        if (operand == value)
+            operand = replacement;
+    }
+}
+
+int tuc::IRFunction::block_count() const noexcept {
+    return blocks.size();
+}
+
+const tuc::IRBlock& tuc::IRFunction::block(BlockId id) const noexcept {
+    return blocks[id];
+}
+
+tuc::IRBlock& tuc::IRFunction::block(BlockId id) noexcept {
+    return blocks[id];
+}
+
+/*
+returns all the instructions of the function, block by block, in execution order
+*/
+std::vector<tuc::ValueId> tuc::IRFunction::linear_order() const {
+    auto order = std::vector<ValueId>{};
+    for (const auto& b : blocks)
+        order.insert(order.end(), b.instructions().cbegin(), b.instructions().cend());
+    return order;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the textual name of an IR opcode
+*/
+std::string tuc::opcode_name(IROpcode opcode) {
+    switch (opcode) {
+    case IROpcode::CONSTANT:    return "constant";
+    case IROpcode::ADD:         return "add";
+    case IROpcode::SUBTRACT:    return "sub";
+    case IROpcode::MULTIPLY:    return "mul";
+    case IROpcode::DIVIDE:      return "div";
+    case IROpcode::PARAMETER:   return "param";
+    case IROpcode::CALL:        return "call";
+    case IROpcode::SPAWN:       return "spawn";
+    case IROpcode::JOIN:        return "join";
+    case IROpcode::JUMP:        return "jump";
+    case IROpcode::RETURN:      return "ret";
+    case IROpcode::EXIT:        return "exit";
+    default:                    return "unknown";
+    }
+}
+
+/*
+returns true if instructions with the opcode can only be at the end of a basic block
+*/
+bool tuc::is_terminator(IROpcode opcode) noexcept {
+    return opcode == IROpcode::JUMP || opcode == IROpcode::RETURN || opcode == IROpcode::EXIT;
+}
+
+/*
+returns true if the instruction defining `value` does anything other than compute its value (e.g. it may trap or
+transfer control); unknown opcodes are assumed to have side effects
+
+A division only has no side effects if its divisor is a constant other than 0 and -1, since it traps on division by 0
+and on the overflow of INT32_MIN / -1. A call has side effects since the function may trap (or never return), and so
+do a spawned call and its join.
+*/
+bool tuc::has_side_effects(const IRFunction& function, ValueId value) {
+    const auto& instruction = function.instruction(value);
+    switch (instruction.opcode()) {
+    case IROpcode::CONSTANT:
+    case IROpcode::PARAMETER:
+    case IROpcode::ADD:
+    case IROpcode::SUBTRACT:
+    case IROpcode::MULTIPLY:
+        return false;
+    case IROpcode::DIVIDE: {
+        const auto& divisor = function.instruction(function.operand(value, 1));
+        return divisor.opcode() != IROpcode::CONSTANT || divisor.immediate() == 0 || divisor.immediate() == -1;
+    }
+    default:
+        return true;
+    }
+}
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+puts a textual representation of a function in an output stream
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::IRFunction& function) {
+    os << "function " << function.name() << (function.memoized() ? " (memoized)" : "") << ":\n";
+    for (tuc::BlockId b = 0, count = function.block_count(); b < count; b++) {
+        os << "block " << b << ":\n";
+        for (auto v : function.block(b).instructions()) {
+            const auto& instruction = function.instruction(v);
+            os << "    ";
+            if (instruction.type() == tuc::IRType::INT32)
+                os << "%" << v << " = i32 ";
+            else if (instruction.opcode() == tuc::IROpcode::SPAWN)
+                os << "%" << v << " = ";      // the handle its join uses
+            os << tuc::opcode_name(instruction.opcode());
+            if (instruction.opcode() == tuc::IROpcode::CONSTANT || instruction.opcode() == tuc::IROpcode::PARAMETER)
+                os << " " << instruction.immediate();
+            else if (instruction.opcode() == tuc::IROpcode::CALL || instruction.opcode() == tuc::IROpcode::SPAWN)
+                os << " function " << instruction.immediate();
+            else if (instruction.opcode() == tuc::IROpcode::JUMP)
+                os << " block " << instruction.immediate();
+            for (int i = 0, c = instruction.operand_count(); i < c; i++)
+                os << (i == 0 ? " %" : ", %") << function.operand(v, i);
+            os << "\n";
+        }
+    }
+    return os;
+}
+
+/*
+puts a textual representation of all the functions of a program in an output stream
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::IRProgram& program) {
+    for (const auto& function : program)
+        os << function << "\n";
+    return os;
+}
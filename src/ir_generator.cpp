@@ -0,0 +1,261 @@
+/*
+Project: TUC
+File: ir_generator.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "ir_generator.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <utility>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+    using LabelMap = std::unordered_map<const tuc::SyntaxNode*, int>;
+    using FunctionMap = std::unordered_map<std::string, int>;             // the index of each function in the program
+    using ParameterMap = std::unordered_map<std::string, tuc::ValueId>;   // the value of each parameter of a function
+
+    /*
+    a call may overwrite any register, so the subtree of a call is labeled as needing more registers than any target
+    has; it is then evaluated before the values that would otherwise have to be kept across the call
+    */
+    const int callLabel = 64;
+
+    bool is_literal(const tuc::SyntaxNode* node) {
+        return node->type() == NodeType::INTEGER;
+    }
+
+    bool is_expression(const tuc::SyntaxNode* node) {
+        return node->is_operator() || is_literal(node) || node->type() == NodeType::IDENTIFIER ||
+               node->type() == NodeType::CALL;
+    }
+
+    /*
+    returns true if the operands of `node` can be swapped without changing its value
+    */
+    bool is_commutative(const tuc::SyntaxNode* node) {
+        return node->type() == NodeType::ADD || node->type() == NodeType::MULTIPLY;
+    }
+
+    /*
+    returns the operands of a binary operation node in the order they should be used by the operation; a literal on
+    the left of a commutative operation is moved to the right so it can be used as an immediate operand
+    */
+    std::pair<const tuc::SyntaxNode*, const tuc::SyntaxNode*> operands_of(const tuc::SyntaxNode* node) {
+        auto left = node->child(0);
+        auto right = node->child(1);
+        if (is_commutative(node) && is_literal(left) && !is_literal(right))
+            std::swap(left, right);
+        return std::make_pair(left, right);
+    }
+
+    /*
+    labels every node of an expression tree with its Sethi-Ullman number (the number of registers needed to evaluate
+    it without spilling); a literal used as a right operand needs no register since it can be an immediate operand
+    */
+    int label_tree(const tuc::SyntaxNode* node, bool isRightOperand, const ParameterMap& parameters, LabelMap& labels) {
+        auto label = 1;
+        if (node->is_operator()) {
+            auto operands = operands_of(node);
+            auto leftLabel = label_tree(operands.first, false, parameters, labels);
+            auto rightLabel = label_tree(operands.second, true, parameters, labels);
+            label = leftLabel == rightLabel ? leftLabel + 1 : std::max(leftLabel, rightLabel);
+        }
+        else if (node->type() == NodeType::CALL ||
+                 (node->type() == NodeType::IDENTIFIER && parameters.count(node->value()) == 0)) {
+            label = callLabel;
+            for (int i = 0, count = node->child_count(); i < count; i++)
+                label = std::max(label, label_tree(node->child(i), false, parameters, labels));
+        }
+        else if (is_literal(node) && isRightOperand) {
+            label = 0;
+        }
+        labels[node] = label;
+        return label;
+    }
+
+    tuc::IROpcode opcode_of(const tuc::SyntaxNode* node) {
+        switch (node->type()) {
+        case NodeType::ADD:         return tuc::IROpcode::ADD;
+        case NodeType::SUBTRACT:    return tuc::IROpcode::SUBTRACT;
+        case NodeType::MULTIPLY:    return tuc::IROpcode::MULTIPLY;
+        default:                    return tuc::IROpcode::DIVIDE;
+        }
+    }
+
+    /*
+    The state of the lowering of an expression tree: the function and block the instructions go in, the functions of
+    the program, and the parameters of the function.
+    */
+    struct LoweringContext {
+        tuc::IRFunction& function;
+        tuc::BlockId block;
+        const FunctionMap& functions;
+        const ParameterMap& parameters;
+        LabelMap labels;
+    };
+
+    /*
+    lowers an expression tree into the block of `context`, returning the value holding its result; the operand needing
+    the most registers is lowered first (Sethi-Ullman order) so that the register allocator can evaluate the other
+    operand with the registers that are left, and so are the arguments of a call
+    */
+    tuc::ValueId gen_value(LoweringContext& context, const tuc::SyntaxNode* node) {
+        auto& function = context.function;
+        auto block = context.block;
+        if (is_literal(node)) {
+            return function.append(block, tuc::IROpcode::CONSTANT, tuc::IRType::INT32, {}, std::stoi(node->value()));
+        }
+        else if (node->type() == NodeType::IDENTIFIER && context.parameters.count(node->value()) > 0) {
+            return context.parameters.at(node->value());
+        }
+        else if (node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL) {
+            auto callee = context.functions.find(node->value());
+            if (callee == context.functions.end())
+                throw tuc::CompilerException::UnknownSymbol{node->text()};
+
+            auto order = std::vector<int>(node->child_count());
+            for (int i = 0, count = order.size(); i < count; i++)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+                return context.labels.at(node->child(a)) > context.labels.at(node->child(b));
+            });
+            auto arguments = std::vector<tuc::ValueId>(node->child_count(), tuc::no_value);
+            for (auto i : order)
+                arguments[i] = gen_value(context, node->child(i));
+            return function.append(block, tuc::IROpcode::CALL, tuc::IRType::INT32, arguments, callee->second);
+        }
+
+        auto operands = operands_of(node);
+        auto left = tuc::no_value;
+        auto right = tuc::no_value;
+        if (context.labels.at(operands.first) < context.labels.at(operands.second)) {
+            right = gen_value(context, operands.second);
+            left = gen_value(context, operands.first);
+        }
+        else {
+            left = gen_value(context, operands.first);
+            right = gen_value(context, operands.second);
+        }
+        return function.append(block, opcode_of(node), tuc::IRType::INT32, {left, right});
+    }
+
+    /*
+    lowers an expression tree into `block`, returning the value holding its result
+    */
+    tuc::ValueId gen_expression(tuc::IRFunction& function, tuc::BlockId block, const tuc::SyntaxNode* node,
+                                const FunctionMap& functions, const ParameterMap& parameters) {
+        auto context = LoweringContext{function, block, functions, parameters, LabelMap{}};
+        label_tree(node, false, parameters, context.labels);
+        return gen_value(context, node);
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+lowers a program's syntax tree to the intermediate representation
+*/
+tuc::IRProgram tuc::gen_ir(const SyntaxNode* root, const SymbolTable& symTable) {
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+
+    // every function gets its index before any body is lowered, since a function may call any other
+    auto functions = FunctionMap{};
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (statement->type() == SyntaxNode::NodeType::ASSIGN) {
+            functions[statement->child(0)->value()] = program.size();
+            program.emplace_back(statement->child(0)->value());
+        }
+    }
+
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (statement->type() != SyntaxNode::NodeType::ASSIGN)
+            continue;
+
+        auto& function = program[functions.at(statement->child(0)->value())];
+        auto block = function.add_block();
+        auto parameters = ParameterMap{};
+        auto head = statement->child(0);
+        for (int p = 0, parameterCount = head->child_count(); p < parameterCount; p++)
+            parameters[head->child(p)->value()] = function.append(block, IROpcode::PARAMETER, IRType::INT32, {}, p);
+        auto result = gen_expression(function, block, statement->child(1), functions, parameters);
+        function.append(block, IROpcode::RETURN, IRType::VOID, {result});
+    }
+
+    auto& function = program.front();
+    auto block = function.add_block();
+    auto result = no_value;
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        if (!is_expression(statement))
+            continue;   // declarations and definitions are not evaluated
+
+        if (result != no_value) {
+            auto nextBlock = function.add_block();
+            function.append(block, IROpcode::JUMP, IRType::VOID, {}, nextBlock);
+            block = nextBlock;
+        }
+
+        result = gen_expression(function, block, statement, functions, ParameterMap{});
+    }
+
+    if (result == no_value)
+        result = function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+    function.append(block, IROpcode::EXIT, IRType::VOID, {result});
+
+    return program;
+}
+
+/*
+returns the number of registers needed to evaluate an expression without spilling values to the stack
+*/
+int tuc::register_need(const SyntaxNode* node) {
+    auto labels = LabelMap{};
+    return label_tree(node, false, ParameterMap{}, labels);
+}
@@ -0,0 +1,188 @@
+/*
+Project: TUC
+File: jit.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+// project headers
+#include "jit.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+// POSIX headers
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::Register;
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+
+    // the registers a System V function must preserve, in the order they are pushed by the JIT'd function
+    const auto calleeSaved = std::vector<Register>{Register::BX, Register::BP, Register::R12, Register::R13,
+                                                   Register::R14, Register::R15};
+
+    /*
+    appends the end of the JIT'd function to its code: the exit status (in edi for the exit system call) is returned
+    in eax, and the stack pointer and the registers of the caller are restored
+
+    The frame pointer is set to the stack pointer when the function starts and generated code only ever sets it to the
+    same value again (when it makes its own frame), so it still holds the stack pointer to restore at any exit.
+    */
+    void append_return(tuc::AsmList& code) {
+        code.emplace_back(AsmOpcode::MOV, std::vector<AsmOperand>{AsmOperand::reg(Register::AX), AsmOperand::reg(Register::DI)});
+        code.emplace_back(AsmOpcode::MOV, std::vector<AsmOperand>{AsmOperand::reg(Register::SP), AsmOperand::reg(Register::BP)}, 8);
+        for (auto r = calleeSaved.crbegin(); r != calleeSaved.crend(); ++r)
+            code.emplace_back(AsmOpcode::POP, std::vector<AsmOperand>{AsmOperand::reg(*r)}, 8);
+        code.emplace_back(AsmOpcode::RET);
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::JitProgram::JitProgram(const AsmList& code)
+    : machineCode{encode_instructions(gen_jit_code(code), Target::X86_64)} {
+#if defined(__x86_64__)
+    // the data the code reserves is in the pages after it, zeroed by `mmap`
+    auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    auto codeSize = (machineCode.bytes().size() + pageSize - 1) / pageSize * pageSize;
+    mappedSize = codeSize + (machineCode.data_size() + pageSize - 1) / pageSize * pageSize;
+    memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        memory = nullptr;
+        throw CompilerException::JitFailure{"mmap", std::strerror(errno)};
+    }
+    auto address = reinterpret_cast<std::uintptr_t>(memory);
+    auto bytes = machineCode.relocated_bytes(address, address + codeSize, Target::X86_64);
+    std::memcpy(memory, bytes.data(), bytes.size());
+
+    // the pages are never writable and executable at the same time
+    if (mprotect(memory, codeSize, PROT_READ | PROT_EXEC) != 0) {
+        auto cause = std::string{std::strerror(errno)};
+        munmap(memory, mappedSize);
+        memory = nullptr;
+        throw CompilerException::JitFailure{"mprotect", cause};
+    }
+#else
+    throw CompilerException::JitFailure{"load", "the JIT runs x86-64 code, which this machine cannot run"};
+#endif
+}
+
+tuc::JitProgram::~JitProgram() {
+    if (memory != nullptr)
+        munmap(memory, mappedSize);
+}
+
+/*
+runs the program and returns the value it exits with
+*/
+std::int32_t tuc::JitProgram::run() const {
+    auto function = reinterpret_cast<std::int32_t (*)()>(memory);
+    return function();
+}
+
+const std::uint8_t* tuc::JitProgram::address() const noexcept {
+    return static_cast<const std::uint8_t*>(memory);
+}
+
+std::size_t tuc::JitProgram::size() const noexcept {
+    return machineCode.bytes().size();
+}
+
+/*
+puts one line per label of the code in an output stream, in the format of perf map files
+
+Labels at the same offset (e.g. `_start` and `_start.block0`) would cover the same code, so only the last of them is
+put.
+*/
+void tuc::JitProgram::write_perf_map(std::ostream& os) const {
+    const auto& labels = machineCode.labels();
+    auto base = reinterpret_cast<std::uintptr_t>(memory);
+    for (std::size_t i = 0; i < labels.size(); i++) {
+        auto end = i + 1 < labels.size() ? labels[i + 1].second : size();
+        if (end > labels[i].second)
+            os << std::hex << base + labels[i].second << " " << end - labels[i].second << std::dec << " "
+               << labels[i].first << "\n";
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the x86-64 code of a program turned into a function of the System V ABI taking no arguments
+
+The function starts at the `tuc_jit_entry` label, where it saves the registers of its caller, and each exit system
+call of the program is replaced by a return of its status.
+*/
+tuc::AsmList tuc::gen_jit_code(const AsmList& code) {
+    auto function = AsmList{};
+    function.emplace_back(AsmOpcode::LABEL, std::vector<AsmOperand>{AsmOperand::label("tuc_jit_entry")});
+    for (auto r : calleeSaved)
+        function.emplace_back(AsmOpcode::PUSH, std::vector<AsmOperand>{AsmOperand::reg(r)}, 8);
+    function.emplace_back(AsmOpcode::MOV, std::vector<AsmOperand>{AsmOperand::reg(Register::BP), AsmOperand::reg(Register::SP)}, 8);
+
+    for (const auto& instruction : code) {
+        if (instruction.opcode() == AsmOpcode::INT) {
+            auto text = std::stringstream{};
+            text << instruction;
+            throw CompilerException::InvalidInstruction{text.str(), "the JIT only runs code generated for x86-64 (`-m64`)"};
+        }
+        else if (is_exit(instruction))
+            append_return(function);
+        else
+            function.push_back(instruction);
+    }
+    return function;
+}
+
+/*
+returns the file `perf` reads the symbols of the code JIT'd by this process from
+*/
+std::string tuc::perf_map_path() {
+    return "/tmp/perf-" + std::to_string(getpid()) + ".map";
+}
@@ -0,0 +1,134 @@
+/*
+Project: TUC
+File: memoizer.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "memoizer.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using CallGraph = std::vector<std::vector<int>>;    // the functions called by each function, once per call
+
+    /*
+    returns the functions called by the instructions of each function of a program
+    */
+    CallGraph call_graph(const tuc::IRProgram& program) {
+        auto callees = CallGraph(program.size());
+        for (int f = 0, count = program.size(); f < count; f++) {
+            for (auto v : program[f].linear_order()) {
+                const auto& instruction = program[f].instruction(v);
+                if (instruction.opcode() == tuc::IROpcode::CALL)
+                    callees[f].push_back(instruction.immediate());
+            }
+        }
+        return callees;
+    }
+
+    /*
+    appends the functions reachable from `index` that were not visited yet to `order`, callees before their callers
+    */
+    void visit_callees(const CallGraph& callees, int index, std::vector<bool>& visited, std::vector<int>& order) {
+        visited[index] = true;
+        for (auto callee : callees[index]) {
+            if (!visited[callee])
+                visit_callees(callees, callee, visited, order);
+        }
+        order.push_back(index);
+    }
+
+    /*
+    returns which functions function `index` can call, directly or through other functions
+    */
+    std::vector<bool> reachable_from(const CallGraph& callees, int index) {
+        auto visited = std::vector<bool>(callees.size(), false);
+        auto order = std::vector<int>{};
+        for (auto callee : callees[index]) {
+            if (!visited[callee])
+                visit_callees(callees, callee, visited, order);
+        }
+        return visited;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+marks the functions whose calls are likely to be repeated with the same arguments as memoized; returns the number of
+functions marked
+
+The number of calls of each function is the sum, over its call sites, of the number of calls of the function making
+the call, starting from the single call of the entry point. The functions are visited callers first, leaving out the
+calls that recurse (whose count would be unbounded; those are the ones tree recursion is about), and the counts stop
+at the threshold.
+*/
+int tuc::memoize_functions(IRProgram& program, int threshold) {
+    auto callees = call_graph(program);
+    auto reachable = std::vector<std::vector<bool>>{};
+    for (int f = 0, count = program.size(); f < count; f++)
+        reachable.push_back(reachable_from(callees, f));
+
+    auto visited = std::vector<bool>(program.size(), false);
+    auto order = std::vector<int>{};
+    visit_callees(callees, 0, visited, order);
+    auto calls = std::vector<long long>(program.size(), 0);
+    calls[0] = 1;
+    for (auto f = order.crbegin(); f != order.crend(); f++) {
+        for (auto callee : callees[*f]) {
+            if (!reachable[callee][*f])
+                calls[callee] = std::min<long long>(threshold, calls[callee] + calls[*f]);
+        }
+    }
+
+    auto memoized = 0;
+    for (int f = 1, count = program.size(); f < count; f++) {
+        if (!visited[f] || program[f].memoized() || callees[f].empty())
+            continue;
+        auto recursiveCalls = std::count_if(callees[f].cbegin(), callees[f].cend(), [&](int callee) { return reachable[callee][f]; });
+        if (recursiveCalls > 1 || calls[f] >= threshold) {
+            program[f].set_memoized(true);
+            memoized++;
+        }
+    }
+    return memoized;
+}
@@ -0,0 +1,312 @@
+/*
+Project: TUC
+File: parallelizer.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "parallelizer.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::IROpcode;
+    using tuc::ValueId;
+
+    const long long max_cost = 1ll << 40;   // estimates stop growing there, far past any threshold
+
+    /*
+    what is known of the run of a call of a function: whether it returns, whether it can reach a memoized function,
+    and how many instructions it runs (including those of its own calls)
+    */
+    struct CallCost {
+        bool terminates = true;
+        bool reachesMemoized = false;
+        long long instructions = 0;
+    };
+
+    enum class VisitState {UNVISITED, VISITING, DONE};
+
+    /*
+    estimates the cost of the calls of function `index` after those of the functions it calls; a function calling one
+    that is still being visited is recursive and so never returns (U has no conditionals), and neither does any
+    function calling one that never returns
+    */
+    void estimate_cost(const tuc::IRProgram& program, int index, std::vector<VisitState>& state, std::vector<CallCost>& costs) {
+        state[index] = VisitState::VISITING;
+        auto cost = CallCost{};
+        cost.reachesMemoized = program[index].memoized();
+        for (auto v : program[index].linear_order()) {
+            cost.instructions = std::min(max_cost, cost.instructions + 1);
+            const auto& instruction = program[index].instruction(v);
+            if (instruction.opcode() != IROpcode::CALL)
+                continue;
+            auto callee = instruction.immediate();
+            if (state[callee] == VisitState::UNVISITED)
+                estimate_cost(program, callee, state, costs);
+            if (state[callee] == VisitState::VISITING || !costs[callee].terminates) {
+                cost.terminates = false;
+            }
+            else {
+                cost.instructions = std::min(max_cost, cost.instructions + costs[callee].instructions);
+                cost.reachesMemoized = cost.reachesMemoized || costs[callee].reachesMemoized;
+            }
+        }
+        costs[index] = cost;
+        state[index] = VisitState::DONE;
+    }
+
+    /*
+    returns the cost of the calls of each function of a program
+    */
+    std::vector<CallCost> estimate_costs(const tuc::IRProgram& program) {
+        auto state = std::vector<VisitState>(program.size(), VisitState::UNVISITED);
+        auto costs = std::vector<CallCost>(program.size());
+        for (int f = 0, count = program.size(); f < count; f++) {
+            if (state[f] == VisitState::UNVISITED)
+                estimate_cost(program, f, state, costs);
+        }
+        return costs;
+    }
+
+    /*
+    returns the block using each value of a function: -1 if none does and -2 if more than one does
+    */
+    std::vector<tuc::BlockId> use_blocks(const tuc::IRFunction& function) {
+        auto useBlock = std::vector<tuc::BlockId>(function.instruction_count(), -1);
+        for (tuc::BlockId b = 0, count = function.block_count(); b < count; b++) {
+            for (auto v : function.block(b).instructions()) {
+                for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++) {
+                    auto& block = useBlock[function.operand(v, i)];
+                    block = block == -1 || block == b ? b : -2;
+                }
+            }
+        }
+        return useBlock;
+    }
+
+    /*
+    Finds the calls of the blocks of a function that are worth running in parallel, and moves them up to run as early as
+    they can.
+    */
+    class BlockParallelizer {
+        public:
+            BlockParallelizer(const tuc::IRFunction& _function, const std::vector<CallCost>& _costs, int _threshold);
+
+            std::vector<ValueId> reorder(const std::vector<ValueId>& instructions) const;
+            /*  returns the instructions of a block with the expensive calls, and the instructions computing their
+                arguments, moved up as far as the calls that never return (and the end of the block) allow */
+
+            std::vector<ValueId> spawned_calls(tuc::BlockId block, const std::vector<ValueId>& instructions) const;
+            /*  returns the expensive calls of a block (in the order of `instructions`) followed by another expensive
+                call before the first use of their result, with no call that never returns in between */
+
+        private:
+            bool is_expensive(ValueId value) const;
+
+            bool is_barrier(ValueId value) const;
+            /*  returns true if `value` is a call that never returns, which no instruction may be moved across */
+
+            void append_segment(const std::vector<ValueId>& segment, std::vector<ValueId>& order) const;
+
+            const tuc::IRFunction& function;
+            const std::vector<CallCost>& costs;
+            int threshold;
+            std::vector<tuc::BlockId> useBlock;
+    };
+
+    BlockParallelizer::BlockParallelizer(const tuc::IRFunction& _function, const std::vector<CallCost>& _costs, int _threshold)
+    : function{_function}, costs{_costs}, threshold{_threshold}, useBlock{use_blocks(_function)} {}
+
+    bool BlockParallelizer::is_expensive(ValueId value) const {
+        const auto& instruction = function.instruction(value);
+        if (instruction.opcode() != IROpcode::CALL)
+            return false;
+        const auto& cost = costs[instruction.immediate()];
+        return cost.terminates && !cost.reachesMemoized && cost.instructions >= threshold;
+    }
+
+    /*
+    returns true if `value` is a call that never returns, which no instruction may be moved across
+    */
+    bool BlockParallelizer::is_barrier(ValueId value) const {
+        const auto& instruction = function.instruction(value);
+        return instruction.opcode() == IROpcode::CALL && !costs[instruction.immediate()].terminates;
+    }
+
+    /*
+    appends the instructions of a part of a block with no call that never returns to `order`: each expensive call comes
+    right after the instructions it depends on (in their original order) and the other instructions follow
+
+    Every instruction of the part is run before anything after it, so the only difference the order can make is which
+    division traps first, and all of them trap the same way.
+    */
+    void BlockParallelizer::append_segment(const std::vector<ValueId>& segment, std::vector<ValueId>& order) const {
+        auto inSegment = std::vector<bool>(function.instruction_count(), false);
+        for (auto v : segment)
+            inSegment[v] = true;
+
+        auto moved = std::vector<bool>(function.instruction_count(), false);
+        for (auto call : segment) {
+            if (!is_expensive(call))
+                continue;
+            auto slice = std::vector<bool>(function.instruction_count(), false);
+            auto pending = std::vector<ValueId>{call};
+            while (!pending.empty()) {
+                auto v = pending.back();
+                pending.pop_back();
+                slice[v] = true;
+                for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++) {
+                    auto operand = function.operand(v, i);
+                    if (inSegment[operand] && !moved[operand] && !slice[operand])
+                        pending.push_back(operand);
+                }
+            }
+            for (auto v : segment) {
+                if (slice[v] && !moved[v]) {
+                    order.push_back(v);
+                    moved[v] = true;
+                }
+            }
+        }
+        for (auto v : segment) {
+            if (!moved[v])
+                order.push_back(v);
+        }
+    }
+
+    /*
+    returns the instructions of a block with the expensive calls, and the instructions computing their arguments, moved
+    up as far as the calls that never return (and the end of the block) allow
+    */
+    std::vector<ValueId> BlockParallelizer::reorder(const std::vector<ValueId>& instructions) const {
+        auto order = std::vector<ValueId>{};
+        auto segment = std::vector<ValueId>{};
+        for (int i = 0, count = instructions.size(); i < count; i++) {
+            auto v = instructions[i];
+            if (i + 1 < count && !is_barrier(v)) {
+                segment.push_back(v);
+                continue;
+            }
+            append_segment(segment, order);
+            segment.clear();
+            order.push_back(v);
+        }
+        return order;
+    }
+
+    /*
+    returns the expensive calls of a block (in the order of `instructions`) followed by another expensive call before
+    the first use of their result, with no call that never returns in between
+
+    A call that does not wait for a thread to be free runs when its result is needed, so a call that never returns
+    between the two would keep a spawned call from ever running (and from trapping, if it would have).  The calls whose
+    result is used by another block are left alone.
+    */
+    std::vector<ValueId> BlockParallelizer::spawned_calls(tuc::BlockId block, const std::vector<ValueId>& instructions) const {
+        auto spawned = std::vector<ValueId>{};
+        for (int i = 0, count = instructions.size(); i < count; i++) {
+            auto call = instructions[i];
+            if (!is_expensive(call) || useBlock[call] != block)
+                continue;
+            auto overlapped = false;
+            for (int j = i + 1; j < count; j++) {
+                auto v = instructions[j];
+                const auto& instruction = function.instruction(v);
+                auto uses = false;
+                for (int o = 0, c = instruction.operand_count(); o < c; o++)
+                    uses = uses || function.operand(v, o) == call;
+                if (uses || is_barrier(v)) {
+                    if (uses && overlapped)
+                        spawned.push_back(call);
+                    break;
+                }
+                overlapped = overlapped || is_expensive(v);
+            }
+        }
+        return spawned;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+turns the calls that can run at the same time as a later call of the same block into a SPAWN, with a JOIN before the
+first use of their result; returns the number of calls spawned
+*/
+int tuc::parallelize_calls(IRProgram& program, int threshold) {
+    auto costs = estimate_costs(program);
+    auto spawnedCount = 0;
+    for (auto& function : program) {
+        auto parallelizer = BlockParallelizer{function, costs, threshold};
+        for (BlockId b = 0, count = function.block_count(); b < count; b++) {
+            auto order = parallelizer.reorder(function.block(b).instructions());
+            auto spawned = parallelizer.spawned_calls(b, order);
+            if (spawned.empty())
+                continue;
+
+            function.block(b).instructions() = order;
+            for (auto call : spawned) {
+                const auto& instruction = function.instruction(call);
+                auto arguments = std::vector<ValueId>{};
+                for (int i = 0, c = instruction.operand_count(); i < c; i++)
+                    arguments.push_back(function.operand(call, i));
+                auto callee = instruction.immediate();
+
+                // the join goes right before the first use of the result, which then uses the join instead
+                const auto& instructions = function.block(b).instructions();
+                auto firstUse = std::find_if(instructions.cbegin(), instructions.cend(), [&](ValueId v) {
+                    for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++) {
+                        if (function.operand(v, i) == call)
+                            return true;
+                    }
+                    return false;
+                });
+                auto join = function.insert(b, firstUse - instructions.cbegin(), IROpcode::JOIN, IRType::INT32, {call});
+                function.replace_uses(call, join);
+                function.set_operand(join, 0, call);
+                function.redefine(call, IROpcode::SPAWN, IRType::VOID, arguments, callee);
+                spawnedCount++;
+            }
+        }
+    }
+    return spawnedCount;
+}
@@ -0,0 +1,302 @@
+/*
+Project: TUC
+File: partial_evaluator.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "partial_evaluator.hpp"
+
+// standard libraries
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using Outcome = tuc::PartialEvaluation::Outcome;
+
+    /*
+    the values of a function that are known at compile time
+    */
+    class KnownValues {
+        public:
+            explicit KnownValues(int valueCount) : known(valueCount, false), varying(valueCount, false), values(valueCount, 0) {}
+
+            bool is_known(tuc::ValueId v) const {
+                return known[v];
+            }
+
+            std::int32_t value(tuc::ValueId v) const {
+                return values[v];
+            }
+
+            /*
+            records the value computed by an execution of an instruction; a value that differs between two executions
+            is not a constant
+            */
+            void set(tuc::ValueId v, std::int32_t value) {
+                if (varying[v] || (known[v] && values[v] != value)) {
+                    varying[v] = true;
+                    known[v] = false;
+                    return;
+                }
+                known[v] = true;
+                values[v] = value;
+            }
+
+            void set_unknown(tuc::ValueId v) {
+                varying[v] = true;
+                known[v] = false;
+            }
+
+        private:
+            std::vector<bool> known;
+            std::vector<bool> varying;
+            std::vector<std::int32_t> values;
+    };
+
+    /*
+    computes the value of an arithmetic instruction with known operands, wrapping around like the generated code does;
+    returns false if the instruction traps (division by 0 or overflow) and so must be left to run time
+    */
+    bool evaluate(tuc::IROpcode opcode, std::int32_t left, std::int32_t right, std::int32_t& result) {
+        auto l = static_cast<std::uint32_t>(left);
+        auto r = static_cast<std::uint32_t>(right);
+        switch (opcode) {
+        case tuc::IROpcode::ADD:        result = static_cast<std::int32_t>(l + r); return true;
+        case tuc::IROpcode::SUBTRACT:   result = static_cast<std::int32_t>(l - r); return true;
+        case tuc::IROpcode::MULTIPLY:   result = static_cast<std::int32_t>(l * r); return true;
+        case tuc::IROpcode::DIVIDE:
+            if (right == 0 || (left == std::numeric_limits<std::int32_t>::min() && right == -1))
+                return false;
+            result = left / right;
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    /*
+    the number of calls that may be in progress at once while evaluating a call; the deeper ones stop the evaluation as
+    if it ran out of fuel (a function that keeps calling itself never returns anyway)
+    */
+    const int max_call_depth = 1000;
+
+    /*
+    runs function `index` on the values of its arguments until it returns; returns how the evaluation ended, with the
+    result of the call in `result` if it was EVALUATED (RESIDUAL means that the call always traps)
+    */
+    Outcome run_call(const tuc::IRProgram& program, int index, const std::vector<std::int32_t>& arguments, int fuel,
+                     int depth, int& steps, std::int32_t& result) {
+        if (depth == max_call_depth)
+            return Outcome::OUT_OF_FUEL;
+
+        const auto& function = program[index];
+        auto values = std::vector<std::int32_t>(function.instruction_count(), 0);
+        auto block = tuc::BlockId{0};
+        while (true) {
+            for (auto v : function.block(block).instructions()) {
+                if (steps == fuel)
+                    return Outcome::OUT_OF_FUEL;
+                steps++;
+
+                const auto& instruction = function.instruction(v);
+                switch (instruction.opcode()) {
+                case tuc::IROpcode::CONSTANT:
+                    values[v] = instruction.immediate();
+                    break;
+                case tuc::IROpcode::PARAMETER:
+                    values[v] = arguments[instruction.immediate()];
+                    break;
+                case tuc::IROpcode::ADD:
+                case tuc::IROpcode::SUBTRACT:
+                case tuc::IROpcode::MULTIPLY:
+                case tuc::IROpcode::DIVIDE: {
+                    auto left = values[function.operand(v, 0)];
+                    auto right = values[function.operand(v, 1)];
+                    if (!evaluate(instruction.opcode(), left, right, values[v]))
+                        return Outcome::RESIDUAL;
+                    break;
+                }
+                case tuc::IROpcode::CALL: {
+                    auto callArguments = std::vector<std::int32_t>{};
+                    for (int i = 0; i < instruction.operand_count(); i++)
+                        callArguments.push_back(values[function.operand(v, i)]);
+                    auto callee = instruction.immediate();
+                    auto outcome = run_call(program, callee, callArguments, fuel, depth + 1, steps, values[v]);
+                    if (outcome != Outcome::EVALUATED)
+                        return outcome;
+                    break;
+                }
+                case tuc::IROpcode::JUMP:
+                    block = instruction.immediate();
+                    break;
+                case tuc::IROpcode::RETURN:
+                    result = values[function.operand(v, 0)];
+                    return Outcome::EVALUATED;
+                default:
+                    return Outcome::UNSUPPORTED;
+                }
+            }
+        }
+    }
+
+    /*
+    runs the entry function from its entry block until it exits, something unknown decides where it goes next, or it
+    runs out of fuel; returns how the evaluation ended and the number of instructions that were executed
+    */
+    Outcome run_function(const tuc::IRProgram& program, int fuel, KnownValues& known, int& steps) {
+        const auto& function = program.front();
+        auto residual = false;
+        auto block = tuc::BlockId{0};
+        while (true) {
+            for (auto v : function.block(block).instructions()) {
+                if (steps == fuel)
+                    return Outcome::OUT_OF_FUEL;
+                steps++;
+
+                const auto& instruction = function.instruction(v);
+                switch (instruction.opcode()) {
+                case tuc::IROpcode::CONSTANT:
+                    known.set(v, instruction.immediate());
+                    break;
+                case tuc::IROpcode::ADD:
+                case tuc::IROpcode::SUBTRACT:
+                case tuc::IROpcode::MULTIPLY:
+                case tuc::IROpcode::DIVIDE: {
+                    auto left = function.operand(v, 0);
+                    auto right = function.operand(v, 1);
+                    auto result = std::int32_t{0};
+                    if (known.is_known(left) && known.is_known(right) &&
+                        evaluate(instruction.opcode(), known.value(left), known.value(right), result))
+                        known.set(v, result);
+                    else if (known.is_known(left) && known.is_known(right))
+                        return Outcome::RESIDUAL;   // the program always traps here; nothing after it runs
+                    else
+                        known.set_unknown(v);
+                    residual = residual || !known.is_known(v);
+                    break;
+                }
+                case tuc::IROpcode::CALL: {
+                    auto arguments = std::vector<std::int32_t>{};
+                    for (int i = 0; i < instruction.operand_count() && known.is_known(function.operand(v, i)); i++)
+                        arguments.push_back(known.value(function.operand(v, i)));
+                    if (static_cast<int>(arguments.size()) < instruction.operand_count()) {
+                        known.set_unknown(v);
+                        residual = true;
+                        break;
+                    }
+                    auto result = std::int32_t{0};
+                    auto outcome = run_call(program, instruction.immediate(), arguments, fuel, 0, steps, result);
+                    if (outcome != Outcome::EVALUATED)
+                        return outcome;     // a call that traps ends the program like a division that traps
+                    known.set(v, result);
+                    residual = residual || !known.is_known(v);
+                    break;
+                }
+                case tuc::IROpcode::JUMP:
+                    block = instruction.immediate();
+                    break;
+                case tuc::IROpcode::EXIT:
+                    return residual || !known.is_known(function.operand(v, 0)) ? Outcome::RESIDUAL : Outcome::EVALUATED;
+                default:
+                    return Outcome::UNSUPPORTED;
+                }
+            }
+        }
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::PartialEvaluation::PartialEvaluation(Outcome _outcome, int _steps, int _folded)
+: evaluationOutcome{_outcome}, stepCount{_steps}, foldedCount{_folded} {}
+
+tuc::PartialEvaluation::Outcome tuc::PartialEvaluation::outcome() const noexcept {
+    return evaluationOutcome;
+}
+
+/*
+returns the number of instructions that were executed
+*/
+int tuc::PartialEvaluation::steps() const noexcept {
+    return stepCount;
+}
+
+/*
+returns the number of instructions that were replaced by constants
+*/
+int tuc::PartialEvaluation::folded() const noexcept {
+    return foldedCount;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+runs the program at compile time for at most `fuel` instructions and replaces every value it could compute by a
+constant; the code that depends on anything only known at run time is left as it is (the residual)
+
+Only the entry function is run since it is the only one the program starts in; the functions it calls are run on the
+values of the arguments of each call, and the call is replaced by the result. Every instruction executed (in the entry
+function or in a call) uses one unit of fuel; if it runs out, or an instruction that is not modelled is found, nothing
+is changed. When the exit code is known, the instructions computing it become dead and are removed by the dead
+statement pass, leaving only the exit sequence.
+*/
+tuc::PartialEvaluation tuc::partially_evaluate(IRProgram& program, int fuel) {
+    if (program.empty())
+        return PartialEvaluation{PartialEvaluation::Outcome::EVALUATED, 0, 0};
+
+    auto& function = program.front();
+    auto known = KnownValues{function.instruction_count()};
+    auto steps = 0;
+    auto outcome = run_function(program, fuel, known, steps);
+    if (outcome == Outcome::OUT_OF_FUEL || outcome == Outcome::UNSUPPORTED)
+        return PartialEvaluation{outcome, steps, 0};
+
+    auto folded = 0;
+    for (auto v : function.linear_order()) {
+        if (known.is_known(v) && function.instruction(v).opcode() != IROpcode::CONSTANT) {
+            function.redefine(v, IROpcode::CONSTANT, IRType::INT32, {}, known.value(v));
+            folded++;
+        }
+    }
+    return PartialEvaluation{outcome, steps, folded};
+}
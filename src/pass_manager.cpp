@@ -0,0 +1,598 @@
+/*
+Project: TUC
+File: pass_manager.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "pass_manager.hpp"
+#include "asm_generator.hpp"
+#include "peephole.hpp"
+#include "dead_statements.hpp"
+#include "partial_evaluator.hpp"
+#include "inliner.hpp"
+#include "memoizer.hpp"
+#include "strictness.hpp"
+#include "parallelizer.hpp"
+#include "algebraic_simplifier.hpp"
+#include "value_range.hpp"
+#include "scheduler.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <utility>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    /*
+    caches the results of the functions whose calls are likely to be repeated with the same arguments (see
+    memoizer.hpp)
+    */
+    class MemoizationPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "memoize";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager&) override {
+                auto count = tuc::memoize_functions(program, threshold);
+                memoized += count;
+                return count > 0;
+            }
+
+            bool set_parameter(const std::string& parameter, int value) override {
+                if (parameter != "memoize-threshold")
+                    return false;
+                threshold = value;
+                return true;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " memoized functions: " << memoized << "\n";
+            }
+
+        private:
+            int threshold = tuc::default_memoize_threshold;
+            int memoized = 0;
+    };
+
+    /*
+    replaces calls to small functions by their bodies so that the other passes can specialize them to their arguments
+    (see inliner.hpp)
+    */
+    class InliningPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "inline";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager&) override {
+                auto count = tuc::inline_calls(program, threshold);
+                inlined += count;
+                return count > 0;
+            }
+
+            bool set_parameter(const std::string& parameter, int value) override {
+                if (parameter != "inline-threshold")
+                    return false;
+                threshold = value;
+                return true;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " inlined calls: " << inlined << "\n";
+            }
+
+        private:
+            int threshold = tuc::default_inline_threshold;
+            int inlined = 0;
+    };
+
+    /*
+    precomputes everything the program computes that does not depend on run time (see partial_evaluator.hpp)
+    */
+    class PartialEvaluationPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "partial-eval";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager&) override {
+                auto evaluation = tuc::partially_evaluate(program, fuel);
+                steps += evaluation.steps();
+                folded += evaluation.folded();
+                if (evaluation.outcome() == tuc::PartialEvaluation::Outcome::EVALUATED)
+                    evaluated++;
+                else if (evaluation.outcome() == tuc::PartialEvaluation::Outcome::OUT_OF_FUEL)
+                    outOfFuel++;
+                return evaluation.folded() > 0;
+            }
+
+            bool set_parameter(const std::string& parameter, int value) override {
+                if (parameter != "partial-eval-fuel")
+                    return false;
+                if (value < 0)
+                    throw tuc::CompilerException::InvalidOption{parameter, "the fuel cannot be negative"};
+                fuel = value;
+                return true;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " steps: " << steps << "\n";
+                os << name() << " folded instructions: " << folded << "\n";
+                os << name() << " fully evaluated programs: " << evaluated << "\n";
+                os << name() << " out of fuel: " << outOfFuel << "\n";
+            }
+
+        private:
+            int fuel = tuc::default_evaluation_fuel;
+            int steps = 0;
+            int folded = 0;
+            int evaluated = 0;
+            int outOfFuel = 0;
+    };
+
+    /*
+    gathers the constants of integer expressions together and applies algebraic identities (see
+    algebraic_simplifier.hpp)
+    */
+    class AlgebraicSimplificationPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "simplify";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager& analyses) override {
+                auto count = tuc::simplify_algebra(program, analyses.get<tuc::UseCountAnalysis>(program));
+                rewritten += count;
+                return count > 0;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " rewritten expressions: " << rewritten << "\n";
+            }
+
+        private:
+            int rewritten = 0;
+    };
+
+    /*
+    removes the parameters that no call evaluates, and the arguments passed for them (see strictness.hpp)
+    */
+    class DeadArgumentPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "dead-arguments";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager& analyses) override {
+                auto count = tuc::eliminate_dead_arguments(program, analyses.get<tuc::StrictnessAnalysis>(program));
+                removed += count;
+                return count > 0;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " removed parameters: " << removed << "\n";
+            }
+
+        private:
+            int removed = 0;
+    };
+
+    /*
+    removes the statements (and parts of statements) whose results are never used (see dead_statements.hpp)
+    */
+    class DeadStatementPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "dead-statements";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager& analyses) override {
+                auto count = tuc::eliminate_dead_statements(program, analyses.get<tuc::UseCountAnalysis>(program),
+                                                            &analyses.get<tuc::ValueRangeAnalysis>(program));
+                removed += count;
+                return count > 0;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " removed instructions: " << removed << "\n";
+            }
+
+        private:
+            int removed = 0;
+    };
+
+    /*
+    runs the expensive calls that do not depend on each other at the same time (see parallelizer.hpp)
+    */
+    class ParallelizationPass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "parallelize";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager&) override {
+                auto count = tuc::parallelize_calls(program, threshold);
+                spawned += count;
+                return count > 0;
+            }
+
+            bool set_parameter(const std::string& parameter, int value) override {
+                if (parameter != "parallel-threshold")
+                    return false;
+                threshold = value;
+                return true;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " spawned calls: " << spawned << "\n";
+            }
+
+        private:
+            int threshold = tuc::default_parallel_threshold;
+            int spawned = 0;
+    };
+
+    /*
+    computes the range of every value for the code generator, which uses it to pick cheaper instruction sequences (see
+    value_range.hpp); the ranges can also be printed for debugging
+    */
+    class ValueRangePass : public tuc::IRPass {
+        public:
+            std::string name() const override {
+                return "value-ranges";
+            }
+
+            bool run(tuc::IRProgram& program, tuc::AnalysisManager& analyses) override {
+                const auto& ranges = analyses.get<tuc::ValueRangeAnalysis>(program);
+                if (dump)
+                    tuc::dump_value_ranges(std::cerr, program, ranges);
+                return false;
+            }
+
+            bool set_parameter(const std::string& parameter, int value) override {
+                if (parameter != "value-ranges-dump")
+                    return false;
+                dump = value != 0;
+                return true;
+            }
+
+        private:
+            bool dump = false;
+    };
+
+    /*
+    rewrites wasteful instruction sequences (see peephole.hpp), counting how many times each rule was applied
+    */
+    class PeepholePass : public tuc::AsmPass {
+        public:
+            std::string name() const override {
+                return "peephole";
+            }
+
+            bool run(tuc::AsmList& code) override {
+                auto changed = false;
+                for (const auto& rule : tuc::peephole_optimize(code)) {
+                    stats[rule.first] += rule.second;
+                    changed = changed || rule.second > 0;
+                }
+                return changed;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                for (const auto& rule : stats)
+                    os << name() << " " << rule.first << ": " << rule.second << "\n";
+            }
+
+        private:
+            tuc::PeepholeStats stats;
+    };
+
+    /*
+    reorders independent instructions so that long latencies overlap (see scheduler.hpp)
+    */
+    class SchedulingPass : public tuc::AsmPass {
+        public:
+            std::string name() const override {
+                return "schedule";
+            }
+
+            bool run(tuc::AsmList& code) override {
+                auto result = tuc::schedule_instructions(code);
+                moved += result.moved();
+                cyclesBefore += result.cycles_before();
+                cyclesAfter += result.cycles_after();
+                return result.moved() > 0;
+            }
+
+            void print_statistics(std::ostream& os) const override {
+                os << name() << " moved instructions: " << moved << "\n";
+                os << name() << " estimated cycles: " << cyclesBefore << " -> " << cyclesAfter << "\n";
+            }
+
+        private:
+            int moved = 0;
+            int cyclesBefore = 0;
+            int cyclesAfter = 0;
+    };
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+discards all the cached results
+*/
+void tuc::AnalysisManager::invalidate() noexcept {
+    results.clear();
+}
+
+/*
+returns the number of times an analysis was actually run
+*/
+int tuc::AnalysisManager::computation_count() const noexcept {
+    return computations;
+}
+
+
+
+/*
+sets a tuning parameter of the pass; returns false if the pass has no such parameter (default has none)
+*/
+bool tuc::IRPass::set_parameter(const std::string&, int) {
+    return false;
+}
+
+/*
+prints what the pass did in its previous runs (default prints nothing)
+*/
+void tuc::IRPass::print_statistics(std::ostream&) const {}
+
+
+
+/*
+sets a tuning parameter of the pass; returns false if the pass has no such parameter (default has none)
+*/
+bool tuc::AsmPass::set_parameter(const std::string&, int) {
+    return false;
+}
+
+/*
+prints what the pass did in its previous runs (default prints nothing)
+*/
+void tuc::AsmPass::print_statistics(std::ostream&) const {}
+
+
+
+/*
+registers a pass over the intermediate representation, run from optimization level `level`
+*/
+void tuc::PassManager::add_pass(std::unique_ptr<IRPass> pass, int level) {
+    irPasses.push_back(Registration<IRPass>{std::move(pass), level});
+}
+
+/*
+registers a pass over the generated instructions, run from optimization level `level`
+*/
+void tuc::PassManager::add_pass(std::unique_ptr<AsmPass> pass, int level) {
+    asmPasses.push_back(Registration<AsmPass>{std::move(pass), level});
+}
+
+/*
+returns the names of all the registered passes, in the order they are run
+*/
+std::vector<std::string> tuc::PassManager::pass_names() const {
+    auto names = std::vector<std::string>{};
+    for (const auto& r : irPasses)
+        names.push_back(r.pass->name());
+    for (const auto& r : asmPasses)
+        names.push_back(r.pass->name());
+    return names;
+}
+
+/*
+sets the optimization level (0 to `max_optimization_level`)
+*/
+void tuc::PassManager::set_level(int level) {
+    if (level < 0 || level > max_optimization_level)
+        throw CompilerException::InvalidOption{"-O" + std::to_string(level),
+            "the optimization level must be between 0 and " + std::to_string(max_optimization_level)};
+    optimizationLevel = level;
+}
+
+int tuc::PassManager::level() const noexcept {
+    return optimizationLevel;
+}
+
+/*
+enables or disables a pass regardless of the optimization level
+*/
+void tuc::PassManager::set_enabled(const std::string& passName, bool enabled) {
+    pass_level(passName);   // make sure the pass exists
+    overrides[passName] = enabled;
+}
+
+/*
+returns true if the pass will be run
+*/
+bool tuc::PassManager::is_enabled(const std::string& passName) const {
+    auto o = overrides.find(passName);
+    if (o != overrides.end())
+        return o->second;
+    return pass_level(passName) <= optimizationLevel;
+}
+
+/*
+sets a tuning parameter of the pass that has it (throws if no pass has it)
+*/
+void tuc::PassManager::set_parameter(const std::string& parameter, int value) {
+    auto found = false;
+    for (auto& r : irPasses)
+        found = r.pass->set_parameter(parameter, value) || found;
+    for (auto& r : asmPasses)
+        found = r.pass->set_parameter(parameter, value) || found;
+    if (!found)
+        throw CompilerException::InvalidOption{parameter, "there is no optimization parameter named `" + parameter + "`"};
+}
+
+/*
+sets the table of superoptimized sequences the code generator looks up (none if null)
+*/
+void tuc::PassManager::set_superoptimizer_table(const SuperoptimizerTable* table) noexcept {
+    superoptimizerTable = table;
+}
+
+/*
+sets the instruction set code is generated for (x86 by default)
+*/
+void tuc::PassManager::set_target(Target target) noexcept {
+    codeTarget = target;
+}
+
+tuc::Target tuc::PassManager::target() const noexcept {
+    return codeTarget;
+}
+
+/*
+sets the number of threads the generated program starts to run spawned calls (0, the default, for one per processor; at
+most `max_worker_count`)
+*/
+void tuc::PassManager::set_worker_count(int workers) {
+    if (workers < 0 || workers > max_worker_count)
+        throw CompilerException::InvalidOption{std::to_string(workers),
+            "the number of worker threads must be between 0 and " + std::to_string(max_worker_count)};
+    workerCount = workers;
+}
+
+/*
+runs the enabled passes over `program` and returns its optimized instructions
+*/
+tuc::AsmList tuc::PassManager::run(IRProgram& program) {
+    optimize(program);
+    return gen_code(program);
+}
+
+/*
+runs the enabled passes over the intermediate representation of `program` (the first half of `run()`)
+
+The cached analyses are discarded every time a pass changes the program.
+*/
+void tuc::PassManager::optimize(IRProgram& program) {
+    for (auto& r : irPasses) {
+        if (is_enabled(r.pass->name()) && r.pass->run(program, analysisManager))
+            analysisManager.invalidate();
+    }
+}
+
+/*
+generates the instructions of `program` and runs the enabled passes over them (the second half of `run()`)
+
+The code generator is given the value ranges of the program if the `value-ranges` pass is registered and enabled.
+*/
+tuc::AsmList tuc::PassManager::gen_code(const IRProgram& program) {
+    auto ranges = static_cast<const ValueRangeAnalysis::Result*>(nullptr);
+    for (const auto& r : irPasses) {
+        if (r.pass->name() == "value-ranges" && is_enabled(r.pass->name()))
+            ranges = &analysisManager.get<ValueRangeAnalysis>(program);
+    }
+    auto code = gen_program_code(program, ranges, superoptimizerTable, codeTarget, workerCount);
+    for (auto& r : asmPasses) {
+        if (is_enabled(r.pass->name()))
+            r.pass->run(code);
+    }
+    return code;
+}
+
+tuc::AnalysisManager& tuc::PassManager::analyses() noexcept {
+    return analysisManager;
+}
+
+/*
+prints what each enabled pass did
+*/
+void tuc::PassManager::print_statistics(std::ostream& os) const {
+    for (const auto& r : irPasses) {
+        if (is_enabled(r.pass->name()))
+            r.pass->print_statistics(os);
+    }
+    for (const auto& r : asmPasses) {
+        if (is_enabled(r.pass->name()))
+            r.pass->print_statistics(os);
+    }
+}
+
+/*
+returns the level a pass was registered with (throws if there is no pass with that name)
+*/
+int tuc::PassManager::pass_level(const std::string& passName) const {
+    for (const auto& r : irPasses) {
+        if (r.pass->name() == passName)
+            return r.level;
+    }
+    for (const auto& r : asmPasses) {
+        if (r.pass->name() == passName)
+            return r.level;
+    }
+    throw CompilerException::InvalidOption{passName, "there is no optimization pass named `" + passName + "`"};
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns a pass manager with all the passes of the compiler registered (at the default optimization level)
+
+-O1 only enables cheap passes that look at a few instructions at a time; -O2 enables everything but memoization, which
+trades memory for time, and parallelization, which trades threads for time; these are only run when enabled explicitly
+(`--enable-memoize`, `--enable-parallelize`).
+*/
+tuc::PassManager tuc::standard_pipeline() {
+    auto passes = PassManager{};
+    passes.add_pass(std::unique_ptr<IRPass>{new MemoizationPass{}}, max_optimization_level + 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new InliningPass{}}, 2);
+    passes.add_pass(std::unique_ptr<IRPass>{new PartialEvaluationPass{}}, 2);
+    passes.add_pass(std::unique_ptr<IRPass>{new AlgebraicSimplificationPass{}}, 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new DeadArgumentPass{}}, 2);
+    passes.add_pass(std::unique_ptr<IRPass>{new DeadStatementPass{}}, 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new ParallelizationPass{}}, max_optimization_level + 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new ValueRangePass{}}, 1);
+    passes.add_pass(std::unique_ptr<AsmPass>{new PeepholePass{}}, 1);
+    passes.add_pass(std::unique_ptr<AsmPass>{new SchedulingPass{}}, 2);
+    return passes;
+}
@@ -0,0 +1,409 @@
+/*
+Project: TUC
+File: peephole.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "peephole.hpp"
+
+// standard libraries
+#include <cstdint>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::Register;
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+    using tuc::AsmInstruction;
+    using OperandType = tuc::AsmOperand::OperandType;
+    using Liveness = std::vector<tuc::RegisterSet>;     // the registers live after each instruction
+
+    /*
+    A rule of the pattern library. `apply` tries to match the pattern starting at instruction `i` and, if it does,
+    rewrites the matched instructions and returns true.
+    */
+    class PeepholeRule {
+        public:
+            using Rewriter = bool (*)(tuc::AsmList& code, int i, const Liveness& liveAfter);
+
+            PeepholeRule(const std::string& _name, Rewriter _apply) : ruleName{_name}, rewriter{_apply} {}
+
+            std::string name() const noexcept {
+                return ruleName;
+            }
+
+            bool apply(tuc::AsmList& code, int i, const Liveness& liveAfter) const {
+                return rewriter(code, i, liveAfter);
+            }
+
+        private:
+            std::string ruleName;
+            Rewriter rewriter;
+    };
+
+    /*
+    computes the registers live after each instruction with a single backward pass; the code at the end of the list
+    (or reached by a jump) is assumed to use every register but not the flags, which generated code never keeps
+    across a block boundary
+    */
+    Liveness compute_liveness(const tuc::AsmList& code) {
+        auto liveAfter = Liveness(code.size());
+        auto live = tuc::RegisterSet{}.set().reset(tuc::flags_bit);
+        for (int i = code.size() - 1; i >= 0; i--) {
+            if (tuc::is_exit(code[i]) || code[i].opcode() == AsmOpcode::RET)   // neither returns to the next instruction
+                live.reset();
+            liveAfter[i] = live;
+            live = (live & ~tuc::registers_written(code[i])) | tuc::registers_read(code[i]);
+        }
+        return liveAfter;
+    }
+
+    bool is_live(const Liveness& liveAfter, int i, Register r) {
+        return liveAfter[i].test(static_cast<int>(r));
+    }
+
+    bool flags_live(const Liveness& liveAfter, int i) {
+        return liveAfter[i].test(tuc::flags_bit);
+    }
+
+    bool is_register(const AsmOperand& o) {
+        return o.type() == OperandType::REGISTER;
+    }
+
+    bool is_immediate(const AsmOperand& o) {
+        return o.type() == OperandType::IMMEDIATE;
+    }
+
+    bool matches(const tuc::AsmList& code, int i, AsmOpcode opcode, int operandCount) {
+        return i < static_cast<int>(code.size()) && code[i].opcode() == opcode && code[i].operand_count() == operandCount;
+    }
+
+    AsmInstruction make(AsmOpcode opcode, std::vector<AsmOperand> operands) {
+        return AsmInstruction{opcode, std::move(operands)};
+    }
+
+    /*
+    returns true if register `r` is used by an instruction, explicitly or implicitly
+    */
+    bool references(const AsmInstruction& instruction, Register r) {
+        auto bit = static_cast<int>(r);
+        return tuc::registers_read(instruction).test(bit) || tuc::registers_written(instruction).test(bit);
+    }
+
+    /*
+    returns the 32-bit result of applying an instruction with an immediate (or no) source to a known value, or false
+    if the instruction cannot be evaluated
+    */
+    bool evaluate(const AsmInstruction& instruction, std::int32_t value, std::int32_t& result) {
+        auto u = static_cast<std::uint32_t>(value);
+        auto src = instruction.operand_count() > 1 ? instruction.operand(1) : AsmOperand{};
+        auto k = static_cast<std::uint32_t>(src.value());
+        switch (instruction.opcode()) {
+        case AsmOpcode::ADD:    if (!is_immediate(src)) return false; u += k; break;
+        case AsmOpcode::SUB:    if (!is_immediate(src)) return false; u -= k; break;
+        case AsmOpcode::IMUL:   if (instruction.operand_count() != 2 || !is_immediate(src)) return false; u *= k; break;
+        case AsmOpcode::SHL:    if (!is_immediate(src)) return false; u <<= (k & 31); break;
+        case AsmOpcode::SHR:    if (!is_immediate(src)) return false; u >>= (k & 31); break;
+        case AsmOpcode::SAR:    if (!is_immediate(src)) return false; u = static_cast<std::uint32_t>(value >> (k & 31)); break;
+        case AsmOpcode::NEG:    u = 0u - u; break;
+        case AsmOpcode::LEA:
+            if (src.type() != OperandType::MEMORY || src.base() != instruction.operand(0).base() ||
+                !src.has_index() || src.index() != src.base())
+                return false;
+            u = u + u * static_cast<std::uint32_t>(src.scale()) + static_cast<std::uint32_t>(src.value());
+            break;
+        default:
+            return false;
+        }
+        result = static_cast<std::int32_t>(u);
+        return true;
+    }
+
+    /*
+    `mov r, r` does nothing
+    */
+    bool self_move(tuc::AsmList& code, int i, const Liveness&) {
+        if (matches(code, i, AsmOpcode::MOV, 2) && is_register(code[i].operand(0)) && code[i].operand(0) == code[i].operand(1)) {
+            code.erase(code.begin() + i);
+            return true;
+        }
+        return false;
+    }
+
+    /*
+    an instruction without side effects whose results are never read can be removed (e.g. the result of a statement
+    that is overwritten by the next one)
+    */
+    bool dead_definition(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        auto written = tuc::registers_written(code[i]);
+        if (code[i].opcode() != AsmOpcode::LABEL && !tuc::has_side_effects(code[i]) && written.any() &&
+            (written & liveAfter[i]).none()) {
+            code.erase(code.begin() + i);
+            return true;
+        }
+        return false;
+    }
+
+    /*
+    `mov r, K1; op r, K2` computes a constant: `mov r, K1 op K2` (only 32-bit operations are evaluated)
+    */
+    bool constant_fold(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        if (!matches(code, i, AsmOpcode::MOV, 2) || !is_register(code[i].operand(0)) || !is_immediate(code[i].operand(1)) ||
+            i + 1 >= static_cast<int>(code.size()) || code[i + 1].operand_count() == 0 ||
+            code[i].size() != 4 || code[i + 1].size() != 4 ||
+            code[i + 1].operand(0) != code[i].operand(0) || flags_live(liveAfter, i + 1))
+            return false;
+
+        auto result = std::int32_t{0};
+        if (!evaluate(code[i + 1], static_cast<std::int32_t>(code[i].operand(1).value()), result))
+            return false;
+        code[i] = make(AsmOpcode::MOV, {code[i].operand(0), AsmOperand::imm(result)});
+        code.erase(code.begin() + i + 1);
+        return true;
+    }
+
+    /*
+    `add r, 0`, `sub r, 0`, `imul r, 1`, and shifts by 0 do nothing (other than setting flags)
+    */
+    bool identity_arithmetic(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        if (code[i].operand_count() != 2 || !is_register(code[i].operand(0)) || !is_immediate(code[i].operand(1)) ||
+            flags_live(liveAfter, i))
+            return false;
+
+        auto k = code[i].operand(1).value();
+        auto opcode = code[i].opcode();
+        if (((opcode == AsmOpcode::ADD || opcode == AsmOpcode::SUB || opcode == AsmOpcode::SHL || opcode == AsmOpcode::SHR ||
+              opcode == AsmOpcode::SAR) && k == 0) || (opcode == AsmOpcode::IMUL && k == 1)) {
+            code.erase(code.begin() + i);
+            return true;
+        }
+        return false;
+    }
+
+    /*
+    `mov r, 0` is longer than `xor r, r`
+    */
+    bool zero_idiom(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        if (matches(code, i, AsmOpcode::MOV, 2) && is_register(code[i].operand(0)) && is_immediate(code[i].operand(1)) &&
+            code[i].operand(1).value() == 0 && !flags_live(liveAfter, i)) {
+            code[i] = make(AsmOpcode::XOR, {code[i].operand(0), code[i].operand(0)});
+            return true;
+        }
+        return false;
+    }
+
+    /*
+    `push a; pop b` is `mov b, a` (or nothing if `a` and `b` are the same register)
+    */
+    bool push_pop(tuc::AsmList& code, int i, const Liveness&) {
+        if (!matches(code, i, AsmOpcode::PUSH, 1) || !matches(code, i + 1, AsmOpcode::POP, 1) ||
+            !is_register(code[i].operand(0)) || !is_register(code[i + 1].operand(0)))
+            return false;
+
+        if (code[i].operand(0) == code[i + 1].operand(0)) {
+            code.erase(code.begin() + i, code.begin() + i + 2);
+        }
+        else {
+            code[i] = make(AsmOpcode::MOV, {code[i + 1].operand(0), code[i].operand(0)});
+            code.erase(code.begin() + i + 1);
+        }
+        return true;
+    }
+
+    /*
+    `mov a, b; op c, a` where `a` is not used afterwards is `op c, b` (the first move then becomes dead); `b` may be
+    a register or an immediate (when both instructions have the same operand size, and only into a `mov` if the
+    immediate does not fit in 32 bits)
+    */
+    bool copy_forward(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        if (!matches(code, i, AsmOpcode::MOV, 2) || !is_register(code[i].operand(0)) ||
+            !(is_register(code[i].operand(1)) || is_immediate(code[i].operand(1))) ||
+            i + 1 >= static_cast<int>(code.size()) || code[i + 1].operand_count() != 2)
+            return false;
+
+        auto a = code[i].operand(0);
+        auto b = code[i].operand(1);
+        const auto& next = code[i + 1];
+        auto opcode = next.opcode();
+        auto explicitSource = opcode == AsmOpcode::MOV || opcode == AsmOpcode::ADD || opcode == AsmOpcode::SUB ||
+                              opcode == AsmOpcode::IMUL || opcode == AsmOpcode::XOR;
+        if (!explicitSource || next.operand(1) != a || next.operand(0) == a || is_live(liveAfter, i + 1, a.base()) ||
+            next.size() != code[i].size())
+            return false;
+        if (is_immediate(b) && opcode != AsmOpcode::MOV && static_cast<std::int32_t>(b.value()) != b.value())
+            return false;
+
+        // `a` must not be used to address memory
+        if (next.operand(0).type() == OperandType::MEMORY &&
+            (next.operand(0).base() == a.base() || (next.operand(0).has_index() && next.operand(0).index() == a.base())))
+            return false;
+
+        code[i + 1].operand(1) = b;
+        return true;
+    }
+
+    /*
+    `mov b, a; mov a, K; sub a, b` is `neg a; add a, K` when `b` is not used afterwards, and `mov b, K; sub b, a` is
+    `neg a; add a, K` when `a` is not used afterwards (the result is then in `a` so `b` is renamed to `a` until it is
+    redefined)
+    */
+    bool reverse_subtract(tuc::AsmList& code, int i, const Liveness& liveAfter) {
+        auto n = static_cast<int>(code.size());
+
+        if (matches(code, i, AsmOpcode::MOV, 2) && matches(code, i + 1, AsmOpcode::MOV, 2) && matches(code, i + 2, AsmOpcode::SUB, 2)) {
+            auto b = code[i].operand(0);
+            auto a = code[i].operand(1);
+            if (is_register(a) && is_register(b) && a != b && code[i + 1].operand(0) == a && is_immediate(code[i + 1].operand(1)) &&
+                code[i + 2].operand(0) == a && code[i + 2].operand(1) == b && !is_live(liveAfter, i + 2, b.base()) &&
+                !flags_live(liveAfter, i + 2)) {
+                auto k = code[i + 1].operand(1);
+                code[i] = make(AsmOpcode::NEG, {a});
+                code[i + 1] = make(AsmOpcode::ADD, {a, k});
+                code.erase(code.begin() + i + 2);
+                return true;
+            }
+        }
+
+        if (matches(code, i, AsmOpcode::MOV, 2) && matches(code, i + 1, AsmOpcode::SUB, 2)) {
+            auto b = code[i].operand(0);
+            auto k = code[i].operand(1);
+            auto a = code[i + 1].operand(1);
+            if (!is_register(b) || !is_immediate(k) || !is_register(a) || a == b || code[i + 1].operand(0) != b ||
+                is_live(liveAfter, i + 1, a.base()) || flags_live(liveAfter, i + 1))
+                return false;
+
+            // find the instructions using `b` before it is redefined; `a` must be free for all of them
+            auto renamed = std::vector<int>{};
+            auto j = i + 2;
+            for (; j < n && is_live(liveAfter, j - 1, b.base()); j++) {
+                const auto& instruction = code[j];
+                if (instruction.opcode() == AsmOpcode::LABEL || references(instruction, a.base()))
+                    return false;
+                if (references(instruction, b.base())) {
+                    // only explicit register operands can be renamed
+                    for (int o = 0, c = instruction.operand_count(); o < c; o++) {
+                        if (instruction.operand(o).type() == OperandType::MEMORY)
+                            return false;
+                    }
+                    auto implicit = instruction;
+                    for (int o = 0, c = implicit.operand_count(); o < c; o++) {
+                        if (implicit.operand(o) == b)
+                            implicit.operand(o) = a;
+                    }
+                    if (references(implicit, b.base()))
+                        return false;
+                    renamed.push_back(j);
+                }
+            }
+            if (j == n)
+                return false;
+
+            for (auto r : renamed) {
+                for (int o = 0, c = code[r].operand_count(); o < c; o++) {
+                    if (code[r].operand(o) == b)
+                        code[r].operand(o) = a;
+                }
+            }
+            code[i] = make(AsmOpcode::NEG, {a});
+            code[i + 1] = make(AsmOpcode::ADD, {a, k});
+            return true;
+        }
+
+        return false;
+    }
+
+    /*
+    the pattern library, in the order the rules are tried
+    */
+    const auto peepholeRules = std::vector<PeepholeRule>{
+        PeepholeRule{"self-move", self_move},
+        PeepholeRule{"dead-definition", dead_definition},
+        PeepholeRule{"constant-fold", constant_fold},
+        PeepholeRule{"identity-arithmetic", identity_arithmetic},
+        PeepholeRule{"push-pop", push_pop},
+        PeepholeRule{"copy-forward", copy_forward},
+        PeepholeRule{"reverse-subtract", reverse_subtract},
+        PeepholeRule{"zero-idiom", zero_idiom}
+    };
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the names of the rules in the peephole optimizer's pattern library
+*/
+std::vector<std::string> tuc::peephole_rule_names() {
+    auto names = std::vector<std::string>{};
+    for (const auto& rule : peepholeRules)
+        names.push_back(rule.name());
+    return names;
+}
+
+/*
+rewrites wasteful instruction sequences in `code` until none of the rules apply anymore
+
+The code is scanned backward so that, when a rule rewrites some instructions, the liveness information of the
+instructions that follow them is still valid. Liveness is recomputed after every rewrite.
+*/
+tuc::PeepholeStats tuc::peephole_optimize(AsmList& code) {
+    auto stats = PeepholeStats{};
+    for (const auto& rule : peepholeRules)
+        stats[rule.name()] = 0;
+
+    auto changed = true;
+    while (changed) {
+        changed = false;
+        auto liveAfter = compute_liveness(code);
+        for (int i = code.size() - 1; i >= 0; i--) {
+            if (i >= static_cast<int>(code.size()))
+                continue;
+            for (const auto& rule : peepholeRules) {
+                if (rule.apply(code, i, liveAfter)) {
+                    stats[rule.name()]++;
+                    changed = true;
+                    liveAfter = compute_liveness(code);
+                    break;
+                }
+            }
+        }
+    }
+
+    return stats;
+}
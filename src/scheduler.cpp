@@ -0,0 +1,475 @@
+/*
+Project: TUC
+File: scheduler.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "scheduler.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::Register;
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+    using tuc::AsmInstruction;
+    using OperandType = tuc::AsmOperand::OperandType;
+
+    const int registerCount = 16;   // the general purpose registers (the flags are ordered by `add_flag_dependences()`)
+    const int issueWidth = 4;       // the instructions a core can start in the same cycle
+
+    /*
+    An edge of the dependence graph: an instruction cannot be issued until `latency` cycles after `other` (its
+    predecessor) or before its successor `other`. Instructions are numbered from the start of their region.
+    */
+    struct Dependence {
+        int other;
+        int latency;
+    };
+
+    struct DependenceGraph {
+        std::vector<std::vector<Dependence>> predecessors;
+        std::vector<std::vector<Dependence>> successors;
+
+        void add(int from, int to, int latency) {
+            predecessors[to].push_back(Dependence{from, latency});
+            successors[from].push_back(Dependence{to, latency});
+        }
+    };
+
+    bool reads_memory(const AsmInstruction& instruction) {
+        if (instruction.opcode() == AsmOpcode::LEA || instruction.opcode() == AsmOpcode::LABEL)
+            return false;
+        if (instruction.opcode() == AsmOpcode::POP)
+            return true;
+        for (int i = 0, count = instruction.operand_count(); i < count; i++) {
+            if (instruction.operand(i).type() == OperandType::MEMORY)
+                return true;
+        }
+        return false;
+    }
+
+    /*
+    returns true if the instruction ends a region that can be scheduled: control flow, labels (which it may reach), and
+    reserved data
+    */
+    bool is_region_boundary(const AsmInstruction& instruction) {
+        auto opcode = instruction.opcode();
+        return opcode == AsmOpcode::LABEL || opcode == AsmOpcode::JMP || opcode == AsmOpcode::JE || opcode == AsmOpcode::JNE ||
+               opcode == AsmOpcode::CALL || opcode == AsmOpcode::RET || opcode == AsmOpcode::RESERVE || tuc::is_exit(instruction);
+    }
+
+    /*
+    returns the registers live after a region: those read by the exit system call or the return if it ends the
+    region, or all of them if the region ends with a jump, a label, or the end of the code
+    */
+    tuc::RegisterSet live_after_region(const tuc::AsmList& code, int last) {
+        if (last < static_cast<int>(code.size()) && (tuc::is_exit(code[last]) || code[last].opcode() == AsmOpcode::RET))
+            return tuc::registers_read(code[last]);
+        return tuc::RegisterSet{}.set();
+    }
+
+    /*
+    returns true if the instruction ending a region reads the flags set in the region, like the `je` after a `cmp`
+    */
+    bool flags_live_after_region(const tuc::AsmList& code, int last) {
+        return last < static_cast<int>(code.size()) && tuc::registers_read(code[last]).test(tuc::flags_bit);
+    }
+
+    AsmInstruction rename_register(AsmInstruction instruction, Register from, Register to) {
+        auto renamed = [&](Register r) { return r == from ? to : r; };
+        for (int i = 0, count = instruction.operand_count(); i < count; i++) {
+            auto& o = instruction.operand(i);
+            if (o.type() == OperandType::REGISTER)
+                o = AsmOperand::reg(renamed(o.base()));
+            else if (o.type() == OperandType::MEMORY && o.has_index())
+                o = AsmOperand::mem(renamed(o.base()), renamed(o.index()), o.scale(), o.value());
+            else if (o.type() == OperandType::MEMORY)
+                o = AsmOperand::mem(renamed(o.base()), o.value());
+        }
+        return instruction;
+    }
+
+    bool accesses(const AsmInstruction& instruction, Register r) {
+        return tuc::registers_read(instruction).test(static_cast<int>(r)) ||
+               tuc::registers_written(instruction).test(static_cast<int>(r));
+    }
+
+    /*
+    Gives new registers to the values of a region whose registers were used before them, so that the scheduler is not
+    held back by the register allocator reusing registers as soon as they are free. A value (from the instruction
+    defining its register to the next one) is moved to a register that is not used in the meantime and whose
+    content is not needed; values in registers used implicitly (e.g. by `idiv`) stay where they are.
+    */
+    void rename_values(tuc::AsmList& region, tuc::RegisterSet liveOut) {
+        static const Register renamable[] = {Register::AX, Register::CX, Register::DX, Register::BX, Register::SI, Register::DI};
+        auto size = static_cast<int>(region.size());
+        for (int i = 0; i < size; i++) {
+            for (auto r : renamable) {
+                auto bit = static_cast<int>(r);
+                if (!tuc::registers_written(region[i]).test(bit) || tuc::registers_read(region[i]).test(bit))
+                    continue;
+
+                // the value lives until the next instruction defining `r` without reading it
+                auto end = i + 1;
+                while (end < size && !(tuc::registers_written(region[end]).test(bit) && !tuc::registers_read(region[end]).test(bit)))
+                    end++;
+                auto usedBefore = false;
+                for (int j = 0; j < i; j++)
+                    usedBefore = usedBefore || accesses(region[j], r);
+                if (!usedBefore || (end == size && liveOut.test(bit)))
+                    continue;
+
+                // the registers whose content is needed at `end` (and so, if untouched, during the whole value)
+                auto live = liveOut;
+                for (int j = size - 1; j >= end; j--)
+                    live = (live & ~tuc::registers_written(region[j])) | tuc::registers_read(region[j]);
+
+                auto best = r;
+                auto bestLastAccess = size;
+                for (auto t : renamable) {
+                    if (t == r || live.test(static_cast<int>(t)))
+                        continue;
+                    auto lastAccess = -1;
+                    auto usable = true;
+                    for (int j = 0; j < end && usable; j++) {
+                        if (accesses(region[j], t)) {
+                            lastAccess = j;
+                            usable = j < i;
+                        }
+                    }
+                    for (int j = i; j < end && usable; j++)
+                        usable = !accesses(region[j], r) || !accesses(rename_register(region[j], r, t), r);
+                    if (usable && lastAccess < bestLastAccess) {
+                        best = t;
+                        bestLastAccess = lastAccess;
+                    }
+                }
+                if (best == r)
+                    continue;
+                for (int j = i; j < end; j++)
+                    region[j] = rename_register(region[j], r, best);
+            }
+        }
+    }
+
+    /*
+    adds the dependences through the flags to those of a region (`liveOut` tells if the instruction after the region
+    reads them)
+
+    Nearly every arithmetic instruction writes the flags, but only those of a `cmp` are ever read, so treating them
+    like a register would chain all the arithmetic of a region together. Instead, only the flags that are read are
+    protected: the instructions writing the flags keep their place before the instruction whose flags are read or after
+    the last instruction reading them (the end of the region if they are live after it).
+    */
+    void add_flag_dependences(const tuc::AsmList& region, bool liveOut, DependenceGraph& dependences) {
+        auto size = static_cast<int>(region.size());
+        auto writers = std::vector<int>{};
+        for (int i = 0; i < size; i++) {
+            if (tuc::registers_written(region[i]).test(tuc::flags_bit))
+                writers.push_back(i);
+        }
+
+        auto writer = -1;       // the last instruction writing the flags (-1 if they were set before the region)
+        auto lastReader = -1;   // the last instruction reading the flags it wrote
+        auto protect = [&](int end) {
+            for (auto other : writers) {
+                if (other < writer)
+                    dependences.add(other, writer, 0);
+                else if (other > end)
+                    dependences.add(end, other, 0);
+            }
+        };
+        for (int i = 0; i < size; i++) {
+            if (tuc::registers_read(region[i]).test(tuc::flags_bit)) {
+                if (writer >= 0)
+                    dependences.add(writer, i, tuc::instruction_latency(region[writer]));
+                lastReader = i;
+            }
+            if (tuc::registers_written(region[i]).test(tuc::flags_bit)) {
+                if (lastReader >= 0)
+                    protect(lastReader);
+                writer = i;
+                lastReader = -1;
+            }
+        }
+        if (liveOut && lastReader >= 0)
+            protect(lastReader);
+        else if (liveOut && writer >= 0)
+            protect(size);
+    }
+
+    /*
+    returns the dependences between the instructions of a region (`flagsLiveOut` tells if the instruction after it reads
+    the flags)
+
+    Besides the dependences through registers (a read after a write waits for the result; a write after a read or
+    another write only has to come later) and the flags that are read, instructions that access memory or may trap keep
+    their relative order.
+    */
+    DependenceGraph region_dependences(const tuc::AsmList& region, bool flagsLiveOut) {
+        auto size = static_cast<int>(region.size());
+        auto dependences = DependenceGraph{};
+        dependences.predecessors.resize(size);
+        dependences.successors.resize(size);
+        int lastWriter[registerCount];
+        std::vector<int> readersSinceWrite[registerCount];
+        std::fill(lastWriter, lastWriter + registerCount, -1);
+        auto lastOrdered = -1;
+
+        for (int i = 0; i < size; i++) {
+            auto read = tuc::registers_read(region[i]);
+            auto written = tuc::registers_written(region[i]);
+            for (int r = 0; r < registerCount; r++) {
+                if (read.test(r) && lastWriter[r] >= 0)
+                    dependences.add(lastWriter[r], i, tuc::instruction_latency(region[lastWriter[r]]));
+            }
+            for (int r = 0; r < registerCount; r++) {
+                if (!written.test(r))
+                    continue;
+                if (lastWriter[r] >= 0)
+                    dependences.add(lastWriter[r], i, 1);
+                for (auto reader : readersSinceWrite[r])
+                    dependences.add(reader, i, 0);
+                lastWriter[r] = i;
+                readersSinceWrite[r].clear();
+            }
+            for (int r = 0; r < registerCount; r++) {
+                if (read.test(r) && !written.test(r))
+                    readersSinceWrite[r].push_back(i);
+            }
+            if (tuc::has_side_effects(region[i]) || reads_memory(region[i])) {
+                if (lastOrdered >= 0)
+                    dependences.add(lastOrdered, i, 0);
+                lastOrdered = i;
+            }
+        }
+        add_flag_dependences(region, flagsLiveOut, dependences);
+        return dependences;
+    }
+
+    std::vector<int> original_order(const tuc::AsmList& region) {
+        auto order = std::vector<int>(region.size());
+        for (int i = 0, size = region.size(); i < size; i++)
+            order[i] = i;
+        return order;
+    }
+
+    /*
+    returns the cycles taken by the instructions of a region in the given order on a core issuing up to `issueWidth`
+    instructions per cycle in order, an instruction waiting until its operands are ready (and holding back the ones
+    after it)
+    */
+    int region_cycles(const tuc::AsmList& region, const DependenceGraph& dependences, const std::vector<int>& order) {
+        auto issue = std::vector<int>(order.size(), 0);
+        auto cycle = 0;
+        auto issued = 0;    // in the current cycle
+        auto end = 0;
+        for (auto i : order) {
+            auto ready = cycle;
+            for (const auto& d : dependences.predecessors[i])
+                ready = std::max(ready, issue[d.other] + d.latency);
+            if (ready > cycle || issued == issueWidth) {
+                cycle = std::max(ready, cycle + 1);
+                issued = 0;
+            }
+            issue[i] = cycle;
+            issued++;
+            end = std::max(end, cycle + tuc::instruction_latency(region[i]));
+        }
+        return end;
+    }
+
+    /*
+    returns a new order for the instructions of a region, picking at each cycle the (up to `issueWidth`) ready
+    instructions with the longest chains of latencies after them (their height); ties keep the original order
+    */
+    std::vector<int> schedule_region(const tuc::AsmList& region, const DependenceGraph& dependences) {
+        auto size = static_cast<int>(region.size());
+        auto height = std::vector<int>(size, 0);
+        for (int i = size - 1; i >= 0; i--) {
+            height[i] = tuc::instruction_latency(region[i]);
+            for (const auto& d : dependences.successors[i])
+                height[i] = std::max(height[i], d.latency + height[d.other]);
+        }
+
+        auto waitingFor = std::vector<int>(size, 0);    // unscheduled predecessors
+        auto earliest = std::vector<int>(size, 0);      // cycle at which the operands are ready
+        for (int i = 0; i < size; i++)
+            waitingFor[i] = dependences.predecessors[i].size();
+
+        auto order = std::vector<int>{};
+        auto cycle = 0;
+        auto issued = 0;    // in the current cycle
+        while (static_cast<int>(order.size()) < size) {
+            auto best = -1;
+            auto firstReady = -1;
+            for (int i = 0; i < size; i++) {
+                if (waitingFor[i] != 0)
+                    continue;
+                if (firstReady < 0 || earliest[i] < earliest[firstReady])
+                    firstReady = i;
+                if (earliest[i] <= cycle && (best < 0 || height[i] > height[best]))
+                    best = i;
+            }
+            if (best < 0 || issued == issueWidth) {
+                // nothing else can be issued in this cycle: wait for the next instruction to be ready
+                cycle = best < 0 ? earliest[firstReady] : cycle + 1;
+                issued = 0;
+                continue;
+            }
+
+            order.push_back(best);
+            waitingFor[best] = -1;
+            for (const auto& d : dependences.successors[best]) {
+                waitingFor[d.other]--;
+                earliest[d.other] = std::max(earliest[d.other], cycle + d.latency);
+            }
+            issued++;
+        }
+        return order;
+    }
+
+    /*
+    calls `f(region, last)` for each region of the code, where `last` is the index of the instruction ending it
+    */
+    template <typename Function>
+    void for_each_region(const tuc::AsmList& code, Function f) {
+        for (int first = 0, count = code.size(); first <= count; ) {
+            auto last = first;
+            while (last < count && !is_region_boundary(code[last]))
+                last++;
+            f(tuc::AsmList(code.begin() + first, code.begin() + last), last);
+            first = last + 1;
+        }
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the number of cycles before the result of an instruction can be used (from a table of typical latencies on
+recent x86 cores)
+*/
+int tuc::instruction_latency(const AsmInstruction& instruction) {
+    auto latency = 1;
+    switch (instruction.opcode()) {
+    case AsmOpcode::IMUL:   latency = 3; break;
+    case AsmOpcode::IDIV:
+    case AsmOpcode::DIV:    latency = 26; break;
+    case AsmOpcode::POP:    latency = 4; break;
+    case AsmOpcode::LABEL:  latency = 0; break;
+    default:                break;
+    }
+    auto store = instruction.operand_count() > 1 && instruction.operand(0).type() == OperandType::MEMORY;
+    if (instruction.opcode() != AsmOpcode::POP && reads_memory(instruction) && !store)
+        latency += 4;       // a load from the L1 cache
+    return latency;
+}
+
+/*
+returns the number of cycles a core issuing a few instructions per cycle, in order, would take to run `code` straight
+through
+*/
+int tuc::estimate_cycles(const AsmList& code) {
+    auto cycles = 0;
+    for_each_region(code, [&](const AsmList& region, int last) {
+        auto dependences = region_dependences(region, flags_live_after_region(code, last));
+        cycles += region_cycles(region, dependences, original_order(region));
+        cycles += last < static_cast<int>(code.size()) ? 1 : 0;     // the boundary itself
+    });
+    return cycles;
+}
+
+/*
+reorders independent instructions so that long latencies overlap with other work; returns what was done
+
+The code is cut into regions at labels and control flow. In each region, values are first moved to other registers
+where that removes dependences created by the register allocator (see `rename_values()`), then the instructions are
+list scheduled over the dependence graph (see `schedule_region()`). A region is left as it was if the result is not
+estimated to be faster.
+*/
+tuc::ScheduleResult tuc::schedule_instructions(AsmList& code) {
+    auto moved = 0;
+    auto cyclesBefore = estimate_cycles(code);
+    auto scheduled = AsmList{};
+    for_each_region(code, [&](const AsmList& region, int last) {
+        auto flagsLive = flags_live_after_region(code, last);
+        auto renamed = region;
+        rename_values(renamed, live_after_region(code, last));
+        auto dependences = region_dependences(renamed, flagsLive);
+        auto order = schedule_region(renamed, dependences);
+        auto regionCycles = region_cycles(region, region_dependences(region, flagsLive), original_order(region));
+        if (region_cycles(renamed, dependences, order) < regionCycles) {
+            for (int p = 0, size = order.size(); p < size; p++) {
+                moved += order[p] != p;
+                scheduled.push_back(renamed[order[p]]);
+            }
+        }
+        else {
+            scheduled.insert(scheduled.end(), region.begin(), region.end());
+        }
+        if (last < static_cast<int>(code.size()))
+            scheduled.push_back(code[last]);
+    });
+    code = scheduled;
+    return ScheduleResult{moved, cyclesBefore, estimate_cycles(code)};
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::ScheduleResult::ScheduleResult(int _moved, int _cyclesBefore, int _cyclesAfter)
+: movedCount{_moved}, cyclesBefore{_cyclesBefore}, cyclesAfter{_cyclesAfter} {}
+
+int tuc::ScheduleResult::moved() const noexcept {
+    return movedCount;
+}
+
+int tuc::ScheduleResult::cycles_before() const noexcept {
+    return cyclesBefore;
+}
+
+int tuc::ScheduleResult::cycles_after() const noexcept {
+    return cyclesAfter;
+}
@@ -0,0 +1,196 @@
+/*
+Project: TUC
+File: strength_reduction.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "strength_reduction.hpp"
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::MultiplyStep::MultiplyStep(StepType _type, int _amount) : stepType{_type}, stepAmount{_amount} {}
+
+tuc::MultiplyStep::StepType tuc::MultiplyStep::type() const noexcept {
+    return stepType;
+}
+
+/*
+returns the shift count of a SHIFT or the scale factor of a SCALE
+*/
+int tuc::MultiplyStep::amount() const noexcept {
+    return stepAmount;
+}
+
+
+
+tuc::DivisionMagic::DivisionMagic(std::int32_t _multiplier, int _shift, int _correction)
+: magicMultiplier{_multiplier}, magicShift{_shift}, magicCorrection{_correction} {}
+
+std::int32_t tuc::DivisionMagic::multiplier() const noexcept {
+    return magicMultiplier;
+}
+
+int tuc::DivisionMagic::shift() const noexcept {
+    return magicShift;
+}
+
+/*
+returns 1 if the dividend must be added to the high part of the product, -1 if it must be subtracted from it, and 0 if
+no correction is needed
+*/
+int tuc::DivisionMagic::correction() const noexcept {
+    return magicCorrection;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns true if multiplying by `constant` can be done with fewer and faster instructions than an `imul`
+
+An `imul` has a latency of 3 cycles while shifts and `lea`s have a latency of 1, so a constant is considered cheap if
+it can be reached with at most two of them.
+*/
+bool tuc::is_cheap_multiply(std::int32_t constant) noexcept {
+    if (constant < 0)
+        return false;
+    if (constant == 0)
+        return true;
+
+    auto stepCount = 0;
+    if (constant % 2 == 0) {
+        stepCount++;
+        while (constant % 2 == 0)
+            constant /= 2;
+    }
+    for (auto factor : {9, 5, 3}) {
+        while (constant % factor == 0) {
+            stepCount++;
+            constant /= factor;
+        }
+    }
+    return constant == 1 && stepCount <= 2;
+}
+
+/*
+returns the sequence of shifts and scaled adds that multiply a value by `constant`
+*/
+std::vector<tuc::MultiplyStep> tuc::multiply_steps(std::int32_t constant) {
+    using StepType = MultiplyStep::StepType;
+    auto steps = std::vector<MultiplyStep>{};
+
+    if (constant == 0) {
+        steps.emplace_back(StepType::CLEAR, 0);
+        return steps;
+    }
+
+    auto shiftCount = 0;
+    while (constant % 2 == 0) {
+        shiftCount++;
+        constant /= 2;
+    }
+    for (auto factor : {9, 5, 3}) {
+        while (constant % factor == 0) {
+            steps.emplace_back(StepType::SCALE, factor);
+            constant /= factor;
+        }
+    }
+    if (shiftCount > 0)
+        steps.emplace_back(StepType::SHIFT, shiftCount);
+
+    return steps;
+}
+
+/*
+returns `k` if `constant` is 2^k (with k > 0), or -1 otherwise
+*/
+int tuc::power_of_two_exponent(std::int32_t constant) noexcept {
+    if (constant <= 1 || (constant & (constant - 1)) != 0)
+        return -1;
+    auto k = 0;
+    while ((constant >> k) != 1)
+        k++;
+    return k;
+}
+
+/*
+computes the magic number for signed division by `divisor` (which must not be -1, 0, or 1); this is the algorithm from
+Hacker's Delight, figure 10-1
+*/
+tuc::DivisionMagic tuc::division_magic(std::int32_t divisor) {
+    const std::uint32_t two31 = 0x80000000u;
+    const std::uint32_t ad = divisor < 0 ? 0u - static_cast<std::uint32_t>(divisor) : static_cast<std::uint32_t>(divisor);
+    const std::uint32_t t = two31 + (static_cast<std::uint32_t>(divisor) >> 31);
+    const std::uint32_t anc = t - 1 - t % ad;  // absolute value of nc
+    auto p = 31;
+    std::uint32_t q1 = two31 / anc;             // q1 = 2^p / |nc|
+    std::uint32_t r1 = two31 - q1 * anc;        // r1 = rem(2^p, |nc|)
+    std::uint32_t q2 = two31 / ad;              // q2 = 2^p / |d|
+    std::uint32_t r2 = two31 - q2 * ad;         // r2 = rem(2^p, |d|)
+    std::uint32_t delta = 0;
+
+    do {
+        p++;
+        q1 = 2 * q1;
+        r1 = 2 * r1;
+        if (r1 >= anc) {
+            q1++;
+            r1 -= anc;
+        }
+        q2 = 2 * q2;
+        r2 = 2 * r2;
+        if (r2 >= ad) {
+            q2++;
+            r2 -= ad;
+        }
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    auto magic = static_cast<std::uint32_t>(q2 + 1);
+    if (divisor < 0)
+        magic = 0u - magic;
+    auto multiplier = static_cast<std::int32_t>(magic);
+
+    auto correction = 0;
+    if (divisor > 0 && multiplier < 0)
+        correction = 1;
+    else if (divisor < 0 && multiplier > 0)
+        correction = -1;
+
+    return DivisionMagic{multiplier, p - 32, correction};
+}
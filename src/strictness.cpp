@@ -0,0 +1,204 @@
+/*
+Project: TUC
+File: strictness.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "strictness.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::IROpcode;
+    using CallSite = std::pair<int, tuc::ValueId>;      // a function and one of its calls
+
+    /*
+    returns the calls of each function of a program
+    */
+    std::vector<std::vector<CallSite>> call_sites(const tuc::IRProgram& program) {
+        auto callers = std::vector<std::vector<CallSite>>(program.size());
+        for (int f = 0, count = program.size(); f < count; f++) {
+            for (auto v : program[f].linear_order()) {
+                const auto& instruction = program[f].instruction(v);
+                if (instruction.opcode() == IROpcode::CALL)
+                    callers[instruction.immediate()].emplace_back(f, v);
+            }
+        }
+        return callers;
+    }
+
+    /*
+    returns the number of parameters of a function: one more than the last one its body gets or its callers pass
+    */
+    int parameter_count(const tuc::IRProgram& program, int index, const std::vector<CallSite>& calls) {
+        auto count = 0;
+        const auto& function = program[index];
+        for (auto v : function.linear_order()) {
+            const auto& instruction = function.instruction(v);
+            if (instruction.opcode() == IROpcode::PARAMETER)
+                count = std::max(count, instruction.immediate() + 1);
+        }
+        for (const auto& call : calls)
+            count = std::max(count, program[call.first].instruction(call.second).operand_count());
+        return count;
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+std::string tuc::StrictnessAnalysis::name() {
+    return "strictness";
+}
+
+/*
+The values a program evaluates are the ones with side effects (the instructions that may trap or transfer control,
+including every call) and, going backwards, the operands of the values it evaluates, except that a call only evaluates
+the arguments passed for strict parameters.  When a parameter turns out to be strict, the arguments passed for it by
+every call are evaluated too.
+*/
+tuc::StrictnessAnalysis::Result tuc::StrictnessAnalysis::run(const IRProgram& program) {
+    auto callers = call_sites(program);
+    auto result = Result{};
+    auto evaluated = std::vector<std::vector<bool>>{};
+    for (int f = 0, count = program.size(); f < count; f++) {
+        result.emplace_back(parameter_count(program, f, callers[f]), false);
+        evaluated.emplace_back(program[f].instruction_count(), false);
+    }
+
+    auto worklist = std::vector<std::pair<int, ValueId>>{};
+    auto evaluate = [&](int f, ValueId v) {
+        if (!evaluated[f][v]) {
+            evaluated[f][v] = true;
+            worklist.emplace_back(f, v);
+        }
+    };
+    for (int f = 0, count = program.size(); f < count; f++) {
+        for (auto v : program[f].linear_order()) {
+            if (has_side_effects(program[f], v))
+                evaluate(f, v);
+        }
+    }
+
+    while (!worklist.empty()) {
+        auto f = worklist.back().first;
+        auto v = worklist.back().second;
+        worklist.pop_back();
+        const auto& function = program[f];
+        const auto& instruction = function.instruction(v);
+        switch (instruction.opcode()) {
+        case IROpcode::PARAMETER: {
+            auto p = instruction.immediate();
+            if (result[f][p])
+                break;
+            result[f][p] = true;
+            for (const auto& call : callers[f]) {
+                if (p < program[call.first].instruction(call.second).operand_count())
+                    evaluate(call.first, program[call.first].operand(call.second, p));
+            }
+            break;
+        }
+        case IROpcode::CALL: {
+            const auto& strict = result[instruction.immediate()];
+            for (int i = 0, c = instruction.operand_count(); i < c; i++) {
+                if (strict[i])
+                    evaluate(f, function.operand(v, i));
+            }
+            break;
+        }
+        default:
+            for (int i = 0, c = instruction.operand_count(); i < c; i++)
+                evaluate(f, function.operand(v, i));
+            break;
+        }
+    }
+    return result;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+removes the parameters that are not strict from their functions and the arguments passed for them from every call;
+returns the number of parameters removed
+
+The strict parameters are renumbered in order.  The instructions getting a removed parameter become constants, since
+nothing that is evaluated uses them.  The entry point has no parameters.
+*/
+int tuc::eliminate_dead_arguments(IRProgram& program, const std::vector<std::vector<bool>>& strictness) {
+    auto removed = 0;
+    auto renumbered = std::vector<std::vector<int>>(program.size());
+    for (int f = 1, count = program.size(); f < count; f++) {
+        auto next = 0;
+        for (auto strict : strictness[f])
+            renumbered[f].push_back(strict ? next++ : -1);
+        removed += static_cast<int>(strictness[f].size()) - next;
+    }
+    if (removed == 0)
+        return 0;
+
+    for (int f = 0, count = program.size(); f < count; f++) {
+        auto& function = program[f];
+        for (auto v : function.linear_order()) {
+            const auto& instruction = function.instruction(v);
+            if (instruction.opcode() == IROpcode::PARAMETER) {
+                auto p = renumbered[f][instruction.immediate()];
+                if (p < 0)
+                    function.redefine(v, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+                else if (p != instruction.immediate())
+                    function.redefine(v, IROpcode::PARAMETER, IRType::INT32, {}, p);
+            }
+            else if (instruction.opcode() == IROpcode::CALL) {
+                auto callee = instruction.immediate();
+                auto arguments = std::vector<ValueId>{};
+                for (int i = 0, c = instruction.operand_count(); i < c; i++) {
+                    if (renumbered[callee][i] >= 0)
+                        arguments.push_back(function.operand(v, i));
+                }
+                if (static_cast<int>(arguments.size()) != instruction.operand_count())
+                    function.redefine(v, IROpcode::CALL, instruction.type(), arguments, callee);
+            }
+        }
+    }
+    return removed;
+}
@@ -0,0 +1,670 @@
+/*
+Project: TUC
+File: superoptimizer.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "superoptimizer.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+    using tuc::Register;
+
+    bool is_tree_operation(const tuc::IRFunction& function, tuc::ValueId value) {
+        auto opcode = function.instruction(value).opcode();
+        return opcode == tuc::IROpcode::ADD || opcode == tuc::IROpcode::SUBTRACT || opcode == tuc::IROpcode::MULTIPLY;
+    }
+
+    /*
+    Builds the key of a tree. The operands of commutative operations are first ordered by their description with all
+    inputs written as `$`, then the inputs are numbered in the order they appear.
+    */
+    class ShapeBuilder {
+        public:
+            ShapeBuilder(const tuc::IRFunction& _function, const std::vector<bool>& _inTree)
+            : function{_function}, inTree{_inTree} {}
+
+            std::string describe(tuc::ValueId value, bool anonymous) {
+                const auto& instruction = function.instruction(value);
+                if (instruction.opcode() == tuc::IROpcode::CONSTANT)
+                    return std::to_string(instruction.immediate());
+                if (!inTree[value]) {
+                    if (anonymous)
+                        return "$";
+                    auto input = std::find(inputs.begin(), inputs.end(), value);
+                    if (input == inputs.end())
+                        input = inputs.insert(inputs.end(), value);
+                    return "$" + std::to_string(input - inputs.begin());
+                }
+
+                auto left = function.operand(value, 0);
+                auto right = function.operand(value, 1);
+                if (instruction.opcode() != tuc::IROpcode::SUBTRACT && describe(right, true) < describe(left, true))
+                    std::swap(left, right);
+                auto l = describe(left, anonymous);
+                auto r = describe(right, anonymous);
+                return "(" + tuc::opcode_name(instruction.opcode()) + " " + l + " " + r + ")";
+            }
+
+            std::vector<tuc::ValueId> inputs;
+
+        private:
+            const tuc::IRFunction& function;
+            const std::vector<bool>& inTree;
+    };
+
+    /*
+    A node of a shape parsed back from its key.
+    */
+    struct ShapeNode {
+        enum class NodeType {INPUT, CONSTANT, OPERATION};
+
+        NodeType type;
+        std::string operation;
+        std::uint32_t value;    // the input number or the constant
+        std::unique_ptr<ShapeNode> left;
+        std::unique_ptr<ShapeNode> right;
+    };
+
+    std::unique_ptr<ShapeNode> parse_shape(std::istream& is) {
+        auto node = std::unique_ptr<ShapeNode>{new ShapeNode{}};
+        is >> std::ws;
+        if (is.peek() == '(') {
+            is.get();
+            node->type = ShapeNode::NodeType::OPERATION;
+            is >> node->operation;
+            node->left = parse_shape(is);
+            node->right = parse_shape(is);
+            is >> std::ws;
+            if (is.get() != ')')
+                is.setstate(std::ios::failbit);
+        }
+        else if (is.peek() == '$') {
+            is.get();
+            node->type = ShapeNode::NodeType::INPUT;
+            is >> node->value;
+        }
+        else {
+            auto value = std::int32_t{0};
+            is >> value;
+            node->type = ShapeNode::NodeType::CONSTANT;
+            node->value = static_cast<std::uint32_t>(value);
+        }
+        return node;
+    }
+
+    /*
+    evaluates a shape with 32-bit wrap around
+    */
+    std::uint32_t evaluate(const ShapeNode* node, const std::uint32_t* inputs) {
+        switch (node->type) {
+        case ShapeNode::NodeType::INPUT:    return inputs[node->value];
+        case ShapeNode::NodeType::CONSTANT: return node->value;
+        default:                            break;
+        }
+        auto l = evaluate(node->left.get(), inputs);
+        auto r = evaluate(node->right.get(), inputs);
+        if (node->operation == "add")
+            return l + r;
+        else if (node->operation == "sub")
+            return l - r;
+        else
+            return l * r;
+    }
+
+    /*
+    gathers the number of inputs, the number of operations, and the constants of a shape
+    */
+    void inspect(const ShapeNode* node, int& inputCount, int& operationCount, std::vector<std::uint32_t>& constants) {
+        if (node->type == ShapeNode::NodeType::INPUT) {
+            inputCount = std::max(inputCount, static_cast<int>(node->value) + 1);
+        }
+        else if (node->type == ShapeNode::NodeType::CONSTANT) {
+            if (std::find(constants.begin(), constants.end(), node->value) == constants.end())
+                constants.push_back(node->value);
+        }
+        else {
+            operationCount++;
+            inspect(node->left.get(), inputCount, operationCount, constants);
+            inspect(node->right.get(), inputCount, operationCount, constants);
+        }
+    }
+
+    // the registers sequences work with: the first input and the result, the second input, and a scratch register
+    const Register searchRegisters[] = {Register::AX, Register::CX, Register::DX};
+    const int searchRegisterCount = 3;
+
+    /*
+    An instruction the search can pick, in a form that is quick to execute: registers are indices in `searchRegisters`
+    and a negative source means the immediate value is used.
+    */
+    struct Candidate {
+        AsmOpcode opcode;
+        int dst;
+        int src;
+        std::uint32_t immediate;    // also the displacement of `lea`
+        int base;
+        int index;                  // negative if `lea` has no index
+        int scale;
+        int reads;                  // bit mask of the registers read
+
+        void execute(std::uint32_t* r) const {
+            auto source = src >= 0 ? r[src] : immediate;
+            switch (opcode) {
+            case AsmOpcode::MOV:    r[dst] = source; break;
+            case AsmOpcode::ADD:    r[dst] += source; break;
+            case AsmOpcode::SUB:    r[dst] -= source; break;
+            case AsmOpcode::IMUL:   r[dst] *= source; break;
+            case AsmOpcode::NEG:    r[dst] = 0u - r[dst]; break;
+            case AsmOpcode::SHL:    r[dst] <<= immediate; break;
+            case AsmOpcode::LEA:    r[dst] = r[base] + (index >= 0 ? r[index] * scale : 0u) + immediate; break;
+            default:                break;
+            }
+        }
+
+        tuc::AsmInstruction instruction() const {
+            auto d = AsmOperand::reg(searchRegisters[dst]);
+            auto s = src >= 0 ? AsmOperand::reg(searchRegisters[src])
+                              : AsmOperand::imm(static_cast<std::int32_t>(immediate));
+            switch (opcode) {
+            case AsmOpcode::NEG:
+                return tuc::AsmInstruction{opcode, {d}};
+            case AsmOpcode::LEA:
+                if (index < 0)
+                    return tuc::AsmInstruction{opcode, {d, AsmOperand::mem(searchRegisters[base], static_cast<std::int32_t>(immediate))}};
+                return tuc::AsmInstruction{opcode, {d, AsmOperand::mem(searchRegisters[base], searchRegisters[index], scale,
+                                                                      static_cast<std::int32_t>(immediate))}};
+            default:
+                return tuc::AsmInstruction{opcode, {d, s}};
+            }
+        }
+    };
+
+    /*
+    returns every instruction the search can pick for a shape with the given constants
+    */
+    std::vector<Candidate> candidates_for(const std::vector<std::uint32_t>& constants) {
+        auto immediates = std::vector<std::uint32_t>{};
+        for (auto c : constants) {
+            for (auto i : {c, 0u - c}) {
+                if (i != 0 && std::find(immediates.begin(), immediates.end(), i) == immediates.end())
+                    immediates.push_back(i);
+            }
+        }
+        auto bit = [](int r) { return 1 << r; };
+
+        auto candidates = std::vector<Candidate>{};
+        for (int d = 0; d < searchRegisterCount; d++) {
+            for (int s = 0; s < searchRegisterCount; s++) {
+                if (s != d)
+                    candidates.push_back(Candidate{AsmOpcode::MOV, d, s, 0, 0, -1, 1, bit(s)});
+                for (auto opcode : {AsmOpcode::ADD, AsmOpcode::SUB, AsmOpcode::IMUL}) {
+                    if (s != d || opcode != AsmOpcode::SUB)
+                        candidates.push_back(Candidate{opcode, d, s, 0, 0, -1, 1, bit(d) | bit(s)});
+                }
+            }
+            for (auto i : immediates) {
+                candidates.push_back(Candidate{AsmOpcode::MOV, d, -1, i, 0, -1, 1, 0});
+                candidates.push_back(Candidate{AsmOpcode::ADD, d, -1, i, 0, -1, 1, bit(d)});
+                if (i != 1 && i != ~0u)
+                    candidates.push_back(Candidate{AsmOpcode::IMUL, d, -1, i, 0, -1, 1, bit(d)});
+            }
+            candidates.push_back(Candidate{AsmOpcode::NEG, d, -1, 0, 0, -1, 1, bit(d)});
+            for (auto k = 1u; k < 32; k++)
+                candidates.push_back(Candidate{AsmOpcode::SHL, d, -1, k, 0, -1, 1, bit(d)});
+
+            auto displacements = immediates;
+            displacements.insert(displacements.begin(), 0u);
+            for (int b = 0; b < searchRegisterCount; b++) {
+                for (auto disp : displacements) {
+                    if (disp != 0)
+                        candidates.push_back(Candidate{AsmOpcode::LEA, d, -1, disp, b, -1, 1, bit(b)});
+                    for (int i = 0; i < searchRegisterCount; i++) {
+                        for (auto scale : {1, 2, 4, 8}) {
+                            if (scale != 1 || b <= i)     // [b + i] is the same as [i + b]
+                                candidates.push_back(Candidate{AsmOpcode::LEA, d, -1, disp, b, i, scale, bit(b) | bit(i)});
+                        }
+                    }
+                }
+            }
+        }
+        return candidates;
+    }
+
+    /*
+    Tries every sequence of `length` candidates on a few test inputs, then checks the sequences that pass on many more
+    (edge cases and random values). The registers holding the inputs are the only ones that can be read before they
+    are written, and the last instruction must write the result in eax.
+    */
+    class Search {
+        public:
+            Search(const ShapeNode* shape, int inputCount, std::vector<Candidate> _candidates)
+            : candidates{std::move(_candidates)} {
+                const std::uint32_t edges[] = {0u, 1u, 2u, 3u, 7u, 0xffffffffu, 0xfffffffeu, 0x7fffffffu, 0x80000000u,
+                                               0x55555555u, 0xaaaaaaaau, 0x12345678u};
+                auto generator = std::mt19937{2026};
+                for (int n = 0; n < 4096; n++)
+                    addTest(shape, generator(), generator());
+                for (auto a : edges) {
+                    for (auto b : edges)
+                        addTest(shape, a, b);
+                }
+                inputMask = inputCount > 1 ? 3 : 1;
+            }
+
+            bool run(int length, std::vector<Candidate>& found) {
+                sequence.assign(length, nullptr);
+                for (int t = 0; t < quickTestCount; t++)
+                    std::copy(tests[t].inputs, tests[t].inputs + searchRegisterCount, states[0][t]);
+                if (!extend(0, length, inputMask))
+                    return false;
+                found.clear();
+                for (auto c : sequence)
+                    found.push_back(*c);
+                return true;
+            }
+
+        private:
+            struct Test {
+                std::uint32_t inputs[searchRegisterCount];
+                std::uint32_t expected;
+            };
+
+            static const int quickTestCount = 8;
+            static const int maxLength = 8;
+
+            void addTest(const ShapeNode* shape, std::uint32_t a, std::uint32_t b) {
+                auto test = Test{{a, b, 0u}, 0u};
+                test.expected = evaluate(shape, test.inputs);
+                tests.push_back(test);
+            }
+
+            bool extend(int depth, int length, int defined) {
+                if (depth == length)
+                    return passes_all_tests();
+
+                for (const auto& c : candidates) {
+                    if ((c.reads & ~defined) != 0 || (depth == length - 1 && c.dst != 0))
+                        continue;
+                    auto passing = true;
+                    for (int t = 0; t < quickTestCount && passing; t++) {
+                        std::copy(states[depth][t], states[depth][t] + searchRegisterCount, states[depth + 1][t]);
+                        c.execute(states[depth + 1][t]);
+                        passing = depth < length - 1 || states[depth + 1][t][0] == tests[t].expected;
+                    }
+                    if (!passing)
+                        continue;
+                    sequence[depth] = &c;
+                    if (extend(depth + 1, length, defined | (1 << c.dst)))
+                        return true;
+                }
+                return false;
+            }
+
+            bool passes_all_tests() const {
+                for (const auto& test : tests) {
+                    std::uint32_t r[searchRegisterCount];
+                    std::copy(test.inputs, test.inputs + searchRegisterCount, r);
+                    for (auto c : sequence)
+                        c->execute(r);
+                    if (r[0] != test.expected)
+                        return false;
+                }
+                return true;
+            }
+
+            std::vector<Candidate> candidates;
+            std::vector<Test> tests;
+            int inputMask = 1;
+            std::vector<const Candidate*> sequence;
+            std::uint32_t states[maxLength + 1][quickTestCount][searchRegisterCount];
+    };
+
+    /*
+    parses an instruction printed in nasm syntax (only the forms found in superoptimizer tables); returns false if it
+    is not one of them
+    */
+    bool parse_instruction(const std::string& text, tuc::AsmInstruction& instruction) {
+        static const auto opcodes = std::map<std::string, AsmOpcode>{
+            {"mov", AsmOpcode::MOV}, {"add", AsmOpcode::ADD}, {"sub", AsmOpcode::SUB}, {"imul", AsmOpcode::IMUL},
+            {"neg", AsmOpcode::NEG}, {"xor", AsmOpcode::XOR}, {"shl", AsmOpcode::SHL}, {"shr", AsmOpcode::SHR},
+            {"sar", AsmOpcode::SAR}, {"lea", AsmOpcode::LEA}};
+        auto parse_register = [](const std::string& name, Register& r) {
+            for (auto candidate : {Register::AX, Register::CX, Register::DX, Register::BX, Register::SI, Register::DI}) {
+                if (tuc::register_name(candidate) == name) {
+                    r = candidate;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto is = std::istringstream{text};
+        auto mnemonic = std::string{};
+        is >> mnemonic;
+        if (opcodes.count(mnemonic) == 0)
+            return false;
+
+        auto operands = std::vector<AsmOperand>{};
+        auto operandText = std::string{};
+        while (std::getline(is >> std::ws, operandText, ',')) {
+            while (!operandText.empty() && std::isspace(operandText.back()))
+                operandText.pop_back();
+            auto r = Register::AX;
+            if (parse_register(operandText, r)) {
+                operands.push_back(AsmOperand::reg(r));
+            }
+            else if (operandText.size() > 2 && operandText.front() == '[' && operandText.back() == ']') {
+                auto terms = std::istringstream{operandText.substr(1, operandText.size() - 2)};
+                auto base = Register::AX;
+                auto index = Register::AX;
+                auto scale = 0;
+                auto displacement = std::int32_t{0};
+                auto sign = 1;
+                auto term = std::string{};
+                auto hasBase = false;
+                while (terms >> term) {
+                    auto star = term.find('*');
+                    if (term == "+" || term == "-")
+                        sign = term == "+" ? 1 : -1;
+                    else if (star != std::string::npos && parse_register(term.substr(0, star), index))
+                        scale = std::atoi(term.c_str() + star + 1);
+                    else if (!hasBase && parse_register(term, base))
+                        hasBase = true;
+                    else if (std::isdigit(term.front()))
+                        displacement = sign * std::atoi(term.c_str());
+                    else
+                        return false;
+                }
+                if (!hasBase)
+                    return false;
+                operands.push_back(scale > 0 ? AsmOperand::mem(base, index, scale, displacement) : AsmOperand::mem(base, displacement));
+            }
+            else {
+                auto end = std::size_t{0};
+                try {
+                    operands.push_back(AsmOperand::imm(std::stoll(operandText, &end)));
+                }
+                catch (const std::logic_error&) {
+                    return false;
+                }
+                if (end != operandText.size())
+                    return false;
+            }
+        }
+        if (operands.empty())
+            return false;
+        instruction = tuc::AsmInstruction{opcodes.at(mnemonic), operands};
+        return true;
+    }
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+finds the largest trees of additions, subtractions, and multiplications in a function that fit the limits above, from
+the last instruction to the first; the nodes of a tree that `accept`s its shape are not part of any other tree; returns
+the accepted shapes
+
+An operation is a node of the tree of its user if it is used only once, by an instruction of the same block. When the
+tree of an operation is too large or not accepted, its operands are tried as roots of smaller trees.
+*/
+std::vector<tuc::ExpressionShape> tuc::match_expression_shapes(const IRFunction& function,
+                                                               const std::function<bool(const ExpressionShape&)>& accept) {
+    auto useCount = std::vector<int>(function.instruction_count(), 0);
+    auto blockOf = std::vector<BlockId>(function.instruction_count(), -1);
+    auto userBlock = std::vector<BlockId>(function.instruction_count(), -1);
+    for (BlockId b = 0, count = function.block_count(); b < count; b++) {
+        for (auto v : function.block(b).instructions()) {
+            blockOf[v] = b;
+            for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++) {
+                useCount[function.operand(v, i)]++;
+                userBlock[function.operand(v, i)] = b;
+            }
+        }
+    }
+
+    auto shapes = std::vector<ExpressionShape>{};
+    auto absorbed = std::vector<bool>(function.instruction_count(), false);
+    auto order = function.linear_order();
+    for (auto position = order.rbegin(); position != order.rend(); position++) {
+        auto root = *position;
+        if (absorbed[root] || !is_tree_operation(function, root))
+            continue;
+
+        // gather the nodes of the tree, operands first
+        auto inTree = std::vector<bool>(function.instruction_count(), false);
+        auto nodes = std::vector<ValueId>{};
+        auto pending = std::vector<ValueId>{root};
+        while (!pending.empty() && static_cast<int>(nodes.size()) <= superoptimizer_max_operations) {
+            auto v = pending.back();
+            pending.pop_back();
+            inTree[v] = true;
+            nodes.insert(nodes.begin(), v);
+            for (int i = 0; i < 2; i++) {
+                auto operand = function.operand(v, i);
+                if (is_tree_operation(function, operand) && useCount[operand] == 1 && userBlock[operand] == blockOf[root])
+                    pending.push_back(operand);
+            }
+        }
+        if (nodes.size() < 2 || static_cast<int>(nodes.size()) > superoptimizer_max_operations)
+            continue;
+
+        auto builder = ShapeBuilder{function, inTree};
+        auto key = builder.describe(root, false);
+        if (builder.inputs.empty() || static_cast<int>(builder.inputs.size()) > superoptimizer_max_inputs)
+            continue;
+
+        auto shape = ExpressionShape{key, root, builder.inputs, nodes};
+        if (accept(shape)) {
+            for (auto v : nodes)
+                absorbed[v] = true;
+            shapes.push_back(shape);
+        }
+    }
+    return shapes;
+}
+
+/*
+looks for the shortest sequence of at most `maxLength` instructions (and fewer than the operations of the shape)
+computing `shape`; returns false if there is none
+
+Every sequence is tried, shortest first, so the cost grows very quickly with the length; this is meant to be done once,
+offline, with the results kept in a table. A sequence is accepted when it gives the right result for thousands of
+inputs, including edge cases. This is not a proof, but the candidate instructions only compute polynomials of their
+inputs, and two different polynomials of such a low degree rarely agree on that many values.
+*/
+bool tuc::superoptimize(const std::string& shape, AsmList& sequence, int maxLength) {
+    auto is = std::istringstream{shape};
+    auto tree = parse_shape(is);
+    if (!is)
+        return false;
+
+    auto inputCount = 0;
+    auto operationCount = 0;
+    auto constants = std::vector<std::uint32_t>{};
+    inspect(tree.get(), inputCount, operationCount, constants);
+    if (inputCount < 1 || inputCount > superoptimizer_max_inputs)
+        return false;
+
+    auto search = Search{tree.get(), inputCount, candidates_for(constants)};
+    auto found = std::vector<Candidate>{};
+    for (int length = 1; length < operationCount && length <= maxLength; length++) {
+        if (search.run(length, found)) {
+            sequence.clear();
+            for (const auto& c : found)
+                sequence.push_back(c.instruction());
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+superoptimizes the shapes of a program that are not in the table yet and adds them to it; returns the number of shapes
+added
+*/
+int tuc::superoptimize_program(const IRProgram& program, SuperoptimizerTable& table, int maxLength) {
+    auto added = 0;
+    for (const auto& function : program) {
+        match_expression_shapes(function, [&](const ExpressionShape& shape) {
+            if (!table.contains(shape.key())) {
+                auto sequence = AsmList{};
+                if (!superoptimize(shape.key(), sequence, maxLength))
+                    sequence.clear();
+                table.insert(shape.key(), sequence);
+                added++;
+            }
+            return table.lookup(shape.key()) != nullptr;
+        });
+    }
+    return added;
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::ExpressionShape::ExpressionShape(std::string _key, ValueId _root, std::vector<ValueId> _inputs, std::vector<ValueId> _nodes)
+: shapeKey{std::move(_key)}, rootValue{_root}, inputValues{std::move(_inputs)}, nodeValues{std::move(_nodes)} {}
+
+std::string tuc::ExpressionShape::key() const noexcept {
+    return shapeKey;
+}
+
+tuc::ValueId tuc::ExpressionShape::root() const noexcept {
+    return rootValue;
+}
+
+/*
+returns the values standing for `$0` and `$1`
+*/
+const std::vector<tuc::ValueId>& tuc::ExpressionShape::inputs() const noexcept {
+    return inputValues;
+}
+
+/*
+returns the operations of the tree, the root last
+*/
+const std::vector<tuc::ValueId>& tuc::ExpressionShape::nodes() const noexcept {
+    return nodeValues;
+}
+
+
+
+/*
+reads a table from a file; a missing file is an empty table
+*/
+tuc::SuperoptimizerTable tuc::SuperoptimizerTable::load(const std::string& filePath) {
+    auto table = SuperoptimizerTable{};
+    auto file = std::ifstream{filePath};
+    auto line = std::string{};
+    for (auto lineNumber = 1u; std::getline(file, line); lineNumber++) {
+        if (line.empty() || line.front() == '#')
+            continue;
+
+        auto equals = line.find(" = ");
+        if (equals == std::string::npos)
+            throw CompilerException::InvalidTable{filePath, lineNumber, "expected `<shape> = <instructions>`"};
+        auto shape = line.substr(0, equals);
+        auto sequence = AsmList{};
+        auto is = std::istringstream{line.substr(equals + 3)};
+        auto text = std::string{};
+        while (std::getline(is >> std::ws, text, ';')) {
+            if (text == "-")
+                continue;
+            auto instruction = AsmInstruction{AsmOpcode::MOV};
+            if (!parse_instruction(text, instruction))
+                throw CompilerException::InvalidTable{filePath, lineNumber, "`" + text + "` is not a valid instruction"};
+            sequence.push_back(instruction);
+        }
+        table.insert(shape, sequence);
+    }
+    return table;
+}
+
+void tuc::SuperoptimizerTable::save(const std::string& filePath) const {
+    auto file = std::ofstream{filePath};
+    file << "# tuc superoptimizer table: <shape> = <instructions> (inputs in eax and ecx, result in eax)\n";
+    for (const auto& entry : sequences) {
+        file << entry.first << " = ";
+        if (entry.second.empty())
+            file << "-";
+        for (int i = 0, count = entry.second.size(); i < count; i++)
+            file << (i > 0 ? "; " : "") << entry.second[i];
+        file << "\n";
+    }
+}
+
+bool tuc::SuperoptimizerTable::contains(const std::string& shape) const {
+    return sequences.count(shape) > 0;
+}
+
+/*
+returns the sequence of a shape, or null if none is known
+*/
+const tuc::AsmList* tuc::SuperoptimizerTable::lookup(const std::string& shape) const {
+    auto entry = sequences.find(shape);
+    if (entry == sequences.end() || entry->second.empty())
+        return nullptr;
+    return &entry->second;
+}
+
+/*
+adds a shape to the table; an empty sequence means nothing shorter is known
+*/
+void tuc::SuperoptimizerTable::insert(const std::string& shape, const AsmList& sequence) {
+    sequences[shape] = sequence;
+}
+
+int tuc::SuperoptimizerTable::size() const noexcept {
+    return sequences.size();
+}
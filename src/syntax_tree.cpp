@@ -38,6 +38,112 @@ THE SOFTWARE.
 #include "syntax_tree.hpp"
 #include "compiler_exceptions.hpp"
 
+// standard libraries
+#include <unordered_set>
+#include <algorithm>
+#include <utility>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+    using NameSet = std::unordered_set<std::string>;
+
+    /*
+    returns true if a value expression can be applied to arguments: a name on its own or a call (which takes the
+    arguments that follow it)
+    */
+    bool is_applicable(const tuc::SyntaxNode* node) {
+        return (node->type() == NodeType::IDENTIFIER && node->child_count() == 0) || node->type() == NodeType::CALL;
+    }
+
+    /*
+    appends an argument to a call, turning a name on its own into a call first
+    */
+    void append_argument(std::unique_ptr<tuc::SyntaxNode>& call, std::unique_ptr<tuc::SyntaxNode>&& argument) {
+        if (call->type() == NodeType::IDENTIFIER)
+            call = std::make_unique<tuc::SyntaxNode>(NodeType::CALL, call->text());
+        call->append_child(std::move(argument));
+    }
+
+    /*
+    returns the number of parameters of a function of the given type: the number of types before the arrows (e.g. 2
+    for `int int -> int` and for `int -> int -> int`, 0 for `int`)
+    */
+    int parameter_count(const tuc::SyntaxNode* type) {
+        if (type->type() != NodeType::MAPTO)
+            return 0;
+        auto count = parameter_count(type->child(1));
+        for (auto t = type->child(0); t != nullptr; t = t->child_count() > 0 ? t->child(0) : nullptr)
+            count++;
+        return count;
+    }
+
+    /*
+    adds the function declared (`f : int -> int`) or defined (`f x = x + 1`) by a statement to the symbol table and
+    the names of the defined functions
+
+    A function may be declared and defined (once each) but the two must agree on the number of parameters.
+    */
+    void add_symbol(const tuc::SyntaxNode* statement, tuc::SymbolTable& symbols, NameSet& defined) {
+        auto count = 0;
+        auto name = static_cast<const tuc::SyntaxNode*>(nullptr);
+        if (statement->type() == NodeType::HASTYPE && statement->child(0)->type() == NodeType::IDENTIFIER) {
+            name = statement->child(0);
+            count = parameter_count(statement->child(1));
+        }
+        else if (statement->type() == NodeType::ASSIGN) {
+            if (!is_applicable(statement->child(0)))
+                throw tuc::CompilerException::UnimplementedFeature{statement->position(), "definitions of expressions",
+                    "only functions (a name followed by the names of its parameters) can be defined"};
+            name = statement->child(0);
+            count = name->child_count();
+            auto seen = NameSet{};
+            for (int i = 0; i < count; i++) {
+                auto parameter = name->child(i);
+                if (parameter->type() != NodeType::IDENTIFIER || parameter->child_count() > 0)
+                    throw tuc::CompilerException::UnimplementedFeature{parameter->position(), "patterns in definitions",
+                        "the parameters of `" + name->value() + "` can only be names"};
+                if (!seen.insert(parameter->value()).second)
+                    throw tuc::CompilerException::Redefinition{parameter->text()};
+            }
+            if (!defined.insert(name->value()).second)
+                throw tuc::CompilerException::Redefinition{name->text()};
+        }
+        else {
+            return;
+        }
+
+        auto symbol = symbols.find(name->value());
+        if (symbol == symbols.end())
+            symbols.emplace(name->value(), tuc::Symbol{tuc::Symbol::SymbolType::FUNCTION, name->value(), count});
+        else if (symbol->second.arg_count() != count)
+            throw tuc::CompilerException::ArgumentCountMismatch{name->text(), symbol->second.arg_count(), count};
+    }
+
+    /*
+    throws if an expression uses a name that is neither one of `parameters` nor a function of `defined`, or calls a
+    function with the wrong number of arguments
+    */
+    void check_uses(const tuc::SyntaxNode* node, const tuc::SymbolTable& symbols, const NameSet& defined,
+                    const std::vector<std::string>& parameters) {
+        if (node->type() == NodeType::IDENTIFIER || node->type() == NodeType::CALL) {
+            auto argumentCount = node->type() == NodeType::CALL ? node->child_count() : 0;
+            auto isParameter = std::find(parameters.cbegin(), parameters.cend(), node->value()) != parameters.cend();
+            auto symbol = symbols.find(node->value());
+            if (!isParameter && (symbol == symbols.end() || defined.count(node->value()) == 0))
+                throw tuc::CompilerException::UnknownSymbol{node->text()};
+            auto parameterCount = isParameter ? 0 : symbol->second.arg_count();
+            if (argumentCount != parameterCount)
+                throw tuc::CompilerException::ArgumentCountMismatch{node->text(), parameterCount, argumentCount};
+        }
+        for (int i = 0, count = node->child_count(); i < count; i++)
+            check_uses(node->child(i), symbols, defined, parameters);
+    }
+}
+
 
 
 //~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -200,6 +306,10 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
     auto operatorStack = std::vector<tuc::Token>{};
     auto tempValueExpression = std::unique_ptr<tuc::SyntaxNode>{};  // a temporary node for a value expression
                                                                     // (combination of literals, types, and identifiers)
+    auto pendingCalls = std::vector<std::pair<std::unique_ptr<tuc::SyntaxNode>, std::size_t>>{};
+                                                                    // calls waiting for a parenthesized argument, with
+                                                                    // the size of the operator stack before its `(`
+    auto defined = NameSet{};
 
     auto popTokenToNodeStack = [&](){
         auto t = operatorStack.back();
@@ -216,7 +326,11 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
 
     for (const auto& token: tokenList) {
         if (token.type() == tuc::TokenType::INTEGER || token.type() == tuc::TokenType::IDENTIFIER || token.type() == tuc::TokenType::TYPE) {
-            if (tempValueExpression) {
+            if (tempValueExpression && is_applicable(tempValueExpression.get()) && token.type() != tuc::TokenType::TYPE) {
+                // juxtaposition applies a function to its arguments (`f x 2`)
+                append_argument(tempValueExpression, std::make_unique<tuc::SyntaxNode>(token));
+            }
+            else if (tempValueExpression) {
                 auto newNode = std::make_unique<tuc::SyntaxNode>(token);
                 newNode->append_child(std::move(tempValueExpression));
                 tempValueExpression = std::move(newNode);
@@ -224,7 +338,8 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
             else
                 tempValueExpression = std::make_unique<tuc::SyntaxNode>(token);
         }
-        else if (token.is_operator() || token.type() == tuc::TokenType::HASTYPE || token.type() == tuc::TokenType::MAPTO) {
+        else if (token.is_operator() || token.type() == tuc::TokenType::HASTYPE || token.type() == tuc::TokenType::MAPTO ||
+                 token.type() == tuc::TokenType::ASSIGN) {
             if (tempValueExpression)
                 nodeStack.push_back(std::move(tempValueExpression));
             while(!operatorStack.empty() && (
@@ -235,6 +350,8 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
             operatorStack.push_back(token);
         }
         else if (token.type() == tuc::TokenType::LPAREN) {
+            if (tempValueExpression && is_applicable(tempValueExpression.get()))
+                pendingCalls.emplace_back(std::move(tempValueExpression), operatorStack.size());
             operatorStack.push_back(token);
         }
         else if (token.type() == tuc::TokenType::RPAREN) {
@@ -246,6 +363,14 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
                     throw tuc::CompilerException::MismatchedParenthesis{token.text()};
             }
             operatorStack.pop_back();
+
+            // a parenthesized expression following a function is one of its arguments (`f (x + 1)`)
+            if (!pendingCalls.empty() && pendingCalls.back().second == operatorStack.size()) {
+                tempValueExpression = std::move(pendingCalls.back().first);
+                pendingCalls.pop_back();
+                append_argument(tempValueExpression, std::move(nodeStack.back()));
+                nodeStack.pop_back();
+            }
         }
         else if (token.type() == tuc::TokenType::SEMICOL) {
             if (tempValueExpression)
@@ -255,6 +380,7 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
                     throw tuc::CompilerException::MismatchedParenthesis{operatorStack.back().text()};
                 popTokenToNodeStack();
             }
+            add_symbol(nodeStack.back().get(), symTable, defined);
             treeRoot->append_child(std::move(nodeStack.back()));
             nodeStack.clear();
         }
@@ -262,3 +388,29 @@ std::tuple<std::unique_ptr<tuc::SyntaxNode>, tuc::SymbolTable> tuc::gen_syntax_t
 
     return std::make_tuple(std::move(treeRoot), symTable);
 }
+
+/*
+throws if an expression of a program uses a symbol that is neither a defined function nor a parameter of the function
+it is in, or calls a function with the wrong number of arguments
+
+Functions can be used before they are defined, so this is only checked once the whole program is parsed.
+*/
+void tuc::check_symbols(const SyntaxNode* root, const SymbolTable& symTable) {
+    auto symbols = SymbolTable{};
+    auto defined = NameSet{};
+    for (int i = 0, count = root->child_count(); i < count; i++)
+        add_symbol(root->child(i), symbols, defined);
+
+    for (int i = 0, count = root->child_count(); i < count; i++) {
+        auto statement = root->child(i);
+        auto parameters = std::vector<std::string>{};
+        if (statement->type() == NodeType::ASSIGN) {
+            for (int p = 0, c = statement->child(0)->child_count(); p < c; p++)
+                parameters.push_back(statement->child(0)->child(p)->value());
+            check_uses(statement->child(1), symTable, defined, parameters);
+        }
+        else if (statement->type() != NodeType::HASTYPE) {
+            check_uses(statement, symTable, defined, parameters);
+        }
+    }
+}
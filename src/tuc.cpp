@@ -3,7 +3,7 @@ Project: TUC
 File: tuc.cpp
 Author: Leonardo Banderali
 Created: August 7, 2015
-Last Modified: November 8, 2015
+Last Modified: October 18, 2026
 
 Description:
     TUC is a simple, experimental compiler designed for learning and experimenting.
@@ -38,7 +38,14 @@ THE SOFTWARE.
 #include "compiler_exceptions.hpp"
 #include "lexer.hpp"
 #include "syntax_tree.hpp"
+#include "ir_generator.hpp"
 #include "asm_generator.hpp"
+#include "pass_manager.hpp"
+#include "x86_encoder.hpp"
+#include "elf_writer.hpp"
+#include "jit.hpp"
+#include "bytecode.hpp"
+#include "c_generator.hpp"
 
 // c++ standard libraries
 #include <memory>
@@ -47,42 +54,197 @@ THE SOFTWARE.
 #include <string>
 #include <tuple>
 #include <list>
+#include <vector>
+#include <cctype>
+#include <csignal>
+#include <algorithm>
+
+// POSIX headers
+#include <sys/stat.h>
 
 
 
 int main(int argc, char** argv) {
-    if (argc == 3) {
-        try {
+    try {
+        auto passes = tuc::standard_pipeline();
+        auto printStatistics = false;   // print what each optimization pass did
+        auto superoptimizerTablePath = std::string{};
+        auto superoptimize = false;     // add the shapes of the program that are not in the table to it
+        auto outputFormat = std::string{};  // `asm`, `object`, `executable`, or `c` (see `--output-format`)
+        auto outputPath = std::string{};
+        auto jit = false;               // run the program in-process and print its result instead of writing a file
+        auto writePerfMap = false;      // write the symbols of the JIT'd code for `perf`
+        auto interpret = false;         // run the program's bytecode and print its result instead of compiling it
+        auto memoized = std::vector<std::string>{};     // the functions whose results are cached (`--memoize <name>`)
+        auto arguments = std::vector<std::string>{};
+        for (int i = 1; i < argc; i++) {
+            auto argument = std::string{argv[i]};
+            if (argument.size() == 3 && argument.compare(0, 2, "-O") == 0 && std::isdigit(argument[2]))
+                passes.set_level(argument[2] - '0');
+            else if (argument.compare(0, 9, "--enable-") == 0)
+                passes.set_enabled(argument.substr(9), true);
+            else if (argument.compare(0, 10, "--disable-") == 0)
+                passes.set_enabled(argument.substr(10), false);
+            else if (argument == "--param" && i + 1 < argc) {
+                auto parameter = std::string{argv[++i]};
+                auto equals = parameter.find('=');
+                if (equals == std::string::npos)
+                    throw tuc::CompilerException::InvalidOption{parameter, "parameters must be given as <name>=<value>"};
+                try {
+                    passes.set_parameter(parameter.substr(0, equals), std::stoi(parameter.substr(equals + 1)));
+                }
+                catch (const std::logic_error&) {   // not a number
+                    throw tuc::CompilerException::InvalidOption{parameter, "the value of a parameter must be an integer"};
+                }
+            }
+            else if (argument == "--stats")
+                printStatistics = true;
+            else if (argument == "--superoptimizer-table" && i + 1 < argc)
+                superoptimizerTablePath = argv[++i];
+            else if (argument == "--superoptimize")
+                superoptimize = true;
+            else if (argument == "--dump-ranges")
+                passes.set_parameter("value-ranges-dump", 1);
+            else if (argument == "-m32")
+                passes.set_target(tuc::Target::X86);
+            else if (argument == "-m64")
+                passes.set_target(tuc::Target::X86_64);
+            else if (argument == "--output-format" && i + 1 < argc) {
+                outputFormat = argv[++i];
+                if (outputFormat != "asm" && outputFormat != "object" && outputFormat != "executable" && outputFormat != "c")
+                    throw tuc::CompilerException::InvalidOption{outputFormat, "the output format must be `asm`, `object`, `executable`, or `c`"};
+            }
+            else if (argument == "-o" && i + 1 < argc)
+                outputPath = argv[++i];
+            else if (argument == "--jit")
+                jit = true;
+            else if (argument == "--perf-map")
+                writePerfMap = true;
+            else if (argument == "--interpret")
+                interpret = true;
+            else if (argument == "--memoize" && i + 1 < argc)
+                memoized.push_back(argv[++i]);
+            else if (argument == "--workers" && i + 1 < argc) {
+                try {
+                    passes.set_worker_count(std::stoi(argv[++i]));
+                }
+                catch (const std::logic_error&) {   // not a number
+                    throw tuc::CompilerException::InvalidOption{argv[i], "the number of worker threads must be an integer"};
+                }
+            }
+            else if (argument.size() > 1 && argument[0] == '-')
+                throw tuc::CompilerException::InvalidOption{argument, "the option is not recognized"};
+            else
+                arguments.push_back(argument);
+        }
+
+        if (superoptimize && superoptimizerTablePath.empty())
+            throw tuc::CompilerException::InvalidOption{"--superoptimize", "a table must be given with `--superoptimizer-table <file>`"};
+        auto superoptimizerTable = tuc::SuperoptimizerTable{};
+        if (!superoptimizerTablePath.empty()) {
+            superoptimizerTable = tuc::SuperoptimizerTable::load(superoptimizerTablePath);
+            passes.set_superoptimizer_table(&superoptimizerTable);
+        }
+
+        // `tuc <source> -o <program>` builds a program, `tuc <source> <file>` prints its assembly code by default
+        if (!outputPath.empty()) {
+            arguments.push_back(outputPath);
+            if (outputFormat.empty())
+                outputFormat = "executable";
+        }
+        if (outputFormat.empty())
+            outputFormat = "asm";
+
+        // the JIT runs the program in this process, which only x86-64 code can do
+        if (jit && (!outputPath.empty() || outputFormat != "asm"))
+            throw tuc::CompilerException::InvalidOption{"--jit", "a JIT'd program is run, not written to a file"};
+        if (interpret && (jit || !outputPath.empty() || outputFormat != "asm"))
+            throw tuc::CompilerException::InvalidOption{"--interpret", "an interpreted program is neither compiled nor written to a file"};
+        if (writePerfMap && !jit)
+            throw tuc::CompilerException::InvalidOption{"--perf-map", "perf maps are only written for JIT'd code (`--jit`)"};
+        if (jit)
+            passes.set_target(tuc::Target::X86_64);
+
+        if (arguments.size() == (jit || interpret ? 1 : 2)) {
             // tokenize the text from the input file
-            auto tokens = tuc::lex_analyze(argv[1]);
+            auto tokens = tuc::lex_analyze(arguments[0]);
 
             // generate a syntax tree
             auto syntaxTreeRoot = std::make_unique<tuc::SyntaxNode>(tuc::SyntaxNode::NodeType::UNKNOWN);
             auto symbolTable = tuc::SymbolTable{};
             std::tie(syntaxTreeRoot, symbolTable) = tuc::gen_syntax_tree(tokens);
-
-            // generate the asembly code
-            auto outputASM = std::ostringstream{};
-            outputASM << "section .text\nglobal _start\n\n_start:\n";
+            tuc::check_symbols(syntaxTreeRoot.get(), symbolTable);
 
             //std::cout << syntaxTreeRoot;    // useful for debugging
 
-            for (int i = 0, count = syntaxTreeRoot->child_count(); i < count; i++) {
-                auto n = syntaxTreeRoot->child(i);
-                //std::cout << n;             // useful for debugging
-                outputASM << tuc::gen_expr_asm(n, symbolTable);
+            // run the bytecode of the program and print the value it exits with, trapping like the native code does
+            if (interpret) {
+                auto exitValue = std::int32_t{};
+                if (!tuc::run_bytecode(tuc::gen_bytecode(syntaxTreeRoot.get()), exitValue))
+                    std::raise(SIGFPE);
+                std::cout << exitValue << "\n";
+                return 0;
             }
 
-            outputASM << "\nmov ebx, eax\nmov eax, 1\nint 80h\n";
+            // the C code is lowered from the syntax tree and left for a C compiler to optimize
+            if (outputFormat == "c") {
+                auto outputFile = std::ofstream{arguments[1]};
+                outputFile << tuc::gen_program_c(syntaxTreeRoot.get());
+                outputFile.close();
+                return 0;
+            }
 
-            // print the asembly code to a file
-            auto outputFile = std::ofstream{argv[2]};
-            outputFile << outputASM.str();
-            outputFile.close();
-        }
-        catch (const tuc::CompilerException::AbstractError& e) {
-            std::cout << e.message();
-            return e.error_code();
+            // lower the syntax tree to the intermediate representation
+            auto program = tuc::gen_ir(syntaxTreeRoot.get(), symbolTable);
+            for (const auto& name : memoized) {
+                auto function = std::find_if(program.begin() + 1, program.end(), [&](const tuc::IRFunction& f) {
+                    return f.name() == name;
+                });
+                if (function == program.end())
+                    throw tuc::CompilerException::InvalidOption{"--memoize " + name, "the program has no function named `" + name + "`"};
+                function->set_memoized(true);
+            }
+
+            // optimize the program and generate its instructions
+            passes.optimize(program);
+            if (superoptimize && tuc::superoptimize_program(program, superoptimizerTable) > 0)
+                superoptimizerTable.save(superoptimizerTablePath);
+            auto code = passes.gen_code(program);
+            if (printStatistics)
+                passes.print_statistics(std::cerr);
+
+            //std::cout << program;           // useful for debugging
+
+            // run the program and print the value it exits with, or print the asembly code (or write the object file
+            // or the executable) to a file
+            if (jit) {
+                const tuc::JitProgram jitProgram{code};
+                if (writePerfMap) {
+                    auto perfMap = std::ofstream{tuc::perf_map_path(), std::ios::app};
+                    jitProgram.write_perf_map(perfMap);
+                }
+                std::cout << jitProgram.run() << "\n";
+            }
+            else if (outputFormat == "object" || outputFormat == "executable") {
+                auto machineCode = tuc::encode_instructions(code, passes.target());
+                auto outputFile = std::ofstream{arguments[1], std::ios::binary};
+                if (outputFormat == "object")
+                    outputFile << tuc::gen_elf_object(machineCode, passes.target());
+                else
+                    outputFile << tuc::gen_elf_executable(machineCode, passes.target());
+                outputFile.close();
+                if (outputFormat == "executable")
+                    chmod(arguments[1].c_str(), 0755);
+            }
+            else {
+                auto outputFile = std::ofstream{arguments[1]};
+                outputFile << tuc::gen_program_asm(code, passes.target());
+                outputFile.close();
+            }
         }
     }
+    catch (const tuc::CompilerException::AbstractError& e) {
+        std::cout << e.message();
+        return e.error_code();
+    }
 }
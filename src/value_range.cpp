@@ -0,0 +1,266 @@
+/*
+Project: TUC
+File: value_range.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+// project headers
+#include "value_range.hpp"
+
+// standard libraries
+#include <algorithm>
+#include <iomanip>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::ValueRange;
+
+    /*
+    returns a mask of the high bits that are the same in every value from `min` to `max` (as unsigned numbers, so
+    `min` and `max` must have the same sign)
+    */
+    std::uint32_t common_prefix_mask(std::uint32_t min, std::uint32_t max) {
+        auto mask = ~std::uint32_t{0};
+        for (auto differing = min ^ max; differing != 0; differing >>= 1)
+            mask <<= 1;
+        return mask;
+    }
+
+    ValueRange add(const ValueRange& a, const ValueRange& b) {
+        auto r = ValueRange::between(std::int64_t{a.min()} + b.min(), std::int64_t{a.max()} + b.max());
+        return r.with_trailing_zeros(std::min(a.trailing_zeros(), b.trailing_zeros()));
+    }
+
+    ValueRange subtract(const ValueRange& a, const ValueRange& b) {
+        auto r = ValueRange::between(std::int64_t{a.min()} - b.max(), std::int64_t{a.max()} - b.min());
+        return r.with_trailing_zeros(std::min(a.trailing_zeros(), b.trailing_zeros()));
+    }
+
+    ValueRange multiply(const ValueRange& a, const ValueRange& b) {
+        const std::int64_t products[] = {std::int64_t{a.min()} * b.min(), std::int64_t{a.min()} * b.max(),
+                                         std::int64_t{a.max()} * b.min(), std::int64_t{a.max()} * b.max()};
+        auto r = ValueRange::between(*std::min_element(std::begin(products), std::end(products)),
+                                     *std::max_element(std::begin(products), std::end(products)));
+        return r.with_trailing_zeros(std::min(32, a.trailing_zeros() + b.trailing_zeros()));
+    }
+
+    /*
+    returns the range of a division that does not trap (the executions that trap produce no value)
+
+    For a fixed dividend, the quotient only gets larger in magnitude as the divisor gets closer to 0 on either side,
+    so the extremes are found by dividing the bounds of the dividend by the bounds of the divisor and by the divisors
+    closest to 0 (1 and -1) when they are in its interval.
+    */
+    ValueRange divide(const ValueRange& a, const ValueRange& b) {
+        auto divisors = std::vector<std::int64_t>{};
+        for (auto d : {std::int64_t{b.min()}, std::int64_t{b.max()}, std::int64_t{-1}, std::int64_t{1}}) {
+            if (d != 0 && b.min() <= d && d <= b.max())
+                divisors.push_back(d);
+        }
+        if (divisors.empty())
+            return ValueRange{};    // the division always traps
+
+        auto min = std::numeric_limits<std::int64_t>::max();
+        auto max = std::numeric_limits<std::int64_t>::min();
+        for (auto d : divisors) {
+            for (auto n : {std::int64_t{a.min()}, std::int64_t{a.max()}}) {
+                min = std::min(min, n / d);
+                max = std::max(max, n / d);
+            }
+        }
+        return ValueRange::between(min, max);
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::ValueRange tuc::ValueRange::constant(std::int32_t value) {
+    return between(value, value);
+}
+
+/*
+returns the range of the values from `min` to `max`, or any value if they do not fit in 32 bits
+
+The bits that do not change between `min` and `max` are known when the two have the same sign.
+*/
+tuc::ValueRange tuc::ValueRange::between(std::int64_t min, std::int64_t max) {
+    auto range = ValueRange{};
+    if (min < std::numeric_limits<std::int32_t>::min() || max > std::numeric_limits<std::int32_t>::max())
+        return range;
+
+    range.minValue = static_cast<std::int32_t>(min);
+    range.maxValue = static_cast<std::int32_t>(max);
+    if ((min < 0) == (max < 0)) {
+        auto mask = common_prefix_mask(static_cast<std::uint32_t>(min), static_cast<std::uint32_t>(max));
+        range.knownOnes = static_cast<std::uint32_t>(min) & mask;
+        range.knownZeros = ~static_cast<std::uint32_t>(min) & mask;
+    }
+    return range;
+}
+
+std::int32_t tuc::ValueRange::min() const noexcept {
+    return minValue;
+}
+
+std::int32_t tuc::ValueRange::max() const noexcept {
+    return maxValue;
+}
+
+/*
+returns the bits that are 0 in every value of the range
+*/
+std::uint32_t tuc::ValueRange::known_zeros() const noexcept {
+    return knownZeros;
+}
+
+/*
+returns the bits that are 1 in every value of the range
+*/
+std::uint32_t tuc::ValueRange::known_ones() const noexcept {
+    return knownOnes;
+}
+
+/*
+returns the number of low bits known to be 0
+*/
+int tuc::ValueRange::trailing_zeros() const noexcept {
+    auto count = 0;
+    while (count < 32 && (knownZeros >> count & 1) != 0)
+        count++;
+    return count;
+}
+
+bool tuc::ValueRange::contains(std::int32_t value) const noexcept {
+    return minValue <= value && value <= maxValue && (static_cast<std::uint32_t>(value) & knownZeros) == 0 &&
+           (static_cast<std::uint32_t>(value) & knownOnes) == knownOnes;
+}
+
+bool tuc::ValueRange::is_non_negative() const noexcept {
+    return minValue >= 0;
+}
+
+/*
+returns the range with its `count` low bits known to be 0
+
+The bounds are rounded inward to multiples of 2^count so that they stay values of the range.
+*/
+tuc::ValueRange tuc::ValueRange::with_trailing_zeros(int count) const {
+    if (count <= 0 || (knownOnes & ((std::uint64_t{1} << count) - 1)) != 0)
+        return *this;
+
+    auto range = *this;
+    auto step = std::int64_t{1} << count;
+    auto roundUp = [&](std::int64_t v) { return v >= 0 ? (v + step - 1) / step * step : -(-v / step * step); };
+    auto roundDown = [&](std::int64_t v) { return v >= 0 ? v / step * step : -((-v + step - 1) / step * step); };
+    auto min = roundUp(minValue);
+    auto max = roundDown(maxValue);
+    if (min > max)
+        return *this;   // cannot happen for a non empty range of multiples
+
+    range.minValue = static_cast<std::int32_t>(min);
+    range.maxValue = static_cast<std::int32_t>(max);
+    range.knownZeros |= static_cast<std::uint32_t>(step - 1);
+    return range;
+}
+
+
+
+std::string tuc::ValueRangeAnalysis::name() {
+    return "value-range";
+}
+
+tuc::ValueRangeAnalysis::Result tuc::ValueRangeAnalysis::run(const IRProgram& program) {
+    auto result = Result{};
+    for (const auto& function : program) {
+        auto ranges = std::vector<ValueRange>(function.instruction_count());
+        for (auto v : function.linear_order()) {
+            const auto& instruction = function.instruction(v);
+            auto operandRange = [&](int i) { return ranges[function.operand(v, i)]; };
+            switch (instruction.opcode()) {
+            case IROpcode::CONSTANT:    ranges[v] = ValueRange::constant(instruction.immediate()); break;
+            case IROpcode::ADD:         ranges[v] = add(operandRange(0), operandRange(1)); break;
+            case IROpcode::SUBTRACT:    ranges[v] = subtract(operandRange(0), operandRange(1)); break;
+            case IROpcode::MULTIPLY:    ranges[v] = multiply(operandRange(0), operandRange(1)); break;
+            case IROpcode::DIVIDE:      ranges[v] = divide(operandRange(0), operandRange(1)); break;
+            default:                    break;
+            }
+        }
+        result.push_back(std::move(ranges));
+    }
+    return result;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns true if a division with operands in the given ranges may divide by 0 or overflow
+*/
+bool tuc::division_may_trap(const ValueRange& dividend, const ValueRange& divisor) noexcept {
+    return divisor.contains(0) || (dividend.contains(std::numeric_limits<std::int32_t>::min()) && divisor.contains(-1));
+}
+
+/*
+prints the range of every integer value of a program (for debugging)
+*/
+void tuc::dump_value_ranges(std::ostream& os, const IRProgram& program, const std::vector<std::vector<ValueRange>>& ranges) {
+    for (int f = 0, count = program.size(); f < count; f++) {
+        const auto& function = program[f];
+        os << "value ranges of " << function.name() << ":\n";
+        for (auto v : function.linear_order()) {
+            if (function.instruction(v).type() == IRType::INT32)
+                os << "    %" << v << " = " << opcode_name(function.instruction(v).opcode()) << ": " << ranges[f][v] << "\n";
+        }
+    }
+}
+
+
+
+//~overloaded functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+puts a textual representation of a range (its interval and known bits) in an output stream
+*/
+std::ostream& operator<< (std::ostream& os, const tuc::ValueRange& range) {
+    os << "[" << range.min() << ", " << range.max() << "]";
+    auto flags = os.flags();
+    os << std::hex << " known zeros 0x" << range.known_zeros() << ", known ones 0x" << range.known_ones();
+    os.flags(flags);
+    return os;
+}
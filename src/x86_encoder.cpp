@@ -0,0 +1,652 @@
+/*
+Project: TUC
+File: x86_encoder.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+// project headers
+#include "x86_encoder.hpp"
+#include "compiler_exceptions.hpp"
+
+// standard libraries
+#include <sstream>
+#include <unordered_map>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using tuc::Register;
+    using tuc::AsmOpcode;
+    using tuc::AsmOperand;
+    using tuc::AsmInstruction;
+    using OperandType = tuc::AsmOperand::OperandType;
+    using Bytes = std::vector<std::uint8_t>;
+
+    const int shortJumpSize = 2;    // `jmp rel8` and `jcc rel8`
+    const int nearJumpSize = 5;     // `jmp rel32`
+    const int nearBranchSize = 6;   // `jcc rel32`
+    const int callSize = 5;         // `call rel32`
+    const int dataAlignment = 16;   // of each reservation in the data
+
+    bool fits_int8(std::int64_t value) {
+        return value >= -128 && value <= 127;
+    }
+
+    bool fits_int32(std::int64_t value) {
+        return value >= -2147483648ll && value <= 2147483647ll;
+    }
+
+    bool is_register(const AsmOperand& o) {
+        return o.type() == OperandType::REGISTER;
+    }
+
+    bool is_immediate(const AsmOperand& o) {
+        return o.type() == OperandType::IMMEDIATE;
+    }
+
+    bool is_memory(const AsmOperand& o) {
+        return o.type() == OperandType::MEMORY;
+    }
+
+    bool is_label(const AsmOperand& o) {
+        return o.type() == OperandType::LABEL;
+    }
+
+    /*
+    returns true if an instruction is a jump (conditional or not) to a label of the code
+    */
+    bool is_jump(const AsmInstruction& instruction) {
+        auto opcode = instruction.opcode();
+        return opcode == AsmOpcode::JMP || opcode == AsmOpcode::JE || opcode == AsmOpcode::JNE;
+    }
+
+    /*
+    returns true if an instruction loads the address of reserved data (which ends with the 4-byte field to relocate)
+    */
+    bool uses_data(const AsmInstruction& instruction) {
+        return (instruction.opcode() == AsmOpcode::MOV || instruction.opcode() == AsmOpcode::LEA) &&
+               instruction.operand_count() == 2 && is_label(instruction.operand(1));
+    }
+
+    /*
+    returns the low 3 bits of a register's number, which go in the ModRM and SIB bytes or the opcode
+    */
+    int low_bits(Register r) {
+        return static_cast<int>(r) & 7;
+    }
+
+    /*
+    returns true if a register is only available on x86-64 (r8 to r15), whose fourth bit goes in a REX prefix
+    */
+    bool is_extended(Register r) {
+        return static_cast<int>(r) >= 8;
+    }
+
+    void put_value(Bytes& bytes, std::int64_t value, int size) {
+        for (int i = 0; i < size; i++)
+            bytes.push_back(static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8 * i)));
+    }
+
+    tuc::CompilerException::InvalidInstruction invalid(const AsmInstruction& instruction, tuc::Target target,
+                                                       const std::string& cause) {
+        auto text = std::ostringstream{};
+        tuc::put_instruction(text, instruction, target);
+        return tuc::CompilerException::InvalidInstruction{text.str(), cause};
+    }
+
+    /*
+    Encodes a single instruction. Instructions taking a register or memory operand are written as: a REX prefix (on
+    x86-64, for 64-bit operands or registers r8 to r15), the opcode, a ModRM byte with the register (or opcode
+    extension) in its `reg` field and the register or memory operand in its `r/m` field, a SIB byte for addresses
+    with an index (or based on esp), the displacement, and the immediate value.
+    */
+    class InstructionEncoder {
+        public:
+            InstructionEncoder(const AsmInstruction& _instruction, tuc::Target _target)
+            : instruction{_instruction}, target{_target} {}
+
+            Bytes encode();
+
+        private:
+            void check_register(Register r) const;
+
+            void put_rex(bool wide, int reg, const AsmOperand& rm);
+            /*  puts a REX prefix if one is needed; `reg` is the register number in the `reg` field (or an opcode
+                extension, less than 8) */
+
+            void put_modrm(std::initializer_list<std::uint8_t> opcode, int reg, const AsmOperand& rm, bool wide);
+            /*  puts an instruction with a ModRM byte (and whatever follows it), `wide` meaning 64-bit operands */
+
+            void put_register_in_opcode(std::uint8_t opcode, Register r, bool wide);
+            /*  puts an instruction with the register added to its opcode (e.g. `push` or `mov r, imm`) */
+
+            void put_arithmetic(int extension, std::uint8_t storeOpcode, std::uint8_t loadOpcode, std::uint8_t accumulatorOpcode);
+            /*  puts one of the two operand arithmetic instructions (`add`, `sub`, `xor`, `cmp`) */
+
+            void put_move();
+
+            void put_data_address();
+            /*  puts an instruction loading the address of reserved data, with a field to relocate */
+
+            void put_multiply();
+
+            void put_shift(int extension);
+
+            void put_stack_operation(std::uint8_t registerOpcode, std::uint8_t memoryOpcode, int extension);
+
+            bool wide() const noexcept;
+            /*  returns true if the operands of the instruction are 64-bit */
+
+            const AsmInstruction& instruction;
+            tuc::Target target;
+            Bytes bytes;
+    };
+
+    bool InstructionEncoder::wide() const noexcept {
+        return instruction.size() == 8;
+    }
+
+    void InstructionEncoder::check_register(Register r) const {
+        if (is_extended(r) && target != tuc::Target::X86_64)
+            throw invalid(instruction, target, "registers r8 to r15 only exist on x86-64");
+    }
+
+    /*
+    puts a REX prefix if one is needed; `reg` is the register number in the `reg` field (or an opcode extension, less
+    than 8)
+    */
+    void InstructionEncoder::put_rex(bool wide, int reg, const AsmOperand& rm) {
+        auto rex = 0x40;
+        if (wide)
+            rex |= 0x08;
+        if (reg >= 8)
+            rex |= 0x04;
+        if (is_memory(rm) && rm.has_index() && is_extended(rm.index()))
+            rex |= 0x02;
+        if ((is_register(rm) || is_memory(rm)) && is_extended(rm.base()))
+            rex |= 0x01;
+        if (rex != 0x40) {
+            if (target != tuc::Target::X86_64)
+                throw invalid(instruction, target, "64-bit operands and registers r8 to r15 only exist on x86-64");
+            bytes.push_back(static_cast<std::uint8_t>(rex));
+        }
+    }
+
+    /*
+    puts an instruction with a ModRM byte (and whatever follows it), `wide` meaning 64-bit operands
+
+    An address is encoded without a displacement if it has none (except for ebp and r13, whose "no displacement"
+    encoding means something else), with an 8-bit one if it fits, and with a 32-bit one otherwise. esp and r12 can
+    only be a base through a SIB byte, and esp cannot be an index.
+    */
+    void InstructionEncoder::put_modrm(std::initializer_list<std::uint8_t> opcode, int reg, const AsmOperand& rm, bool wide) {
+        if (is_register(rm))
+            check_register(rm.base());
+        if (is_memory(rm)) {
+            check_register(rm.base());
+            if (rm.has_index())
+                check_register(rm.index());
+        }
+        put_rex(wide, reg, rm);
+        bytes.insert(bytes.end(), opcode.begin(), opcode.end());
+
+        auto regField = (reg & 7) << 3;
+        if (is_register(rm)) {
+            bytes.push_back(static_cast<std::uint8_t>(0xc0 | regField | low_bits(rm.base())));
+            return;
+        }
+
+        auto displacement = rm.value();
+        auto mod = 0x80;
+        if (displacement == 0 && low_bits(rm.base()) != 5)
+            mod = 0x00;
+        else if (fits_int8(displacement))
+            mod = 0x40;
+
+        if (rm.has_index() || low_bits(rm.base()) == 4) {
+            if (rm.has_index() && rm.index() == Register::SP)
+                throw invalid(instruction, target, "esp cannot be an index register");
+            auto scaleBits = 0;
+            for (auto s = rm.has_index() ? rm.scale() : 1; s > 1; s >>= 1)
+                scaleBits++;
+            auto indexBits = rm.has_index() ? low_bits(rm.index()) : 4;
+            bytes.push_back(static_cast<std::uint8_t>(mod | regField | 4));
+            bytes.push_back(static_cast<std::uint8_t>((scaleBits << 6) | (indexBits << 3) | low_bits(rm.base())));
+        }
+        else {
+            bytes.push_back(static_cast<std::uint8_t>(mod | regField | low_bits(rm.base())));
+        }
+
+        if (mod == 0x40)
+            put_value(bytes, displacement, 1);
+        else if (mod == 0x80)
+            put_value(bytes, displacement, 4);
+    }
+
+    /*
+    puts an instruction with the register added to its opcode (e.g. `push` or `mov r, imm`)
+    */
+    void InstructionEncoder::put_register_in_opcode(std::uint8_t opcode, Register r, bool wide) {
+        check_register(r);
+        put_rex(wide, 0, AsmOperand::reg(r));
+        bytes.push_back(static_cast<std::uint8_t>(opcode + low_bits(r)));
+    }
+
+    /*
+    puts one of the two operand arithmetic instructions (`add`, `sub`, `xor`, `cmp`)
+
+    Immediate values use the sign-extended 8-bit form when they fit, then the short form for eax if the destination is
+    eax, then the 32-bit form.
+    */
+    void InstructionEncoder::put_arithmetic(int extension, std::uint8_t storeOpcode, std::uint8_t loadOpcode,
+                                            std::uint8_t accumulatorOpcode) {
+        const auto& dst = instruction.operand(0);
+        const auto& src = instruction.operand(1);
+        if (is_immediate(src)) {
+            auto value = src.value();
+            if (fits_int8(value)) {
+                put_modrm({0x83}, extension, dst, wide());
+                put_value(bytes, value, 1);
+            }
+            else if (dst.is_register(Register::AX)) {
+                put_rex(wide(), 0, dst);
+                bytes.push_back(accumulatorOpcode);
+                put_value(bytes, value, 4);
+            }
+            else {
+                put_modrm({0x81}, extension, dst, wide());
+                put_value(bytes, value, 4);
+            }
+        }
+        else if (is_register(src)) {
+            check_register(src.base());
+            put_modrm({storeOpcode}, static_cast<int>(src.base()), dst, wide());
+        }
+        else {
+            put_modrm({loadOpcode}, static_cast<int>(dst.base()), src, wide());
+        }
+    }
+
+    /*
+    A 64-bit register is loaded with an immediate value the shortest of three ways: as a 32-bit register (whose upper
+    half is then cleared) if the value is a positive 32-bit one, with a sign-extended 32-bit immediate if it is a
+    negative one, and with a full 64-bit immediate otherwise.
+    */
+    void InstructionEncoder::put_move() {
+        const auto& dst = instruction.operand(0);
+        const auto& src = instruction.operand(1);
+        if (is_immediate(src) && is_register(dst)) {
+            auto value = src.value();
+            if (!wide() || (value >= 0 && value <= 0xffffffffll)) {
+                put_register_in_opcode(0xb8, dst.base(), false);
+                put_value(bytes, value, 4);
+            }
+            else if (fits_int32(value)) {
+                put_modrm({0xc7}, 0, dst, true);
+                put_value(bytes, value, 4);
+            }
+            else {
+                put_register_in_opcode(0xb8, dst.base(), true);
+                put_value(bytes, value, 8);
+            }
+        }
+        else if (is_immediate(src)) {
+            put_modrm({0xc7}, 0, dst, wide());
+            put_value(bytes, src.value(), 4);
+        }
+        else if (is_register(src)) {
+            check_register(src.base());
+            put_modrm({0x89}, static_cast<int>(src.base()), dst, wide());
+        }
+        else {
+            put_modrm({0x8b}, static_cast<int>(dst.base()), src, wide());
+        }
+    }
+
+    /*
+    the absolute address of data is an immediate value on x86, but x86-64 code addresses it relative to the next
+    instruction (`[rel name]`, the ModRM byte with no base register), which does not tie it to where it is loaded
+    */
+    void InstructionEncoder::put_data_address() {
+        auto dst = instruction.operand(0).base();
+        if (target == tuc::Target::X86_64) {
+            if (instruction.opcode() != AsmOpcode::LEA)
+                throw invalid(instruction, target, "x86-64 code loads the address of data with `lea`");
+            check_register(dst);
+            put_rex(wide(), static_cast<int>(dst), AsmOperand{});
+            bytes.push_back(0x8d);
+            bytes.push_back(static_cast<std::uint8_t>(((static_cast<int>(dst) & 7) << 3) | 5));
+        }
+        else {
+            if (instruction.opcode() != AsmOpcode::MOV)
+                throw invalid(instruction, target, "x86 code loads the address of data with `mov`");
+            put_register_in_opcode(0xb8, dst, false);
+        }
+        put_value(bytes, 0, 4);
+    }
+
+    void InstructionEncoder::put_multiply() {
+        if (instruction.operand_count() == 1) {
+            put_modrm({0xf7}, 5, instruction.operand(0), wide());
+            return;
+        }
+
+        const auto& dst = instruction.operand(0);
+        const auto& src = instruction.operand(1);
+        if (is_immediate(src)) {
+            // `imul r, imm` is `imul r, r, imm`
+            auto value = src.value();
+            put_modrm({fits_int8(value) ? std::uint8_t{0x6b} : std::uint8_t{0x69}}, static_cast<int>(dst.base()), dst, wide());
+            put_value(bytes, value, fits_int8(value) ? 1 : 4);
+        }
+        else {
+            put_modrm({0x0f, 0xaf}, static_cast<int>(dst.base()), src, wide());
+        }
+    }
+
+    /*
+    shifts by 1 have a form without an immediate value
+    */
+    void InstructionEncoder::put_shift(int extension) {
+        auto amount = instruction.operand(1).value();
+        if (amount == 1) {
+            put_modrm({0xd1}, extension, instruction.operand(0), wide());
+        }
+        else {
+            put_modrm({0xc1}, extension, instruction.operand(0), wide());
+            put_value(bytes, amount, 1);
+        }
+    }
+
+    /*
+    `push` and `pop` operate on whole registers: 32-bit ones on x86 and 64-bit ones (without a REX.W prefix) on x86-64
+    */
+    void InstructionEncoder::put_stack_operation(std::uint8_t registerOpcode, std::uint8_t memoryOpcode, int extension) {
+        if (instruction.size() != tuc::address_size(target))
+            throw invalid(instruction, target, "the stack can only hold registers of the size of addresses");
+
+        const auto& o = instruction.operand(0);
+        if (is_register(o)) {
+            put_register_in_opcode(registerOpcode, o.base(), false);
+        }
+        else if (is_immediate(o) && registerOpcode == 0x50) {
+            auto value = o.value();
+            bytes.push_back(fits_int8(value) ? 0x6a : 0x68);
+            put_value(bytes, value, fits_int8(value) ? 1 : 4);
+        }
+        else {
+            put_modrm({memoryOpcode}, extension, o, false);
+        }
+    }
+
+    Bytes InstructionEncoder::encode() {
+        if (wide() && target != tuc::Target::X86_64)
+            throw invalid(instruction, target, "64-bit operands only exist on x86-64");
+        for (int i = 0, count = instruction.operand_count(); i < count; i++) {
+            if (instruction.operand(i).type() == OperandType::NONE)
+                throw invalid(AsmInstruction{instruction.opcode(), {}, instruction.size()}, target,
+                              "operand " + std::to_string(i + 1) + " has no location");
+        }
+
+        if (uses_data(instruction)) {
+            put_data_address();
+            return bytes;
+        }
+
+        switch (instruction.opcode()) {
+        case AsmOpcode::LABEL:
+        case AsmOpcode::RESERVE:
+            break;
+        case AsmOpcode::MOV:    put_move(); break;
+        case AsmOpcode::ADD:    put_arithmetic(0, 0x01, 0x03, 0x05); break;
+        case AsmOpcode::SUB:    put_arithmetic(5, 0x29, 0x2b, 0x2d); break;
+        case AsmOpcode::XOR:    put_arithmetic(6, 0x31, 0x33, 0x35); break;
+        case AsmOpcode::CMP:    put_arithmetic(7, 0x39, 0x3b, 0x3d); break;
+        case AsmOpcode::IMUL:   put_multiply(); break;
+        case AsmOpcode::IDIV:   put_modrm({0xf7}, 7, instruction.operand(0), wide()); break;
+        case AsmOpcode::DIV:    put_modrm({0xf7}, 6, instruction.operand(0), wide()); break;
+        case AsmOpcode::NEG:    put_modrm({0xf7}, 3, instruction.operand(0), wide()); break;
+        case AsmOpcode::CDQ:
+            put_rex(wide(), 0, AsmOperand{});
+            bytes.push_back(0x99);
+            break;
+        case AsmOpcode::SHL:    put_shift(4); break;
+        case AsmOpcode::SHR:    put_shift(5); break;
+        case AsmOpcode::SAR:    put_shift(7); break;
+        case AsmOpcode::LEA:
+            put_modrm({0x8d}, static_cast<int>(instruction.operand(0).base()), instruction.operand(1), wide());
+            break;
+        case AsmOpcode::MOVSXD:
+            put_modrm({0x63}, static_cast<int>(instruction.operand(0).base()), instruction.operand(1), true);
+            break;
+        case AsmOpcode::XCHG:
+            // the runtime of parallel calls only exchanges registers with memory, which has a single encoding
+            if (instruction.operand(0).type() != OperandType::MEMORY || instruction.operand(1).type() != OperandType::REGISTER)
+                throw invalid(instruction, target, "`xchg` is only encoded with a memory and a register operand");
+            put_modrm({0x87}, static_cast<int>(instruction.operand(1).base()), instruction.operand(0), wide());
+            break;
+        case AsmOpcode::PUSH:   put_stack_operation(0x50, 0xff, 6); break;
+        case AsmOpcode::POP:    put_stack_operation(0x58, 0x8f, 0); break;
+        case AsmOpcode::INT:
+            bytes.push_back(0xcd);
+            put_value(bytes, instruction.operand(0).value(), 1);
+            break;
+        case AsmOpcode::SYSCALL:
+            if (target != tuc::Target::X86_64)
+                throw invalid(instruction, target, "`syscall` is the system call instruction of x86-64");
+            bytes.insert(bytes.end(), {0x0f, 0x05});
+            break;
+        case AsmOpcode::RET:
+            bytes.push_back(0xc3);
+            break;
+        case AsmOpcode::JMP:
+        case AsmOpcode::JE:
+        case AsmOpcode::JNE:
+        case AsmOpcode::CALL:
+            throw invalid(instruction, target, "jumps and calls are only encoded with the rest of their code");
+        }
+        return bytes;
+    }
+
+    /*
+    returns the name of a label as nasm puts it in the symbol table: local labels (starting with `.`) belong to the
+    last label before them that is not local
+    */
+    std::string qualified_name(const std::string& name, const std::string& lastNonLocal) {
+        return !name.empty() && name[0] == '.' ? lastNonLocal + name : name;
+    }
+}
+
+
+
+//~class implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+tuc::MachineCode::MachineCode(std::vector<std::uint8_t> _bytes, std::vector<Label> _labels, std::size_t _dataSize,
+                              std::vector<Label> _dataLabels, std::vector<Relocation> _relocations)
+: codeBytes{std::move(_bytes)}, codeLabels{std::move(_labels)}, dataSize{_dataSize}, dataLabels{std::move(_dataLabels)},
+  codeRelocations{std::move(_relocations)} {}
+
+const std::vector<std::uint8_t>& tuc::MachineCode::bytes() const noexcept {
+    return codeBytes;
+}
+
+const std::vector<tuc::MachineCode::Label>& tuc::MachineCode::labels() const noexcept {
+    return codeLabels;
+}
+
+std::size_t tuc::MachineCode::data_size() const noexcept {
+    return dataSize;
+}
+
+const std::vector<tuc::MachineCode::Label>& tuc::MachineCode::data_labels() const noexcept {
+    return dataLabels;
+}
+
+const std::vector<tuc::MachineCode::Relocation>& tuc::MachineCode::relocations() const noexcept {
+    return codeRelocations;
+}
+
+/*
+returns the bytes of the code loaded at `codeAddress` with its data at `dataAddress`
+*/
+std::vector<std::uint8_t> tuc::MachineCode::relocated_bytes(std::uint64_t codeAddress, std::uint64_t dataAddress,
+                                                            Target target) const {
+    auto bytes = codeBytes;
+    for (const auto& relocation : codeRelocations) {
+        auto value = dataAddress + relocation.second;
+        if (target == Target::X86_64)
+            value -= codeAddress + relocation.first + 4;
+        for (int i = 0; i < 4; i++)
+            bytes[relocation.first + i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+    return bytes;
+}
+
+
+
+//~function implementations~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+returns the machine code of an instruction that is not a jump (throws if it cannot be encoded for `target`)
+*/
+std::vector<std::uint8_t> tuc::encode_instruction(const AsmInstruction& instruction, Target target) {
+    return InstructionEncoder{instruction, target}.encode();
+}
+
+/*
+returns the machine code of a list of instructions, encoded the way nasm assembles their text (the shortest form of
+each instruction and of each jump)
+
+Jumps start out short and the ones whose target turns out to be out of reach of an 8-bit displacement are made near
+until the offsets of the labels settle; since jumps only grow, this takes a few passes at most. Calls always take a
+32-bit displacement. Each reservation of data is aligned to 16 bytes.
+*/
+tuc::MachineCode tuc::encode_instructions(const AsmList& code, Target target) {
+    auto count = static_cast<int>(code.size());
+    auto encoded = std::vector<Bytes>(count);
+    auto names = std::vector<std::string>(count);
+    auto lastNonLocal = std::string{};
+    auto dataSize = std::size_t{0};
+    auto dataLabels = std::vector<MachineCode::Label>{};
+    auto dataOffsets = std::unordered_map<std::string, std::size_t>{};
+    for (int i = 0; i < count; i++) {
+        const auto& instruction = code[i];
+        if (instruction.opcode() == AsmOpcode::LABEL) {
+            names[i] = qualified_name(instruction.operand(0).name(), lastNonLocal);
+            if (names[i] == instruction.operand(0).name())
+                lastNonLocal = names[i];
+        }
+        else if (is_jump(instruction) || instruction.opcode() == AsmOpcode::CALL) {
+            names[i] = qualified_name(instruction.operand(0).name(), lastNonLocal);
+        }
+        else if (instruction.opcode() == AsmOpcode::RESERVE) {
+            dataSize = (dataSize + dataAlignment - 1) / dataAlignment * dataAlignment;
+            dataLabels.emplace_back(instruction.operand(0).name(), dataSize);
+            dataOffsets[instruction.operand(0).name()] = dataSize;
+            dataSize += instruction.operand(1).value();
+        }
+        else {
+            encoded[i] = encode_instruction(instruction, target);
+        }
+    }
+
+    auto nearJump = std::vector<bool>(count, false);
+    auto offsets = std::vector<std::size_t>(count + 1, 0);
+    auto labelOffsets = std::unordered_map<std::string, std::size_t>{};
+    auto settled = false;
+    while (!settled) {
+        for (int i = 0; i < count; i++) {
+            auto nearSize = code[i].opcode() == AsmOpcode::JMP ? nearJumpSize : nearBranchSize;
+            auto size = is_jump(code[i]) ? (nearJump[i] ? nearSize : shortJumpSize) :
+                        code[i].opcode() == AsmOpcode::CALL ? callSize : encoded[i].size();
+            offsets[i + 1] = offsets[i] + size;
+            if (code[i].opcode() == AsmOpcode::LABEL)
+                labelOffsets[names[i]] = offsets[i];
+        }
+
+        settled = true;
+        for (int i = 0; i < count; i++) {
+            if (!is_jump(code[i]) || nearJump[i])
+                continue;
+            auto target = labelOffsets.find(names[i]);
+            if (target == labelOffsets.end())
+                throw CompilerException::InvalidInstruction{"jmp " + names[i], "the label is not defined"};
+            if (!fits_int8(static_cast<std::int64_t>(target->second) - static_cast<std::int64_t>(offsets[i + 1]))) {
+                nearJump[i] = true;
+                settled = false;
+            }
+        }
+    }
+
+    auto bytes = Bytes{};
+    auto labels = std::vector<MachineCode::Label>{};
+    auto relocations = std::vector<MachineCode::Relocation>{};
+    for (int i = 0; i < count; i++) {
+        if (code[i].opcode() == AsmOpcode::LABEL) {
+            labels.emplace_back(names[i], offsets[i]);
+        }
+        else if (is_jump(code[i])) {
+            auto displacement = static_cast<std::int64_t>(labelOffsets.at(names[i])) - static_cast<std::int64_t>(offsets[i + 1]);
+            auto condition = code[i].opcode() == AsmOpcode::JE ? 0x4 : 0x5;     // the condition code of `jcc`
+            if (code[i].opcode() == AsmOpcode::JMP)
+                bytes.push_back(nearJump[i] ? 0xe9 : 0xeb);
+            else if (nearJump[i])
+                bytes.insert(bytes.end(), {0x0f, static_cast<std::uint8_t>(0x80 | condition)});
+            else
+                bytes.push_back(static_cast<std::uint8_t>(0x70 | condition));
+            put_value(bytes, displacement, nearJump[i] ? 4 : 1);
+        }
+        else if (code[i].opcode() == AsmOpcode::CALL) {
+            auto target = labelOffsets.find(names[i]);
+            if (target == labelOffsets.end())
+                throw CompilerException::InvalidInstruction{"call " + names[i], "the label is not defined"};
+            bytes.push_back(0xe8);
+            put_value(bytes, static_cast<std::int64_t>(target->second) - static_cast<std::int64_t>(offsets[i + 1]), 4);
+        }
+        else if (uses_data(code[i])) {
+            auto data = dataOffsets.find(code[i].operand(1).name());
+            if (data == dataOffsets.end())
+                throw invalid(code[i], target, "no data is reserved with that name");
+            bytes.insert(bytes.end(), encoded[i].cbegin(), encoded[i].cend() - 4);
+            relocations.emplace_back(bytes.size(), data->second);
+            put_value(bytes, target == Target::X86_64 ? 0 : data->second, 4);
+        }
+        else {
+            bytes.insert(bytes.end(), encoded[i].cbegin(), encoded[i].cend());
+        }
+    }
+    return MachineCode{bytes, labels, dataSize, dataLabels, relocations};
+}
@@ -0,0 +1,184 @@
+/*
+Project: TUC
+File: column_benchmark.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+
+// project headers
+#include "lexer.hpp"
+#include "syntax_tree.hpp"
+#include "column_kernel.hpp"
+#include "compiler_exceptions.hpp"
+
+// c++ standard libraries
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    using NodeType = tuc::SyntaxNode::NodeType;
+    // the column of each identifier and the value of each literal of an expression tree, so that they are not looked
+    // up (or parsed) again for every row
+    struct Leaf {
+        const std::int32_t* column;
+        std::int32_t value;
+    };
+    using LeafMap = std::unordered_map<const tuc::SyntaxNode*, Leaf>;
+
+    /*
+    adds the identifiers of an expression tree that are not in `names` yet to it (with a column of random values),
+    and records the leaves of the tree
+    */
+    void find_columns(const tuc::SyntaxNode* node, std::vector<std::string>& names, std::vector<std::vector<std::int32_t>>& columns,
+                      std::size_t rows, LeafMap& leaves, std::mt19937& generator) {
+        if (node->type() == NodeType::IDENTIFIER) {
+            auto i = std::find(names.cbegin(), names.cend(), node->value()) - names.cbegin();
+            if (i == static_cast<int>(names.size())) {
+                names.push_back(node->value());
+                columns.emplace_back(rows);
+                for (auto& value : columns.back())
+                    value = static_cast<std::int32_t>(generator() % 20001) - 10000;
+            }
+            leaves[node] = Leaf{nullptr, 0};
+        }
+        else if (node->type() == NodeType::INTEGER) {
+            leaves[node] = Leaf{nullptr, std::stoi(node->value())};
+        }
+        for (int i = 0; i < node->child_count(); i++)
+            find_columns(node->child(i), names, columns, rows, leaves, generator);
+    }
+
+    /*
+    computes the value of an expression tree for one row, one node at a time (a division by 0 counts as 0 here,
+    since the benchmark's columns are never 0 where they are divisors)
+    */
+    std::int32_t walk_tree(const tuc::SyntaxNode* node, const LeafMap& leaves, std::size_t row) {
+        switch (node->type()) {
+        case NodeType::INTEGER:     return leaves.at(node).value;
+        case NodeType::IDENTIFIER:  return leaves.at(node).column[row];
+        default:                    break;
+        }
+        auto l = static_cast<std::uint32_t>(walk_tree(node->child(0), leaves, row));
+        auto r = static_cast<std::uint32_t>(walk_tree(node->child(1), leaves, row));
+        switch (node->type()) {
+        case NodeType::ADD:         return static_cast<std::int32_t>(l + r);
+        case NodeType::SUBTRACT:    return static_cast<std::int32_t>(l - r);
+        case NodeType::MULTIPLY:    return static_cast<std::int32_t>(l * r);
+        default:
+            if (r == 0 || (l == 0x80000000u && r == 0xffffffffu))
+                return 0;
+            return static_cast<std::int32_t>(l) / static_cast<std::int32_t>(r);
+        }
+    }
+
+    template <typename Function>
+    double seconds_to_run(Function function) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+
+
+/*
+prints the rows per second at which the first expression of a U source file is computed over random columns (one per
+identifier) by a scalar walk of its syntax tree and by the column kernel with each instruction set the machine has
+*/
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <expression file> [rows]\n";
+        return 1;
+    }
+    auto rows = static_cast<std::size_t>(argc > 2 ? std::stoul(argv[2]) : 10000000);
+
+    try {
+        auto tokens = tuc::lex_analyze(argv[1]);
+        auto root = std::unique_ptr<tuc::SyntaxNode>{};
+        auto symbolTable = tuc::SymbolTable{};
+        std::tie(root, symbolTable) = tuc::gen_syntax_tree(tokens);
+        if (root->child_count() == 0) {
+            std::cerr << argv[1] << " has no expression\n";
+            return 1;
+        }
+        auto expression = root->child(0);
+
+        auto generator = std::mt19937{1};
+        auto names = std::vector<std::string>{};
+        auto columns = std::vector<std::vector<std::int32_t>>{};
+        auto leaves = LeafMap{};
+        find_columns(expression, names, columns, rows, leaves, generator);
+        auto inputs = std::vector<const std::int32_t*>{};
+        for (const auto& column : columns)
+            inputs.push_back(column.data());
+        for (auto& leaf : leaves) {
+            if (leaf.first->type() == NodeType::IDENTIFIER)
+                leaf.second.column = inputs[std::find(names.cbegin(), names.cend(), leaf.first->value()) - names.cbegin()];
+        }
+
+        auto expected = std::vector<std::int32_t>(rows);
+        auto time = seconds_to_run([&]() {
+            for (std::size_t row = 0; row < rows; row++)
+                expected[row] = walk_tree(expression, leaves, row);
+        });
+        std::cout << "tree walk: " << rows / time << " rows/s\n";
+
+        auto output = std::vector<std::int32_t>(rows);
+        for (auto level : {tuc::SimdLevel::SCALAR, tuc::SimdLevel::SSE2, tuc::SimdLevel::AVX2}) {
+            auto kernel = tuc::ColumnKernel{expression, names, level};
+            if (kernel.simd_level() != level)
+                continue;   // not supported by this machine
+            auto traps = false;
+            time = seconds_to_run([&]() { traps = !kernel.evaluate(inputs, output.data(), rows); });
+            std::cout << "kernel (" << tuc::simd_level_name(level) << "): " << rows / time << " rows/s";
+            if (traps || output != expected)
+                std::cout << " (wrong results)";
+            std::cout << "\n";
+        }
+    }
+    catch (const tuc::CompilerException::AbstractError& e) {
+        std::cout << e.message();
+        return e.error_code();
+    }
+}
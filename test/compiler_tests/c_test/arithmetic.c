@@ -0,0 +1,20 @@
+#include <signal.h>
+#include <stdint.h>
+
+static uint32_t tuc_divide(uint32_t dividend, uint32_t divisor) {
+    if (divisor == 0 || (dividend == UINT32_C(0x80000000) && divisor == UINT32_C(0xffffffff)))
+        raise(SIGFPE);
+    return (uint32_t)((int32_t)dividend / (int32_t)divisor);
+}
+
+int main(void) {
+    uint32_t value = 0;
+    value = (uint32_t)(UINT32_C(1) + UINT32_C(2));
+    value = (uint32_t)(UINT32_C(2) - UINT32_C(1));
+    value = (uint32_t)((unsigned long long)UINT32_C(2) * UINT32_C(3));
+    value = tuc_divide(UINT32_C(8), UINT32_C(2));
+    value = (uint32_t)((uint32_t)((unsigned long long)UINT32_C(1) * UINT32_C(2)) + (uint32_t)((unsigned long long)UINT32_C(3) * UINT32_C(4)));
+    value = (uint32_t)((uint32_t)((uint32_t)((unsigned long long)UINT32_C(2) * UINT32_C(4)) + tuc_divide(UINT32_C(9), UINT32_C(3))) - (uint32_t)((unsigned long long)UINT32_C(4) * (uint32_t)(UINT32_C(1) + UINT32_C(1))));
+    value = tuc_divide((uint32_t)((uint32_t)((unsigned long long)UINT32_C(3) * UINT32_C(4)) + (uint32_t)((unsigned long long)UINT32_C(4) * UINT32_C(5))), (uint32_t)((uint32_t)((unsigned long long)UINT32_C(1) * UINT32_C(2)) + (uint32_t)((unsigned long long)UINT32_C(2) * UINT32_C(3))));
+    return (int)(value & 0xff);
+}
@@ -0,0 +1,36 @@
+#include <stdint.h>
+
+static uint32_t u_stuff(uint32_t u_a, uint32_t u_b);
+static uint32_t u_seven(void);
+static uint32_t u_difference(uint32_t u_a, uint32_t u_b);
+static uint32_t u_swapped(uint32_t u_a, uint32_t u_b);
+static uint32_t u_sum(uint32_t u_a, uint32_t u_b, uint32_t u_c, uint32_t u_d, uint32_t u_e, uint32_t u_f, uint32_t u_g, uint32_t u_h);
+
+static uint32_t u_stuff(uint32_t u_a, uint32_t u_b) {
+    return (uint32_t)((uint32_t)((unsigned long long)u_a * u_a) + u_b);
+}
+
+static uint32_t u_seven(void) {
+    return UINT32_C(7);
+}
+
+static uint32_t u_difference(uint32_t u_a, uint32_t u_b) {
+    return (uint32_t)(u_a - u_b);
+}
+
+static uint32_t u_swapped(uint32_t u_a, uint32_t u_b) {
+    return u_difference(u_b, u_a);
+}
+
+static uint32_t u_sum(uint32_t u_a, uint32_t u_b, uint32_t u_c, uint32_t u_d, uint32_t u_e, uint32_t u_f, uint32_t u_g, uint32_t u_h) {
+    return (uint32_t)((uint32_t)((uint32_t)((uint32_t)((uint32_t)((uint32_t)((uint32_t)(u_a + u_b) + u_c) + u_d) + u_e) + u_f) + u_g) + u_h);
+}
+
+int main(void) {
+    uint32_t value = 0;
+    value = u_stuff(UINT32_C(3), UINT32_C(4));
+    value = (uint32_t)(u_seven() + u_stuff((uint32_t)(u_seven() - UINT32_C(5)), UINT32_C(1)));
+    value = u_swapped(UINT32_C(10), UINT32_C(3));
+    value = (uint32_t)(u_sum(UINT32_C(1), UINT32_C(2), UINT32_C(3), UINT32_C(4), UINT32_C(5), UINT32_C(6), UINT32_C(7), UINT32_C(8)) - u_stuff(u_sum(UINT32_C(1), UINT32_C(1), UINT32_C(1), UINT32_C(1), UINT32_C(1), UINT32_C(1), UINT32_C(1), UINT32_C(1)), u_seven()));
+    return (int)(value & 0xff);
+}
@@ -0,0 +1,59 @@
+section .text
+global _start
+
+_start:
+.block0:
+mov eax, 1
+add eax, 2
+.block1:
+mov eax, 2
+sub eax, 1
+.block2:
+mov eax, 2
+lea eax, [eax + eax*2]
+.block3:
+mov eax, 8
+mov ecx, eax
+shr ecx, 31
+add eax, ecx
+sar eax, 1
+.block4:
+mov eax, 1
+shl eax, 1
+mov ecx, 3
+shl ecx, 2
+add eax, ecx
+.block5:
+mov eax, 2
+shl eax, 2
+mov ecx, 9
+push eax
+mov eax, ecx
+mov edx, 1431655766
+imul edx
+mov eax, edx
+shr eax, 31
+add edx, eax
+mov ecx, edx
+pop eax
+add eax, ecx
+mov ecx, 1
+add ecx, 1
+shl ecx, 2
+sub eax, ecx
+.block6:
+mov eax, 3
+shl eax, 2
+mov ecx, 4
+lea ecx, [ecx + ecx*4]
+add eax, ecx
+mov ecx, 1
+shl ecx, 1
+mov ebx, 2
+lea ebx, [ebx + ebx*2]
+add ecx, ebx
+cdq
+idiv ecx
+mov ebx, eax
+mov eax, 1
+int 80h
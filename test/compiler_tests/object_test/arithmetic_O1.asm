@@ -0,0 +1,14 @@
+section .text
+global _start
+
+_start:
+.block0:
+.block1:
+.block2:
+.block3:
+.block4:
+.block5:
+.block6:
+mov ebx, 4
+mov eax, 1
+int 80h
@@ -0,0 +1,85 @@
+section .text
+global _start
+
+_start:
+mov ebp, esp
+sub esp, 4
+.block0:
+mov eax, 3
+mov ecx, 4
+call u_stuff
+.block1:
+call u_seven
+call u_seven
+sub eax, 5
+mov ecx, 1
+call u_stuff
+.block2:
+mov eax, 10
+mov ecx, 3
+call u_swapped
+.block3:
+push 8
+push 7
+mov eax, 1
+mov ecx, 2
+mov ebx, 3
+mov esi, 4
+mov edi, 5
+mov edx, 6
+call u_sum
+add esp, 8
+mov dword [ebp - 4], eax
+push 1
+push 1
+mov eax, 1
+mov ecx, 1
+mov ebx, 1
+mov esi, 1
+mov edi, 1
+mov edx, 1
+call u_sum
+add esp, 8
+mov ecx, eax
+call u_seven
+mov ebx, eax
+mov eax, ecx
+mov ecx, ebx
+call u_stuff
+mov ecx, dword [ebp - 4]
+sub ecx, eax
+mov ebx, ecx
+mov eax, 1
+int 80h
+u_stuff:
+.block0:
+imul eax, eax
+add eax, ecx
+ret
+u_seven:
+.block0:
+mov eax, 7
+ret
+u_difference:
+.block0:
+sub eax, ecx
+ret
+u_swapped:
+.block0:
+mov ebx, eax
+mov eax, ecx
+mov ecx, ebx
+jmp u_difference
+u_sum:
+push ebp
+mov ebp, esp
+.block0:
+add eax, ecx
+add eax, ebx
+add eax, esi
+add eax, edi
+add eax, edx
+add eax, dword [ebp + 8]
+add eax, dword [ebp + 12]
+pop ebp
+ret
@@ -0,0 +1,11 @@
+section .text
+global _start
+
+_start:
+.block0:
+.block1:
+.block2:
+.block3:
+mov ebx, -35
+mov eax, 1
+int 80h
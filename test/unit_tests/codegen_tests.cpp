@@ -0,0 +1,1077 @@
+/*
+Project: OGLA
+File: codegen_tests.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description: A collection of unit tests for the lexer, syntax tree generator,
+    and assembly code generator. These unit tests use the Boos Test framework.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "tuc_unit_tests.hpp"
+#include "compiler_exceptions.hpp"
+
+// c++ standard libraries
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+runs a single block function and returns its exit code, using `inputs` as the values of some instructions; returns
+false if the function traps
+*/
+bool run_block(const IRFunction& function, const std::map<ValueId, std::int32_t>& inputs, std::int32_t& exitCode) {
+    auto values = std::vector<std::uint32_t>(function.instruction_count(), 0);
+    for (auto v : function.block(0).instructions()) {
+        const auto& instruction = function.instruction(v);
+        auto l = instruction.operand_count() > 0 ? values[function.operand(v, 0)] : 0u;
+        auto r = instruction.operand_count() > 1 ? values[function.operand(v, 1)] : 0u;
+        if (inputs.count(v) > 0) {
+            values[v] = static_cast<std::uint32_t>(inputs.at(v));
+            continue;
+        }
+        switch (instruction.opcode()) {
+        case IROpcode::CONSTANT:    values[v] = static_cast<std::uint32_t>(instruction.immediate()); break;
+        case IROpcode::ADD:         values[v] = l + r; break;
+        case IROpcode::SUBTRACT:    values[v] = l - r; break;
+        case IROpcode::MULTIPLY:    values[v] = l * r; break;
+        case IROpcode::DIVIDE:
+            if (r == 0 || (static_cast<std::int32_t>(l) == std::numeric_limits<std::int32_t>::min() &&
+                           static_cast<std::int32_t>(r) == -1))
+                return false;
+            values[v] = static_cast<std::uint32_t>(static_cast<std::int32_t>(l) / static_cast<std::int32_t>(r));
+            break;
+        case IROpcode::EXIT:        exitCode = static_cast<std::int32_t>(l); return true;
+        default:                    break;
+        }
+    }
+    return false;
+}
+
+/*
+returns the number of instructions of the only block of a function that are not constants
+*/
+int operation_count(const IRFunction& function) {
+    auto count = 0;
+    for (auto v : function.block(0).instructions())
+        count += function.instruction(v).opcode() != IROpcode::CONSTANT;
+    return count;
+}
+
+/*
+appends a random expression tree over `inputs` and some constants to the only block of a function
+*/
+ValueId random_expression(IRFunction& function, const std::vector<ValueId>& inputs, std::mt19937& generator, int depth) {
+    static const std::int32_t constants[] = {0, 1, -1, 2, 3, 7, 100, std::numeric_limits<std::int32_t>::min(),
+                                             std::numeric_limits<std::int32_t>::max()};
+    auto pick = [&](int n) { return static_cast<int>(generator() % n); };
+    if (depth == 0 || pick(4) == 0) {
+        if (pick(2) == 0)
+            return inputs[pick(inputs.size())];
+        return function.append(0, IROpcode::CONSTANT, IRType::INT32, {}, constants[pick(9)]);
+    }
+    static const IROpcode opcodes[] = {IROpcode::ADD, IROpcode::SUBTRACT, IROpcode::MULTIPLY, IROpcode::DIVIDE};
+    auto opcode = opcodes[pick(4)];
+    auto left = random_expression(function, inputs, generator, depth - 1);
+    auto right = random_expression(function, inputs, generator, depth - 1);
+    return function.append(0, opcode, IRType::INT32, {left, right});
+}
+
+
+/*
+returns a random expression tree over some literals (U has no negative literals, but subtractions make negative values)
+and some identifiers
+*/
+std::unique_ptr<SyntaxNode> random_syntax_tree(std::mt19937& generator, int depth, const std::vector<std::string>& identifiers = {}) {
+    static const char* literals[] = {"0", "1", "2", "3", "7", "100", "65536", "2147483647"};
+    static const std::pair<SyntaxNode::NodeType, const char*> operators[] = {
+        {SyntaxNode::NodeType::ADD, "+"}, {SyntaxNode::NodeType::SUBTRACT, "-"},
+        {SyntaxNode::NodeType::MULTIPLY, "*"}, {SyntaxNode::NodeType::DIVIDE, "/"}};
+    auto pick = [&](int n) { return static_cast<int>(generator() % n); };
+    if ((depth == 0 || pick(4) == 0) && !identifiers.empty() && pick(2) == 0)
+        return std::make_unique<SyntaxNode>(SyntaxNode::NodeType::IDENTIFIER, TextEntity{identifiers[pick(identifiers.size())], "", 0, 1, 1});
+    if (depth == 0 || pick(4) == 0)
+        return std::make_unique<SyntaxNode>(SyntaxNode::NodeType::INTEGER, TextEntity{literals[pick(8)], "", 0, 1, 1});
+    const auto& o = operators[pick(4)];
+    auto node = std::make_unique<SyntaxNode>(o.first, TextEntity{o.second, "", 0, 1, 1});
+    node->append_child(random_syntax_tree(generator, depth - 1, identifiers));
+    node->append_child(random_syntax_tree(generator, depth - 1, identifiers));
+    return node;
+}
+
+/*
+computes the value of an expression tree one node at a time, with `values` as the values of its identifiers; returns
+false if it traps
+*/
+bool evaluate_tree(const SyntaxNode* node, const std::map<std::string, std::int32_t>& values, std::int32_t& value) {
+    if (node->type() == SyntaxNode::NodeType::INTEGER) {
+        value = std::stoi(node->value());
+        return true;
+    }
+    else if (node->type() == SyntaxNode::NodeType::IDENTIFIER) {
+        value = values.at(node->value());
+        return true;
+    }
+    auto l = std::int32_t{};
+    auto r = std::int32_t{};
+    if (!evaluate_tree(node->child(0), values, l) || !evaluate_tree(node->child(1), values, r))
+        return false;
+    auto a = static_cast<std::uint32_t>(l);
+    auto b = static_cast<std::uint32_t>(r);
+    switch (node->type()) {
+    case SyntaxNode::NodeType::ADD:         value = static_cast<std::int32_t>(a + b); return true;
+    case SyntaxNode::NodeType::SUBTRACT:    value = static_cast<std::int32_t>(a - b); return true;
+    case SyntaxNode::NodeType::MULTIPLY:    value = static_cast<std::int32_t>(a * b); return true;
+    default:
+        if (r == 0 || (l == std::numeric_limits<std::int32_t>::min() && r == -1))
+            return false;
+        value = l / r;
+        return true;
+    }
+}
+
+
+//~test cases~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+BOOST_AUTO_TEST_SUITE(codegen_tests)
+
+BOOST_AUTO_TEST_CASE(register_need_test) {
+    auto root = get_syntax_tree();
+    BOOST_TEST(register_need(root->child(0)) == 1);     // 1+2
+    BOOST_TEST(register_need(root->child(1)) == 3);     // (3*4 + 4*5)/(2*3 - 1*2)
+}
+
+BOOST_AUTO_TEST_CASE(ir_lowering_test) {
+    auto root = get_syntax_tree();
+    auto program = gen_ir(root.get(), SymbolTable{});
+    BOOST_TEST(program.size() == 1u);
+
+    // one block per expression; the declaration does not generate any code
+    const auto& function = program.front();
+    BOOST_TEST(function.block_count() == 2);
+    BOOST_TEST(function.block(0).instructions().size() == 4u);     // 1, 2, +, jump
+
+    // the result of the last expression is the exit code
+    auto exit = function.block(1).instructions().back();
+    BOOST_TEST((function.instruction(exit).opcode() == IROpcode::EXIT));
+    BOOST_TEST((function.instruction(function.operand(exit, 0)).opcode() == IROpcode::DIVIDE));
+
+    // every operand is defined before it is used
+    auto defined = std::vector<bool>(function.instruction_count(), false);
+    for (auto v : function.linear_order()) {
+        for (int i = 0, c = function.instruction(v).operand_count(); i < c; i++)
+            BOOST_TEST(defined[function.operand(v, i)]);
+        defined[v] = true;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dead_statement_test) {
+    auto root = get_syntax_tree();
+    auto program = gen_ir(root.get(), SymbolTable{});
+
+    // `1 + 2;` is never observed; the last statement is the exit code
+    BOOST_TEST(eliminate_dead_statements(program, UseCountAnalysis::run(program)) == 3);
+    BOOST_TEST(program.front().block(0).instructions().size() == 1u);
+    BOOST_TEST(program.front().block(1).instructions().size() == 16u);
+
+    // `1 / 0;` traps so it must be kept
+    auto trapping = IRProgram{};
+    trapping.emplace_back("_start");
+    auto& function = trapping.back();
+    auto block = function.add_block();
+    auto one = function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 1);
+    auto zero = function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+    function.append(block, IROpcode::DIVIDE, IRType::INT32, {one, zero});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {zero});
+    BOOST_TEST(eliminate_dead_statements(trapping, UseCountAnalysis::run(trapping)) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(partial_evaluation_test) {
+    auto root = get_syntax_tree();
+
+    // running out of fuel leaves the program as it is
+    auto program = gen_ir(root.get(), SymbolTable{});
+    auto evaluation = partially_evaluate(program, 3);
+    BOOST_TEST((evaluation.outcome() == PartialEvaluation::Outcome::OUT_OF_FUEL));
+    BOOST_TEST(evaluation.folded() == 0);
+
+    // otherwise the exit code is known and the rest of the program is dead
+    evaluation = partially_evaluate(program);
+    BOOST_TEST((evaluation.outcome() == PartialEvaluation::Outcome::EVALUATED));
+    const auto& function = program.front();
+    auto exit = function.block(1).instructions().back();
+    const auto& exitCode = function.instruction(function.operand(exit, 0));
+    BOOST_TEST((exitCode.opcode() == IROpcode::CONSTANT));
+    BOOST_TEST(exitCode.immediate() == 8);     // (3*4 + 4*5)/(2*3 - 1*2)
+    eliminate_dead_statements(program, UseCountAnalysis::run(program));
+    BOOST_TEST(function.block(1).instructions().size() == 2u);
+
+    // calls are run on the values of their arguments, even those of functions that cannot be inlined (memoized here)
+    SymbolTable symbols;
+    auto calls = gen_ir(parse_program("sq x = x * x;\n"
+                                      "hyp a b = sq a + sq b;\n"
+                                      "dv x = 100 / x;\n"
+                                      "hyp 3 4 - dv 5;\n", &symbols).get(), symbols);
+    for (int f = 1, count = calls.size(); f < count; f++)
+        calls[f].set_memoized(true);
+    BOOST_TEST(inline_calls(calls) == 0);
+    evaluation = partially_evaluate(calls);
+    BOOST_TEST((evaluation.outcome() == PartialEvaluation::Outcome::EVALUATED));
+    auto exitValue = calls.front().operand(calls.front().block(0).instructions().back(), 0);
+    BOOST_TEST(calls.front().instruction(exitValue).immediate() == 5);
+
+    // a call that traps is left to run time, and one that never returns runs out of fuel
+    SymbolTable trappingSymbols;
+    auto trapping = gen_ir(parse_program("dv x = 100 / x;\nsq x = x * x;\nsq 2 + dv 0;\n", &trappingSymbols).get(),
+                           trappingSymbols);
+    BOOST_TEST((partially_evaluate(trapping).outcome() == PartialEvaluation::Outcome::RESIDUAL));
+    SymbolTable spinningSymbols;
+    auto spinning = gen_ir(parse_program("spin x = spin (x + 1);\nspin 1;\n", &spinningSymbols).get(), spinningSymbols);
+    BOOST_TEST((partially_evaluate(spinning).outcome() == PartialEvaluation::Outcome::OUT_OF_FUEL));
+}
+
+BOOST_AUTO_TEST_CASE(algebraic_simplification_test) {
+    // x and y stand for values only known at run time
+    auto makeInputs = [](IRFunction& function) {
+        auto zero = function.append(0, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+        auto x = function.append(0, IROpcode::DIVIDE, IRType::INT32, {zero, zero});
+        auto y = function.append(0, IROpcode::DIVIDE, IRType::INT32, {zero, zero});
+        return std::vector<ValueId>{x, y};
+    };
+
+    // (x + 3) + 4 is x + 7
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+    auto& function = program.back();
+    function.add_block();
+    auto x = makeInputs(function).front();
+    auto three = function.append(0, IROpcode::CONSTANT, IRType::INT32, {}, 3);
+    auto four = function.append(0, IROpcode::CONSTANT, IRType::INT32, {}, 4);
+    auto sum = function.append(0, IROpcode::ADD, IRType::INT32, {function.append(0, IROpcode::ADD, IRType::INT32, {x, three}), four});
+    function.append(0, IROpcode::EXIT, IRType::VOID, {sum});
+    BOOST_TEST(simplify_algebra(program, UseCountAnalysis::run(program)) == 1);
+    BOOST_TEST((function.instruction(sum).opcode() == IROpcode::ADD));
+    BOOST_TEST(function.operand(sum, 0) == x);
+    BOOST_TEST(function.instruction(function.operand(sum, 1)).immediate() == 7);
+
+    // random expressions keep their values (including 32-bit wraparound) and never get longer
+    auto generator = std::mt19937{2026};
+    const std::int32_t samples[] = {0, 1, -1, 5, -12345, std::numeric_limits<std::int32_t>::min(),
+                                    std::numeric_limits<std::int32_t>::max()};
+    for (int n = 0; n < 2000; n++) {
+        auto program = IRProgram{};
+        program.emplace_back("_start");
+        auto& function = program.back();
+        function.add_block();
+        auto inputs = makeInputs(function);
+        function.append(0, IROpcode::EXIT, IRType::VOID, {random_expression(function, inputs, generator, 4)});
+        auto original = function;
+
+        simplify_algebra(program, UseCountAnalysis::run(program));
+        eliminate_dead_statements(program, UseCountAnalysis::run(program));
+        BOOST_TEST(operation_count(function) <= operation_count(original));
+        for (auto a : samples) {
+            for (auto b : samples) {
+                auto values = std::map<ValueId, std::int32_t>{{inputs[0], a}, {inputs[1], b}};
+                auto expected = std::int32_t{0};
+                auto actual = std::int32_t{0};
+                if (run_block(original, values, expected)) {
+                    BOOST_TEST(run_block(function, values, actual));
+                    BOOST_TEST(actual == expected);
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(value_range_test) {
+    // the ranges of random expressions contain their values (x and y stand for values only known at run time)
+    auto generator = std::mt19937{2027};
+    const std::int32_t samples[] = {0, 1, -1, 5, -12345, std::numeric_limits<std::int32_t>::min(),
+                                    std::numeric_limits<std::int32_t>::max()};
+    for (int n = 0; n < 2000; n++) {
+        auto program = IRProgram{};
+        program.emplace_back("_start");
+        auto& function = program.back();
+        function.add_block();
+        auto zero = function.append(0, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+        auto x = function.append(0, IROpcode::DIVIDE, IRType::INT32, {zero, zero});
+        auto y = function.append(0, IROpcode::DIVIDE, IRType::INT32, {zero, zero});
+        auto root = random_expression(function, {x, y}, generator, 4);
+        function.append(0, IROpcode::EXIT, IRType::VOID, {root});
+
+        auto range = ValueRangeAnalysis::run(program).front()[root];
+        for (auto a : samples) {
+            for (auto b : samples) {
+                auto value = std::int32_t{0};
+                if (run_block(function, {{x, a}, {y, b}}, value))
+                    BOOST_TEST(range.contains(value), value << " is not in [" << range.min() << ", " << range.max() << "]");
+            }
+        }
+    }
+
+    // every value of good_program.ul is positive, so its division needs no sign handling
+    auto root = get_syntax_tree();
+    auto program = gen_ir(root.get(), SymbolTable{});
+    auto ranges = ValueRangeAnalysis::run(program);
+    BOOST_TEST(gen_program_asm(gen_program_code(program)).find("idiv") != std::string::npos);
+    auto outputASM = gen_program_asm(gen_program_code(program, &ranges));
+    BOOST_TEST(outputASM.find("idiv") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("cdq") == std::string::npos, outputASM);
+
+    // `(5 + 2) / (1 + 1);` cannot trap, so it can be removed when the ranges are known
+    auto statements = IRProgram{};
+    statements.emplace_back("_start");
+    auto& function = statements.back();
+    auto block = function.add_block();
+    auto constant = [&](std::int32_t value) { return function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, value); };
+    auto dividend = function.append(block, IROpcode::ADD, IRType::INT32, {constant(5), constant(2)});
+    auto divisor = function.append(block, IROpcode::ADD, IRType::INT32, {constant(1), constant(1)});
+    function.append(block, IROpcode::DIVIDE, IRType::INT32, {dividend, divisor});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {constant(3)});
+    BOOST_TEST(eliminate_dead_statements(statements, UseCountAnalysis::run(statements)) == 0);
+    ranges = ValueRangeAnalysis::run(statements);
+    BOOST_TEST(eliminate_dead_statements(statements, UseCountAnalysis::run(statements), &ranges) == 7);
+}
+
+BOOST_AUTO_TEST_CASE(superoptimizer_test) {
+    // x + y*2 is a single `lea`; (x + 2)*(y + 2) has no sequence shorter than its 3 operations
+    auto sequence = AsmList{};
+    BOOST_TEST(superoptimize("(add $0 (mul $1 2))", sequence));
+    BOOST_TEST(gen_program_asm(sequence).find("lea eax, [eax + ecx*2]") != std::string::npos, gen_program_asm(sequence));
+    BOOST_TEST(!superoptimize("(mul (add $0 2) (add $1 2))", sequence));
+
+    // the table is kept in a text file
+    auto table = SuperoptimizerTable{};
+    table.insert("(add $0 (mul $1 2))", {AsmInstruction{AsmOpcode::LEA, {AsmOperand::reg(Register::AX),
+                                          AsmOperand::mem(Register::AX, Register::CX, 2)}}});
+    table.insert("(mul (add $0 2) (add $1 2))", {});
+    table.save("superoptimizer_test.tbl");
+    table = SuperoptimizerTable::load("superoptimizer_test.tbl");
+    std::remove("superoptimizer_test.tbl");
+    BOOST_TEST(table.size() == 2);
+    BOOST_TEST(table.contains("(mul (add $0 2) (add $1 2))"));
+    BOOST_TEST(table.lookup("(mul (add $0 2) (add $1 2))") == nullptr);
+    BOOST_TEST_REQUIRE(table.lookup("(add $0 (mul $1 2))") != nullptr);
+    BOOST_TEST((table.lookup("(add $0 (mul $1 2))")->front().opcode() == AsmOpcode::LEA));
+
+    // (100 / 7)*2 + 3 / 1 is x*2 + y for the code generator
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+    auto& function = program.back();
+    auto block = function.add_block();
+    auto constant = [&](std::int32_t value) { return function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, value); };
+    auto x = function.append(block, IROpcode::DIVIDE, IRType::INT32, {constant(100), constant(7)});
+    auto y = function.append(block, IROpcode::DIVIDE, IRType::INT32, {constant(3), constant(1)});
+    auto product = function.append(block, IROpcode::MULTIPLY, IRType::INT32, {x, constant(2)});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {function.append(block, IROpcode::ADD, IRType::INT32, {product, y})});
+    auto shapes = match_expression_shapes(function, [](const ExpressionShape&) { return true; });
+    BOOST_TEST_REQUIRE(shapes.size() == 1u);
+    BOOST_TEST(shapes.front().key() == "(add $0 (mul $1 2))");
+    BOOST_TEST((shapes.front().inputs() == std::vector<ValueId>{y, x}));
+    auto outputASM = gen_program_asm(gen_program_code(program, nullptr, &table));
+    BOOST_TEST(outputASM.find("lea") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("shl") == std::string::npos, outputASM);
+}
+
+BOOST_AUTO_TEST_CASE(instruction_selector_test) {
+    // 100/7 + (200/9)*4 + 7 is a single `lea` once both divisions are done
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+    auto& function = program.back();
+    auto block = function.add_block();
+    auto constant = [&](std::int32_t value) { return function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, value); };
+    auto x = function.append(block, IROpcode::DIVIDE, IRType::INT32, {constant(100), constant(7)});
+    auto y = function.append(block, IROpcode::DIVIDE, IRType::INT32, {constant(200), constant(9)});
+    auto product = function.append(block, IROpcode::MULTIPLY, IRType::INT32, {y, constant(4)});
+    auto sum = function.append(block, IROpcode::ADD, IRType::INT32, {x, product});
+    auto total = function.append(block, IROpcode::ADD, IRType::INT32, {sum, constant(7)});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {total});
+
+    auto selector = InstructionSelector{function};
+    BOOST_TEST_REQUIRE(selector.tile(total) != nullptr);
+    BOOST_TEST(selector.tile(total)->rule_text() == "reg: ADD(ADD(reg, MULTIPLY(reg, scale)), con)");
+    BOOST_TEST((selector.tile(total)->nodes() == std::vector<ValueId>{product, sum, total}));
+    BOOST_TEST(selector.tile(total)->leaves().front() == x);
+    BOOST_TEST(selector.tile(sum) == nullptr);
+    BOOST_TEST(selector.tile(product) == nullptr);
+    BOOST_TEST(selector.operation_tile(sum).rule_text() == "reg: ADD(rc, rc)");
+    BOOST_TEST(selector.cost(total) == selector.cost(x) + selector.cost(y) + 1);
+    auto outputASM = gen_program_asm(gen_program_code(program));
+    BOOST_TEST(outputASM.find("*4 + 7]") != std::string::npos, outputASM);
+
+    // an operation used twice is computed once, in a register of its own
+    auto twice = IRProgram{};
+    twice.emplace_back("_start");
+    auto& other = twice.back();
+    block = other.add_block();
+    auto quotient = other.append(block, IROpcode::DIVIDE, IRType::INT32, {
+        other.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 9), other.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 2)});
+    auto scaled = other.append(block, IROpcode::MULTIPLY, IRType::INT32, {quotient, other.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 2)});
+    other.append(block, IROpcode::EXIT, IRType::VOID, {other.append(block, IROpcode::ADD, IRType::INT32, {quotient, scaled})});
+    auto otherSelector = InstructionSelector{other};
+    BOOST_TEST(otherSelector.tile(quotient) != nullptr);
+    BOOST_TEST(otherSelector.tile(scaled) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(no_spill_test) {
+    auto root = get_syntax_tree();
+    auto outputASM = gen_program_asm(gen_program_code(gen_ir(root.get(), SymbolTable{})));
+    BOOST_TEST(outputASM.find("push") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("pop") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("ebp") == std::string::npos, outputASM);
+}
+
+BOOST_AUTO_TEST_CASE(x86_64_test) {
+    // 16 sums that are all live until the end: more than x86-64 has registers for
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+    auto& function = program.back();
+    auto block = function.add_block();
+    auto constant = [&](std::int32_t value) { return function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, value); };
+    auto sums = std::vector<ValueId>{};
+    for (int i = 0; i < 16; i++)
+        sums.push_back(function.append(block, IROpcode::ADD, IRType::INT32, {constant(i), constant(i)}));
+    auto total = sums.back();
+    for (auto sum = sums.rbegin() + 1; sum != sums.rend(); sum++)
+        total = function.append(block, IROpcode::ADD, IRType::INT32, {*sum, total});
+    auto quotient = function.append(block, IROpcode::DIVIDE, IRType::INT32, {total, constant(7)});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {quotient});
+
+    auto outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(outputASM.find("bits 64") == 0u, outputASM);
+    BOOST_TEST(outputASM.find("r15d") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("mov rbp, rsp") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("dword [rbp - 4]") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("movsxd") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("idiv") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("syscall") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("int 80h") == std::string::npos, outputASM);
+
+    // the 32-bit code only has the first eight registers
+    outputASM = gen_program_asm(gen_program_code(program));
+    BOOST_TEST(outputASM.find("r8") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("dword [ebp - 4]") != std::string::npos, outputASM);
+}
+
+BOOST_AUTO_TEST_CASE(calling_convention_test) {
+    SymbolTable symbols;
+    auto root = parse_program("sq x = x * x;\n"
+                              "f a b c = sq a + b + c;\n"
+                              "sum a b c d e f g h = a + b + c + d + e + f + g + h;\n"
+                              "f 3 4 5 + sum 1 2 3 4 5 6 7 8;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+    BOOST_TEST(program.size() == 4u);
+    BOOST_TEST(program[1].name() == "sq");
+    const auto& square = program[1].block(0).instructions();
+    BOOST_TEST((program[1].instruction(square.front()).opcode() == IROpcode::PARAMETER));
+    BOOST_TEST((program[1].instruction(square.back()).opcode() == IROpcode::RETURN));
+
+    auto outputASM = gen_program_asm(gen_program_code(program));
+    auto code_of = [&](const std::string& label, const std::string& next) {
+        auto start = outputASM.find(label + ":\n");
+        return outputASM.substr(start, outputASM.find(next + ":\n", start) - start);
+    };
+    BOOST_TEST(outputASM.find("call u_f\n") != std::string::npos, outputASM);
+
+    // a leaf function without spills needs no frame
+    BOOST_TEST(code_of("u_sq", "u_f").find("ebp") == std::string::npos, outputASM);
+
+    // `sq` only writes eax, so `b` and `c` stay in their registers during the call
+    auto callerCode = code_of("u_f", "u_sum");
+    BOOST_TEST(callerCode.find("call u_sq\nadd eax, ecx\nadd eax, ebx\nret") != std::string::npos, outputASM);
+    BOOST_TEST(callerCode.find("mov") == std::string::npos, outputASM);
+
+    // the arguments that do not fit in the six registers are on the stack, above the saved ebp and return address
+    BOOST_TEST(outputASM.find("push 8\npush 7\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("add esp, 8\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("u_sum:\npush ebp\nmov ebp, esp\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("dword [ebp + 12]") != std::string::npos, outputASM);
+
+    // x86-64 passes all eight in registers
+    outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(outputASM.find("rbp") == std::string::npos, outputASM);
+
+    // `f` starts with its call of `sq`, whose displacement is from the end of the `call`
+    auto machineCode = encode_instructions(gen_program_code(program), Target::X86);
+    auto offsets = std::map<std::string, std::size_t>{};
+    for (const auto& label : machineCode.labels())
+        offsets[label.first] = label.second;
+    const auto& bytes = machineCode.bytes();
+    auto call = offsets.at("u_f");
+    BOOST_TEST(bytes[call] == 0xe8);
+    auto displacement = std::int32_t{};
+    std::memcpy(&displacement, &bytes[call + 1], 4);
+    BOOST_TEST(call + 5 + displacement == offsets.at("u_sq"));
+
+#if defined(__x86_64__)
+    BOOST_TEST(JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64)}.run() == 18 + 36);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(tail_call_test) {
+    SymbolTable symbols;
+    auto root = parse_program("odd : int -> int;\n"
+                              "even n = odd (n - 1);\n"
+                              "odd n = even (n - 1);\n"
+                              "count n = count (n - 1);\n"
+                              "wide a b c d e f g h = even (a + h);\n"
+                              "loop a b c d e f g h = loop b c d e f g h a;\n"
+                              "count 3 + 1;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+    auto outputASM = gen_program_asm(gen_program_code(program));
+    auto code_of = [&](const std::string& label) {
+        auto start = outputASM.find(label + ":\n");
+        auto end = outputASM.find("\nu_", start);
+        return outputASM.substr(start, end == std::string::npos ? end : end + 1 - start);
+    };
+
+    // mutual tail calls jump to each other and self tail calls loop back to the start of the body
+    BOOST_TEST(code_of("u_even").find("jmp u_odd\n") != std::string::npos, outputASM);
+    BOOST_TEST(code_of("u_odd").find("jmp u_even\n") != std::string::npos, outputASM);
+    BOOST_TEST(code_of("u_count").find("jmp .block0\n") != std::string::npos, outputASM);
+    BOOST_TEST(code_of("u_count").find("call") == std::string::npos, outputASM);
+    BOOST_TEST(code_of("_start").find("call u_count\n") != std::string::npos, outputASM);
+
+    // the frame is torn down before the jump; calls with stack arguments stay calls
+    BOOST_TEST(code_of("u_wide").find("pop ebp\njmp u_even\n") != std::string::npos, outputASM);
+    BOOST_TEST(code_of("u_loop").find("call u_loop\n") != std::string::npos, outputASM);
+
+    // x86-64 passes all eight arguments in registers
+    outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(code_of("u_loop").find("jmp .block0\n") != std::string::npos, outputASM);
+}
+
+BOOST_AUTO_TEST_CASE(inlining_test) {
+    SymbolTable symbols;
+    auto root = parse_program("twice x = x + x;\n"
+                              "big a b = a*b + a*b*b + a*a*b + a/b + b/a;\n"
+                              "big 5 6 + big (twice 4) 6;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+
+    // `twice` is small, and so is `big` once its constant arguments are folded; `big` with a computed argument is not
+    BOOST_TEST(inline_calls(program) == 2);
+    auto calls = std::vector<std::int32_t>{};
+    for (auto v : program[0].linear_order()) {
+        if (program[0].instruction(v).opcode() == IROpcode::CALL)
+            calls.push_back(program[0].instruction(v).immediate());
+    }
+    // `twice` is no longer called, so it is removed and `big` takes its place
+    BOOST_TEST(calls == std::vector<std::int32_t>{1});
+    BOOST_TEST(program.size() == 2u);
+    BOOST_TEST(program[1].name() == "big");
+    BOOST_TEST(inline_calls(program, 100) == 1);
+    BOOST_TEST(program.size() == 1u);
+
+    // not even the calls that were replaced refer to a function that was removed
+    for (ValueId v = 0; v < program[0].instruction_count(); v++)
+        BOOST_TEST((program[0].instruction(v).opcode() != IROpcode::CALL || program[0].instruction(v).immediate() == 0));
+
+#if defined(__x86_64__)
+    BOOST_TEST(JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64)}.run() == 361 + 721);
+#endif
+
+    // recursive functions are never inlined
+    auto recursive = IRProgram{IRFunction{"_start"}, IRFunction{"f"}};
+    auto& f = recursive[1];
+    auto block = f.add_block();
+    auto parameter = f.append(block, IROpcode::PARAMETER, IRType::INT32, {}, 0);
+    f.append(block, IROpcode::RETURN, IRType::VOID, {f.append(block, IROpcode::CALL, IRType::INT32, {parameter}, 1)});
+    auto& entry = recursive[0];
+    block = entry.add_block();
+    auto argument = entry.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 1);
+    entry.append(block, IROpcode::EXIT, IRType::VOID, {entry.append(block, IROpcode::CALL, IRType::INT32, {argument}, 1)});
+    BOOST_TEST(inline_calls(recursive, 100) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(memoization_test) {
+    SymbolTable symbols;
+    auto root = parse_program("pa x = x * x / 3 + x / 7;\n"
+                              "pb x = pa x + pa (x + 1);\n"
+                              "pc x = pb x + pb (x + 1);\n"
+                              "pd x = pc x + pc (x + 1);\n"
+                              "pd 5;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+
+    // `pb` is called four times and `pc` twice; `pa` makes no calls, so looking it up would cost as much as computing it
+    BOOST_TEST(memoize_functions(program, 4) == 1);
+    BOOST_TEST(program[2].memoized());
+    BOOST_TEST(memoize_functions(program, 2) == 1);
+    BOOST_TEST(program[3].memoized());
+    BOOST_TEST(memoize_functions(program, 1) == 1);
+    BOOST_TEST(!program[1].memoized());
+
+    // the table of a memoized function is reserved in .bss and its body is reached only when the lookup misses
+    auto outputASM = gen_program_asm(gen_program_code(program));
+    BOOST_TEST(outputASM.find("u_pb:\nmov ecx, eax\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("mov ebx, memo_pb\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("call .memo_compute\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("section .bss\nalignb 16\nmemo_pb: resb") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("memo_pa") == std::string::npos, outputASM);
+
+    // the code refers to each table through a relocation: an absolute address on x86, PC-relative on x86-64
+    auto machineCode = encode_instructions(gen_program_code(program), Target::X86);
+    BOOST_TEST(machineCode.data_labels().size() == 3u);
+    BOOST_TEST(machineCode.relocations().size() == 3u);
+    for (const auto& label : machineCode.data_labels())
+        BOOST_TEST(label.second % 16 == 0u);
+    auto object = gen_elf_object(machineCode, Target::X86);
+    BOOST_TEST(object.find(".rel.text") != std::string::npos);
+    BOOST_TEST(object.find(".bss") != std::string::npos);
+    machineCode = encode_instructions(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(gen_elf_object(machineCode, Target::X86_64).find(".rela.text") != std::string::npos);
+
+#if defined(__x86_64__)
+    auto plain = gen_ir(root.get(), symbols);
+    BOOST_TEST(JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64)}.run() ==
+               JitProgram{gen_program_code(plain, nullptr, nullptr, Target::X86_64)}.run());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(strictness_test) {
+    SymbolTable symbols;
+    auto root = parse_program("first x y = x;\n"
+                              "pick a b c = first (a + b) (c * b) + first b (a / b);\n"
+                              "spin x y = spin x (y / 2);\n"
+                              "pick 1 2 3 + pick 4 5 6;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+
+    // `c` is only used by an argument for `y`, which `first` never evaluates, while `b` is also used by a division,
+    // which may trap; `spin` only passes its parameters on to itself
+    auto strictness = StrictnessAnalysis::run(program);
+    BOOST_TEST((strictness[1] == std::vector<bool>{true, false}));
+    BOOST_TEST((strictness[2] == std::vector<bool>{true, true, false}));
+    BOOST_TEST((strictness[3] == std::vector<bool>{false, false}));
+
+    BOOST_TEST(eliminate_dead_arguments(program, strictness) == 4);
+    BOOST_TEST(eliminate_dead_arguments(program, StrictnessAnalysis::run(program)) == 0);
+    for (auto v : program[0].linear_order()) {
+        if (program[0].instruction(v).opcode() == IROpcode::CALL)
+            BOOST_TEST(program[0].instruction(v).operand_count() == 2);
+    }
+
+    // the division computing the argument that is no longer passed is kept, since it may trap
+    auto divisions = 0;
+    for (auto v : program[2].linear_order())
+        divisions += program[2].instruction(v).opcode() == IROpcode::DIVIDE;
+    BOOST_TEST(divisions == 1);
+
+#if defined(__x86_64__)
+    BOOST_TEST(JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64)}.run() == 5 + 14);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(parallelization_test) {
+    SymbolTable symbols;
+    auto root = parse_program("wa x = x * x / 3 + x / 7;\n"
+                              "wb x = wa x + wa (x + 1);\n"
+                              "wb 1 + wb 2 + wb 3;\n", &symbols);
+    auto program = gen_ir(root.get(), symbols);
+
+    // the first two calls of `wb` run while the last one is computed; the calls of `wa` are too cheap to be worth it
+    BOOST_TEST(parallelize_calls(program, 15) == 2);
+    auto spawns = 0;
+    auto joins = 0;
+    for (auto v : program[0].linear_order()) {
+        const auto& instruction = program[0].instruction(v);
+        spawns += instruction.opcode() == IROpcode::SPAWN;
+        if (instruction.opcode() == IROpcode::JOIN) {
+            BOOST_TEST((program[0].instruction(program[0].operand(v, 0)).opcode() == IROpcode::SPAWN));
+            joins++;
+        }
+    }
+    BOOST_TEST(spawns == 2);
+    BOOST_TEST(joins == 2);
+    BOOST_TEST(parallelize_calls(program, 15) == 0);
+
+    // neither are the calls of memoized functions, nor calls on either side of one that never returns
+    auto memoized = gen_ir(root.get(), symbols);
+    memoized[2].set_memoized(true);
+    BOOST_TEST(parallelize_calls(memoized, 15) == 0);
+    SymbolTable spinSymbols;
+    auto spinning = gen_ir(parse_program("spin x = spin (x + 1);\nwa x = x * x / 3 + x / 7;\nwa 2 + spin 1 + wa 3;\n",
+                                         &spinSymbols).get(), spinSymbols);
+    BOOST_TEST(parallelize_calls(spinning, 1) == 0);
+
+    // on x86-64, the program starts a pool of worker threads; 32-bit code makes the calls one after the other
+    auto outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64, 3));
+    BOOST_TEST(outputASM.find("call tuc_start_workers\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("call tuc_spawn\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("call tuc_join\n") != std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("tuc_pool: resb") != std::string::npos, outputASM);
+    outputASM = gen_program_asm(gen_program_code(program));
+    BOOST_TEST(outputASM.find("tuc_spawn") == std::string::npos, outputASM);
+    BOOST_TEST(outputASM.find("call u_wb\n") != std::string::npos, outputASM);
+
+    // only the system calls without an operand end the program
+    BOOST_TEST(is_exit(AsmInstruction{AsmOpcode::SYSCALL}));
+    BOOST_TEST(!is_exit(AsmInstruction{AsmOpcode::SYSCALL, {AsmOperand::imm(202)}}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::XCHG, {AsmOperand::mem(Register::SI), AsmOperand::reg(Register::CX)}}, Target::X86_64) ==
+                std::vector<std::uint8_t>{0x87, 0x0e}));
+
+#if defined(__x86_64__)
+    // the results are joined in program order, so they are the same whatever the number of threads
+    auto plain = gen_ir(root.get(), symbols);
+    auto expected = JitProgram{gen_program_code(plain, nullptr, nullptr, Target::X86_64)}.run();
+    for (auto workers : {0, 1, 3})
+        BOOST_TEST(JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64, workers)}.run() == expected);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(x86_encoder_test) {
+    using Bytes = std::vector<std::uint8_t>;
+    auto eax = AsmOperand::reg(Register::AX);
+    auto ecx = AsmOperand::reg(Register::CX);
+    auto r9 = AsmOperand::reg(Register::R9);
+
+    // the bytes nasm assembles for each instruction
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::MOV, {eax, ecx}}, Target::X86) == Bytes{0x89, 0xc8}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::ADD, {eax, AsmOperand::imm(1)}}, Target::X86) == Bytes{0x83, 0xc0, 0x01}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::ADD, {eax, AsmOperand::imm(1000)}}, Target::X86) == Bytes{0x05, 0xe8, 0x03, 0x00, 0x00}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::SUB, {ecx, AsmOperand::imm(1000)}}, Target::X86) == Bytes{0x81, 0xe9, 0xe8, 0x03, 0x00, 0x00}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::IMUL, {eax, AsmOperand::imm(5)}}, Target::X86) == Bytes{0x6b, 0xc0, 0x05}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::SHL, {ecx, AsmOperand::imm(1)}}, Target::X86) == Bytes{0xd1, 0xe1}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::SAR, {ecx, AsmOperand::imm(31)}}, Target::X86) == Bytes{0xc1, 0xf9, 0x1f}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::LEA, {eax, AsmOperand::mem(Register::CX, Register::AX, 4, 7)}}, Target::X86) == Bytes{0x8d, 0x44, 0x81, 0x07}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::MOV, {AsmOperand::mem(Register::BP, -4), eax}}, Target::X86) == Bytes{0x89, 0x45, 0xfc}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::IDIV, {AsmOperand::mem(Register::SP)}}, Target::X86) == Bytes{0xf7, 0x3c, 0x24}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::PUSH, {AsmOperand::imm(7)}}, Target::X86) == Bytes{0x6a, 0x07}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::INT, {AsmOperand::imm(0x80)}}, Target::X86) == Bytes{0xcd, 0x80}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::ADD, {r9, eax}}, Target::X86_64) == Bytes{0x41, 0x01, 0xc1}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::PUSH, {r9}, 8}, Target::X86_64) == Bytes{0x41, 0x51}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::MOVSXD, {ecx, eax}, 8}, Target::X86_64) == Bytes{0x48, 0x63, 0xc8}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(2454267027)}, 8}, Target::X86_64) == Bytes{0xb8, 0x93, 0x24, 0x49, 0x92}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(-5)}, 8}, Target::X86_64) == Bytes{0x48, 0xc7, 0xc0, 0xfb, 0xff, 0xff, 0xff}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::SYSCALL}, Target::X86_64) == Bytes{0x0f, 0x05}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::CMP, {AsmOperand::mem(Register::BX, 4), eax}}, Target::X86) == Bytes{0x39, 0x43, 0x04}));
+    BOOST_TEST((encode_instruction(AsmInstruction{AsmOpcode::CMP, {AsmOperand::mem(Register::BX), AsmOperand::imm(0)}}, Target::X86) == Bytes{0x83, 0x3b, 0x00}));
+    BOOST_CHECK_THROW(encode_instruction(AsmInstruction{AsmOpcode::ADD, {r9, eax}}, Target::X86), CompilerException::InvalidInstruction);
+
+    // an operand without a location is a value the code generator lost track of, which neither prints nor encodes
+    auto lost = AsmInstruction{AsmOpcode::MOV, {ecx, AsmOperand{}}};
+    BOOST_CHECK_THROW(encode_instruction(lost, Target::X86), CompilerException::InvalidInstruction);
+    auto printed = std::ostringstream{};
+    BOOST_CHECK_THROW(put_instruction(printed, lost, Target::X86), CompilerException::InvalidInstruction);
+
+    // a jump is short unless its label is more than 127 bytes away
+    auto code = AsmList{
+        AsmInstruction{AsmOpcode::LABEL, {AsmOperand::label("_start")}},
+        AsmInstruction{AsmOpcode::JMP, {AsmOperand::label(".far")}}
+    };
+    for (int i = 0; i < 30; i++)
+        code.emplace_back(AsmOpcode::ADD, std::vector<AsmOperand>{ecx, AsmOperand::imm(1000)});
+    code.emplace_back(AsmOpcode::LABEL, std::vector<AsmOperand>{AsmOperand::label(".near")});
+    code.emplace_back(AsmOpcode::ADD, std::vector<AsmOperand>{ecx, AsmOperand::imm(1000)});
+    code.emplace_back(AsmOpcode::JMP, std::vector<AsmOperand>{AsmOperand::label(".near")});
+    code.emplace_back(AsmOpcode::LABEL, std::vector<AsmOperand>{AsmOperand::label(".far")});
+    auto machineCode = encode_instructions(code, Target::X86);
+    const auto& bytes = machineCode.bytes();
+    BOOST_TEST(bytes.size() == 5u + 31u * 6u + 2u);
+    BOOST_TEST(bytes[0] == 0xe9);
+    BOOST_TEST(bytes[bytes.size() - 2] == 0xeb);
+    BOOST_TEST(machineCode.labels().back().first == "_start.far");
+    BOOST_TEST(machineCode.labels().back().second == bytes.size());
+
+    auto object = gen_elf_object(machineCode, Target::X86_64);
+    BOOST_TEST(object.compare(0, 4, "\x7f" "ELF") == 0);
+    BOOST_TEST(object[4] == 2);                         // 64-bit
+    BOOST_TEST(object.find("_start.far") != std::string::npos);
+    BOOST_TEST(object.find(std::string(bytes.cbegin(), bytes.cend())) != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(elf_executable_test) {
+    auto code = AsmList{
+        AsmInstruction{AsmOpcode::LABEL, {AsmOperand::label("_start")}},
+        AsmInstruction{AsmOpcode::MOV, {AsmOperand::reg(Register::BX), AsmOperand::imm(3)}},
+        AsmInstruction{AsmOpcode::MOV, {AsmOperand::reg(Register::AX), AsmOperand::imm(1)}},
+        AsmInstruction{AsmOpcode::INT, {AsmOperand::imm(0x80)}}
+    };
+    auto machineCode = encode_instructions(code, Target::X86);
+    auto executable = gen_elf_executable(machineCode, Target::X86);
+    auto field = [&](std::size_t offset, int size) {
+        auto value = 0u;
+        for (int i = size - 1; i >= 0; i--)
+            value = (value << 8) | static_cast<std::uint8_t>(executable[offset + i]);
+        return value;
+    };
+    BOOST_TEST(executable.compare(0, 4, "\x7f" "ELF") == 0);
+    BOOST_TEST(field(16, 2) == 2u);                     // an executable
+    BOOST_TEST(field(44, 2) == 1u);                     // with one segment
+    auto entry = field(24, 4);
+    auto programHeader = field(28, 4);
+    BOOST_TEST(field(programHeader, 4) == 1u);          // loaded
+    auto segmentAddress = field(programHeader + 8, 4);
+    BOOST_TEST(entry > segmentAddress);
+    BOOST_TEST(field(programHeader + 16, 4) == entry - segmentAddress + machineCode.bytes().size());
+    BOOST_TEST(executable.compare(entry - segmentAddress, machineCode.bytes().size(),
+                                  std::string(machineCode.bytes().cbegin(), machineCode.bytes().cend())) == 0);
+}
+
+#if defined(__x86_64__)
+BOOST_AUTO_TEST_CASE(jit_test) {
+    // a sum of 16 values live at once, which spills and uses every register the caller expects to be preserved
+    auto program = IRProgram{};
+    program.emplace_back("_start");
+    auto& function = program.back();
+    auto block = function.add_block();
+    auto constant = [&](std::int32_t value) { return function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, value); };
+    auto sums = std::vector<ValueId>{};
+    for (int i = 0; i < 16; i++)
+        sums.push_back(function.append(block, IROpcode::ADD, IRType::INT32, {constant(i), constant(-1000 * i)}));
+    auto total = sums.back();
+    for (auto sum = sums.rbegin() + 1; sum != sums.rend(); sum++)
+        total = function.append(block, IROpcode::ADD, IRType::INT32, {*sum, total});
+    auto quotient = function.append(block, IROpcode::DIVIDE, IRType::INT32, {total, constant(7)});
+    function.append(block, IROpcode::EXIT, IRType::VOID, {quotient});
+
+    auto code = gen_program_code(program, nullptr, nullptr, Target::X86_64);
+    const JitProgram jitProgram{code};
+    BOOST_TEST(jitProgram.run() == -119880 / 7);    // all 32 bits of the value, not an exit status
+    BOOST_TEST(jitProgram.run() == -119880 / 7);
+
+    // the symbols of the perf map cover the code from the entry of the function to its end, one after the other
+    auto perfMap = std::stringstream{};
+    jitProgram.write_perf_map(perfMap);
+    auto names = std::vector<std::string>{};
+    auto end = reinterpret_cast<std::uintptr_t>(jitProgram.address());
+    auto address = std::uintptr_t{};
+    auto size = std::size_t{};
+    auto name = std::string{};
+    while (perfMap >> std::hex >> address >> size >> name) {
+        BOOST_TEST(address == end);
+        end = address + size;
+        names.push_back(name);
+    }
+    BOOST_TEST(end == reinterpret_cast<std::uintptr_t>(jitProgram.address()) + jitProgram.size());
+    BOOST_TEST(names.front() == "tuc_jit_entry");
+    BOOST_TEST(names.back() == "_start.block0");
+
+    // 32-bit code exits with `int 80h`, which cannot be run in-process
+    BOOST_CHECK_THROW(JitProgram{gen_program_code(program)}, CompilerException::InvalidInstruction);
+}
+#endif
+
+BOOST_AUTO_TEST_CASE(bytecode_test) {
+    auto root = get_syntax_tree();
+    auto code = gen_bytecode(root.get());
+    auto exitValue = std::int32_t{};
+    BOOST_TEST(run_bytecode(code, exitValue));
+    BOOST_TEST(exitValue == 8);
+
+    // operations with a literal operand are single superinstructions, and (3*4 + 4*5)/(2*3 - 1*2) needs 3 registers
+    auto text = std::stringstream{};
+    text << code;
+    BOOST_TEST(text.str().find("r0 = r0 * 4\n") != std::string::npos, text.str());
+    BOOST_TEST(text.str().find("r1 = r1 * 5\n") != std::string::npos, text.str());
+    BOOST_TEST(text.str().find("r0 = r0 / r1\n") != std::string::npos, text.str());
+    BOOST_TEST(code.register_count() == 3);
+
+    // the bytecode is an oracle for the code generated from the IR: both agree on the values and the traps
+    auto generator = std::mt19937{42};
+    auto traps = 0;
+    for (int i = 0; i < 2000; i++) {
+        auto program = std::make_unique<SyntaxNode>(SyntaxNode::NodeType::PROGRAM);
+        program->append_child(random_syntax_tree(generator, 6));
+        auto ir = gen_ir(program.get(), SymbolTable{});
+        auto expected = std::int32_t{};
+        auto irTraps = !run_block(ir.front(), {}, expected);
+        auto bytecodeTraps = !run_bytecode(gen_bytecode(program.get()), exitValue);
+        BOOST_TEST(bytecodeTraps == irTraps);
+        if (!irTraps)
+            BOOST_TEST(exitValue == expected);
+        traps += irTraps;
+    }
+    BOOST_TEST(traps > 0);
+}
+
+BOOST_AUTO_TEST_CASE(c_generator_test) {
+    auto root = get_syntax_tree();
+    auto c = gen_program_c(root.get());
+    BOOST_TEST(c.find("#include <stdint.h>") != std::string::npos, c);
+    BOOST_TEST(c.find("int main(void) {") != std::string::npos, c);
+    BOOST_TEST(c.find("    value = (uint32_t)(UINT32_C(1) + UINT32_C(2));\n") != std::string::npos, c);
+    BOOST_TEST(c.find("(uint32_t)((unsigned long long)UINT32_C(3) * UINT32_C(4))") != std::string::npos, c);
+    BOOST_TEST(c.find("tuc_divide(") != std::string::npos, c);
+    BOOST_TEST(c.find("raise(SIGFPE)") != std::string::npos, c);
+    BOOST_TEST(c.find("function_a") == std::string::npos, c);     // declarations are not code
+
+    // programs that never divide need neither the division nor signals
+    auto program = std::make_unique<SyntaxNode>(SyntaxNode::NodeType::PROGRAM);
+    program->append_child(std::make_unique<SyntaxNode>(SyntaxNode::NodeType::INTEGER, TextEntity{"7", "", 0, 1, 1}));
+    c = gen_program_c(program.get());
+    BOOST_TEST(c.find("tuc_divide") == std::string::npos, c);
+    BOOST_TEST(c.find("signal.h") == std::string::npos, c);
+    BOOST_TEST(c.find("    value = UINT32_C(7);\n") != std::string::npos, c);
+}
+
+BOOST_AUTO_TEST_CASE(column_kernel_test) {
+    // rows that are not a multiple of a block or of a vector, with the values where arithmetic wraps around
+    auto generator = std::mt19937{7};
+    const auto rows = ColumnKernel::block_size * 2 + 13;
+    auto x = std::vector<std::int32_t>(rows);
+    auto y = std::vector<std::int32_t>(rows);
+    static const std::int32_t edges[] = {0, 1, -1, 2, -7, std::numeric_limits<std::int32_t>::min(),
+                                         std::numeric_limits<std::int32_t>::max()};
+    for (std::size_t i = 0; i < rows; i++) {
+        x[i] = i % 5 == 0 ? edges[generator() % 7] : static_cast<std::int32_t>(generator());
+        y[i] = i % 3 == 0 ? edges[generator() % 7] : static_cast<std::int32_t>(generator() % 2001) - 1000;
+        if (y[i] == 0 || (y[i] == -1 && x[i] == std::numeric_limits<std::int32_t>::min()))
+            y[i] = 3;   // no row traps
+    }
+
+    auto output = std::vector<std::int32_t>(rows);
+    auto expected = std::vector<std::int32_t>(rows);
+    auto levels = std::vector<SimdLevel>{SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+    for (int i = 0; i < 300; i++) {
+        auto tree = random_syntax_tree(generator, 5, {"x", "y"});
+        auto traps = false;
+        for (std::size_t row = 0; row < rows; row++)
+            traps |= !evaluate_tree(tree.get(), {{"x", x[row]}, {"y", y[row]}}, expected[row]);
+
+        for (auto level : levels) {
+            auto kernel = ColumnKernel{tree.get(), {"x", "y"}, level};
+            BOOST_TEST((kernel.simd_level() <= std::max(level, best_simd_level())));
+            BOOST_TEST(kernel.evaluate({x.data(), y.data()}, output.data(), rows) == !traps);
+            if (!traps)
+                BOOST_TEST((output == expected), simd_level_name(kernel.simd_level()));
+        }
+    }
+
+    // a divisor of 0 in the last row, after the rows done with vectors
+    auto tree = std::make_unique<SyntaxNode>(SyntaxNode::NodeType::DIVIDE, TextEntity{"/", "", 0, 1, 1});
+    tree->append_child(std::make_unique<SyntaxNode>(SyntaxNode::NodeType::IDENTIFIER, TextEntity{"x", "", 0, 1, 1}));
+    tree->append_child(std::make_unique<SyntaxNode>(SyntaxNode::NodeType::IDENTIFIER, TextEntity{"y", "", 0, 1, 1}));
+    y.back() = 0;
+    for (auto level : levels)
+        BOOST_TEST(!ColumnKernel(tree.get(), {"x", "y"}, level).evaluate({x.data(), y.data()}, output.data(), rows));
+    BOOST_TEST(ColumnKernel(tree.get(), {"x", "y"}).operation_count() == 1);
+
+    BOOST_CHECK_THROW(ColumnKernel(tree.get(), {"x"}), CompilerException::UnknownSymbol);
+}
+
+BOOST_AUTO_TEST_CASE(peephole_test) {
+    auto eax = AsmOperand::reg(Register::AX);
+    auto ecx = AsmOperand::reg(Register::CX);
+    auto exit = AsmList{
+        AsmInstruction{AsmOpcode::MOV, {AsmOperand::reg(Register::BX), eax}},
+        AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(1)}},
+        AsmInstruction{AsmOpcode::INT, {AsmOperand::imm(0x80)}}
+    };
+
+    // 5 - eax
+    auto code = AsmList{
+        AsmInstruction{AsmOpcode::MOV, {ecx, AsmOperand::imm(5)}},
+        AsmInstruction{AsmOpcode::SUB, {ecx, eax}},
+        AsmInstruction{AsmOpcode::MOV, {eax, ecx}}
+    };
+    code.insert(code.end(), exit.begin(), exit.end());
+    auto stats = peephole_optimize(code);
+    BOOST_TEST(stats.size() == peephole_rule_names().size());
+    BOOST_TEST(stats["reverse-subtract"] == 1);
+    BOOST_TEST(code.size() == 5u);
+    BOOST_TEST((code[0].opcode() == AsmOpcode::NEG));
+
+    // (2 + 3) * 4
+    code = AsmList{
+        AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(2)}},
+        AsmInstruction{AsmOpcode::ADD, {eax, AsmOperand::imm(3)}},
+        AsmInstruction{AsmOpcode::SHL, {eax, AsmOperand::imm(2)}}
+    };
+    code.insert(code.end(), exit.begin(), exit.end());
+    stats = peephole_optimize(code);
+    BOOST_TEST(stats["constant-fold"] == 2);
+    BOOST_TEST((code.front().opcode() == AsmOpcode::MOV));
+    BOOST_TEST(code.front().operand(1).value() == 20);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_test) {
+    auto eax = AsmOperand::reg(Register::AX);
+    auto ecx = AsmOperand::reg(Register::CX);
+
+    // (3*3)*(3*3) + (5*5)*(5*5), one chain after the other
+    auto code = AsmList{
+        AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(3)}},
+        AsmInstruction{AsmOpcode::IMUL, {eax, eax}},
+        AsmInstruction{AsmOpcode::IMUL, {eax, eax}},
+        AsmInstruction{AsmOpcode::MOV, {ecx, AsmOperand::imm(5)}},
+        AsmInstruction{AsmOpcode::IMUL, {ecx, ecx}},
+        AsmInstruction{AsmOpcode::IMUL, {ecx, ecx}},
+        AsmInstruction{AsmOpcode::ADD, {eax, ecx}},
+        AsmInstruction{AsmOpcode::MOV, {AsmOperand::reg(Register::BX), eax}},
+        AsmInstruction{AsmOpcode::MOV, {eax, AsmOperand::imm(1)}},
+        AsmInstruction{AsmOpcode::INT, {AsmOperand::imm(0x80)}}
+    };
+    BOOST_TEST(instruction_latency(code[1]) > instruction_latency(code[0]));
+    auto result = schedule_instructions(code);
+    BOOST_TEST(result.moved() > 0);
+    BOOST_TEST(result.cycles_after() < result.cycles_before());
+    BOOST_TEST(result.cycles_after() == estimate_cycles(code));
+    BOOST_TEST(code.size() == 10u);
+
+    // the two chains are interleaved, but each one keeps its order and the sum still comes after both
+    auto position = [&](AsmOpcode opcode, const AsmOperand& destination, int nth) {
+        for (auto i = 0u; i < code.size(); i++)
+            if (code[i].opcode() == opcode && code[i].operand(0) == destination && nth-- == 0)
+                return static_cast<int>(i);
+        return -1;
+    };
+    BOOST_TEST(position(AsmOpcode::IMUL, ecx, 0) < position(AsmOpcode::IMUL, eax, 1));
+    BOOST_TEST(position(AsmOpcode::IMUL, eax, 1) < position(AsmOpcode::ADD, eax, 0));
+    BOOST_TEST(position(AsmOpcode::IMUL, ecx, 1) < position(AsmOpcode::ADD, eax, 0));
+    BOOST_TEST((code.back().opcode() == AsmOpcode::INT));
+
+    // the `cmp` is ready first, but no instruction writing the flags may come between it and the `je` reading them
+    auto edx = AsmOperand::reg(Register::DX);
+    code = AsmList{
+        AsmInstruction{AsmOpcode::IMUL, {ecx, ecx}},
+        AsmInstruction{AsmOpcode::IMUL, {ecx, ecx}},
+        AsmInstruction{AsmOpcode::IMUL, {edx, edx}},
+        AsmInstruction{AsmOpcode::IMUL, {edx, edx}},
+        AsmInstruction{AsmOpcode::CMP, {eax, AsmOperand::imm(0)}},
+        AsmInstruction{AsmOpcode::JE, {AsmOperand::label(".block1")}},
+        AsmInstruction{AsmOpcode::LABEL, {AsmOperand::label(".block1")}}
+    };
+    result = schedule_instructions(code);
+    BOOST_TEST(result.moved() > 0);
+    BOOST_TEST((code[4].opcode() == AsmOpcode::CMP));
+    BOOST_TEST((code[5].opcode() == AsmOpcode::JE));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include <boost/test/unit_test.hpp>
 
 #include "tuc_unit_tests.hpp"
+#include "compiler_exceptions.hpp"
 
 // c++ standard libraries
 #include <tuple>
@@ -85,4 +86,43 @@ BOOST_AUTO_TEST_CASE(parser_test) {
     BOOST_TEST(expectedNodes.empty() == actualNodes.empty());
 }
 
+BOOST_AUTO_TEST_CASE(function_test) {
+    SymbolTable symbols;
+    auto root = parse_program("f : int int -> int;\nf a b = a * g b;\ng x = x + 1;\nf 2 (g 3) - g 4;\n", &symbols);
+    BOOST_TEST(root->child_count() == 4);
+    BOOST_TEST(symbols.at("f").arg_count() == 2);
+    BOOST_TEST(symbols.at("g").arg_count() == 1);
+
+    // a definition assigns the body to a call of the function on its parameters
+    auto definition = root->child(1);
+    BOOST_TEST((definition->type() == SyntaxNode::NodeType::ASSIGN));
+    BOOST_TEST((definition->child(0)->type() == SyntaxNode::NodeType::CALL));
+    BOOST_TEST(definition->child(0)->value() == "f");
+    BOOST_TEST(definition->child(0)->child_count() == 2);
+    BOOST_TEST(definition->child(0)->child(1)->value() == "b");
+
+    // application binds tighter than any operator
+    auto body = definition->child(1);
+    BOOST_TEST((body->type() == SyntaxNode::NodeType::MULTIPLY));
+    BOOST_TEST((body->child(0)->type() == SyntaxNode::NodeType::IDENTIFIER));
+    BOOST_TEST((body->child(1)->type() == SyntaxNode::NodeType::CALL));
+    BOOST_TEST(body->child(1)->child(0)->value() == "b");
+
+    auto expression = root->child(3);
+    BOOST_TEST((expression->type() == SyntaxNode::NodeType::SUBTRACT));
+    auto call = expression->child(0);
+    BOOST_TEST(call->value() == "f");
+    BOOST_TEST(call->child_count() == 2);
+    BOOST_TEST((call->child(1)->type() == SyntaxNode::NodeType::CALL));
+    BOOST_TEST(call->child(1)->child(0)->value() == "3");
+
+    BOOST_CHECK_THROW(parse_program("f x = 1;\nf y = 2;\n"), CompilerException::Redefinition);
+    BOOST_CHECK_THROW(parse_program("f x y = x;\nf x x = x;\n"), CompilerException::Redefinition);
+    BOOST_CHECK_THROW(parse_program("f : int -> int;\nf x y = x;\n"), CompilerException::ArgumentCountMismatch);
+    BOOST_CHECK_THROW(parse_program("f x = x;\nf 1 2;\n"), CompilerException::ArgumentCountMismatch);
+    BOOST_CHECK_THROW(parse_program("f x = y;\n"), CompilerException::UnknownSymbol);
+    BOOST_CHECK_THROW(parse_program("f x = g x;\n"), CompilerException::UnknownSymbol);
+    BOOST_CHECK_NO_THROW(parse_program("f x = g x;\ng x = 2 * x;\nf 1;\n"));   // used before it is defined
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,120 @@
+/*
+Project: OGLA
+File: pass_manager_tests.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description: A collection of unit tests for the lexer, syntax tree generator,
+    and assembly code generator. These unit tests use the Boos Test framework.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "tuc_unit_tests.hpp"
+#include "pass_manager.hpp"
+#include "ir_analysis.hpp"
+#include "compiler_exceptions.hpp"
+
+// c++ standard libraries
+#include <memory>
+#include <string>
+
+
+
+//~test passes~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+/*
+uses the use-count analysis and reports that it changed the program if it was created to do so
+*/
+class AnalysisUserPass : public IRPass {
+    public:
+        AnalysisUserPass(const std::string& _name, bool _reportsChange) : passName{_name}, reportsChange{_reportsChange} {}
+
+        std::string name() const override {
+            return passName;
+        }
+
+        bool run(IRProgram& program, AnalysisManager& analyses) override {
+            analyses.get<UseCountAnalysis>(program);
+            return reportsChange;
+        }
+
+    private:
+        std::string passName;
+        bool reportsChange;
+};
+
+
+
+//~test cases~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+BOOST_AUTO_TEST_SUITE(pass_manager_tests)
+
+BOOST_AUTO_TEST_CASE(optimization_level_test) {
+    auto passes = standard_pipeline();
+    BOOST_TEST(passes.is_enabled("peephole"));
+
+    passes.set_level(0);
+    BOOST_TEST(!passes.is_enabled("peephole"));
+    passes.set_enabled("peephole", true);
+    BOOST_TEST(passes.is_enabled("peephole"));
+
+    passes.set_level(max_optimization_level);
+    passes.set_enabled("peephole", false);
+    BOOST_TEST(!passes.is_enabled("peephole"));
+
+    BOOST_CHECK_THROW(passes.set_level(max_optimization_level + 1), CompilerException::InvalidOption);
+    BOOST_CHECK_THROW(passes.set_enabled("no-such-pass", true), CompilerException::InvalidOption);
+}
+
+BOOST_AUTO_TEST_CASE(analysis_cache_test) {
+    auto root = get_syntax_tree();
+    auto program = gen_ir(root.get(), SymbolTable{});
+
+    // the result is computed once and reused until it is invalidated
+    auto analyses = AnalysisManager{};
+    const auto& uses = analyses.get<UseCountAnalysis>(program);
+    BOOST_TEST(uses.size() == 1u);
+    auto exit = program.front().block(1).instructions().back();
+    BOOST_TEST(uses.front()[program.front().operand(exit, 0)] == 1);
+    analyses.get<UseCountAnalysis>(program);
+    BOOST_TEST(analyses.computation_count() == 1);
+    analyses.invalidate();
+    analyses.get<UseCountAnalysis>(program);
+    BOOST_TEST(analyses.computation_count() == 2);
+
+    // the pass manager invalidates the results whenever a pass changes the program
+    auto passes = PassManager{};
+    passes.add_pass(std::unique_ptr<IRPass>{new AnalysisUserPass{"first", true}}, 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new AnalysisUserPass{"second", false}}, 1);
+    passes.add_pass(std::unique_ptr<IRPass>{new AnalysisUserPass{"third", false}}, 1);
+    passes.run(program);
+    BOOST_TEST(passes.analyses().computation_count() == 2);   // only the first pass changed the program
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,288 @@
+/*
+Project: OGLA
+File: strength_reduction_tests.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description: A collection of unit tests for the lexer, syntax tree generator,
+    and assembly code generator. These unit tests use the Boos Test framework.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "tuc_unit_tests.hpp"
+#include "strength_reduction.hpp"
+
+// c++ standard libraries
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+const auto int_min = std::numeric_limits<std::int32_t>::min();
+const auto int_max = std::numeric_limits<std::int32_t>::max();
+
+/*
+the number of parameters that, added to the result, keep every register but one busy when it is computed; the
+division then has to use edx:eax like the 32-bit code does
+*/
+const auto busy_parameters = 13;
+
+std::int32_t wrap(std::int64_t value) {
+    return static_cast<std::int32_t>(static_cast<std::uint32_t>(static_cast<std::uint64_t>(value)));
+}
+
+/*
+computes what `mov edx, M / imul edx / [add|sub edx, n] / sar edx, s / mov eax, edx / shr eax, 31 / add edx, eax`
+leaves in edx, so that the magic numbers of many more divisors can be checked than can be JIT-compiled
+*/
+std::int32_t magic_divide(std::int32_t n, const DivisionMagic& magic) {
+    auto product = static_cast<std::int64_t>(magic.multiplier()) * n;
+    auto q = static_cast<std::int32_t>(product >> 32);
+    q = wrap(static_cast<std::int64_t>(q) + magic.correction() * static_cast<std::int64_t>(n));
+    q >>= magic.shift();
+    return wrap(static_cast<std::int64_t>(q) + (static_cast<std::uint32_t>(q) >> 31));
+}
+
+/*
+returns a function computing `x opcode constant`, plus the `padding` parameters after `x`
+*/
+IRFunction constant_operation(const std::string& name, IROpcode opcode, std::int32_t constant, int padding) {
+    auto function = IRFunction{name};
+    auto block = function.add_block();
+    auto parameters = std::vector<ValueId>{};
+    for (auto p = 0; p <= padding; p++)
+        parameters.push_back(function.append(block, IROpcode::PARAMETER, IRType::INT32, {}, p));
+    auto result = function.append(block, opcode, IRType::INT32,
+                                  {parameters[0], function.append(block, IROpcode::CONSTANT, IRType::INT32, {}, constant)});
+    for (auto p = 1; p <= padding; p++)
+        result = function.append(block, IROpcode::ADD, IRType::INT32, {result, parameters[p]});
+    function.append(block, IROpcode::RETURN, IRType::VOID, {result});
+    return function;
+}
+
+/*
+a call of a function of the program (its index) with the value of `x`, and the weight its result is multiplied by
+*/
+struct WeightedCall {
+    int function;
+    std::int32_t argument;
+    std::int32_t weight;
+};
+
+/*
+JIT-compiles the functions of `program` (its first one is replaced) and returns the sum of the results of the calls,
+each multiplied by its weight; the padding parameters of the functions are all 0
+*/
+std::int32_t run_calls(IRProgram& program, const std::vector<WeightedCall>& calls, int padding) {
+    auto main = IRFunction{"main"};
+    auto block = main.add_block();
+    auto sum = main.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 0);
+    for (const auto& call : calls) {
+        auto arguments = std::vector<ValueId>{main.append(block, IROpcode::CONSTANT, IRType::INT32, {}, call.argument)};
+        for (auto p = 0; p < padding; p++)
+            arguments.push_back(main.append(block, IROpcode::CONSTANT, IRType::INT32, {}, 0));
+        auto result = main.append(block, IROpcode::CALL, IRType::INT32, arguments, call.function);
+        auto weight = main.append(block, IROpcode::CONSTANT, IRType::INT32, {}, call.weight);
+        sum = main.append(block, IROpcode::ADD, IRType::INT32,
+                          {sum, main.append(block, IROpcode::MULTIPLY, IRType::INT32, {result, weight})});
+    }
+    main.append(block, IROpcode::EXIT, IRType::VOID, {sum});
+    program[0] = main;
+    return JitProgram{gen_program_code(program, nullptr, nullptr, Target::X86_64)}.run();
+}
+
+/*
+runs the code generated for `x opcode constant` on each of the values of `x` for each of the constants, and reports
+the results that differ from `expected`; the results of a batch of constants are first checked all at once, as a
+sum with random odd weights, and only a batch whose sum is wrong is run again one call at a time
+*/
+template <typename Expected>
+void check_constant_operations(IROpcode opcode, const std::vector<std::int32_t>& constants,
+                               const std::vector<std::vector<std::int32_t>>& values, int padding, Expected expected) {
+    const auto batch = std::size_t{64};
+    auto generator = std::mt19937{42};
+    for (std::size_t first = 0; first < constants.size(); first += batch) {
+        auto program = IRProgram{IRFunction{"main"}};
+        auto calls = std::vector<WeightedCall>{};
+        auto expectedSum = std::uint32_t{0};
+        for (auto i = first; i < std::min(first + batch, constants.size()); i++) {
+            program.push_back(constant_operation("f" + std::to_string(i), opcode, constants[i], padding));
+            for (auto x : values[i]) {
+                auto weight = static_cast<std::int32_t>(generator() | 1);
+                calls.push_back(WeightedCall{static_cast<int>(program.size()) - 1, x, weight});
+                expectedSum += static_cast<std::uint32_t>(expected(x, constants[i])) * static_cast<std::uint32_t>(weight);
+            }
+        }
+        if (run_calls(program, calls, padding) == static_cast<std::int32_t>(expectedSum))
+            continue;
+
+        for (const auto& call : calls) {
+            auto constant = constants[first + call.function - 1];
+            auto single = IRProgram{IRFunction{"main"}, program[call.function]};
+            auto actual = run_calls(single, {WeightedCall{1, call.argument, 1}}, padding);
+            if (actual != expected(call.argument, constant))
+                BOOST_ERROR(call.argument << " " << opcode_name(opcode) << " " << constant << " gave " << actual
+                            << " instead of " << expected(call.argument, constant));
+        }
+    }
+}
+
+/*
+returns the dividends most likely to break a division sequence: the extremes of the 32-bit range and the values on
+either side of multiples of the divisor
+*/
+std::vector<std::int32_t> edge_dividends(std::int32_t divisor) {
+    auto values = std::vector<std::int64_t>{int_min, int_min + 1, int_min + 2, -2, -1, 0, 1, 2, int_max - 1, int_max};
+    auto d = static_cast<std::int64_t>(divisor);
+    auto lastMultiple = (int_max / d) * d;
+    for (auto multiple : {d, 2 * d, -d, -2 * d, lastMultiple, -lastMultiple, lastMultiple - d, d - lastMultiple}) {
+        for (auto offset : {-1, 0, 1})
+            values.push_back(multiple + offset);
+    }
+
+    auto dividends = std::vector<std::int32_t>{};
+    for (auto v : values) {
+        if (v >= int_min && v <= int_max)
+            dividends.push_back(static_cast<std::int32_t>(v));
+    }
+    return dividends;
+}
+
+std::vector<std::int32_t> edge_divisors() {
+    auto divisors = std::vector<std::int32_t>{};
+    for (std::int32_t d = 2; d <= 70000; d++) {
+        divisors.push_back(d);
+        divisors.push_back(-d);
+    }
+    for (std::int32_t d = int_max - 70000; d < int_max; d++)
+        divisors.push_back(d);
+    divisors.push_back(int_max);
+    divisors.push_back(int_min);
+    divisors.push_back(int_min + 1);
+    for (auto k = 17; k < 31; k++) {
+        for (auto offset : {-1, 1}) {
+            divisors.push_back((1 << k) + offset);
+            divisors.push_back(-((1 << k) + offset));
+        }
+    }
+    return divisors;
+}
+
+
+
+//~test cases~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+BOOST_AUTO_TEST_SUITE(strength_reduction_tests)
+
+BOOST_AUTO_TEST_CASE(magic_division_test) {
+    auto divisors = edge_divisors();
+    for (auto d : divisors) {
+        auto magic = division_magic(d);
+        for (auto n : edge_dividends(d)) {
+            auto actual = magic_divide(n, magic);
+            if (actual != n / d)
+                BOOST_ERROR(n << " / " << d << " gave " << actual << " instead of " << n / d);
+        }
+    }
+
+#if defined(__x86_64__)
+    // the 64-bit multiplication of x86-64, and the one in edx:eax that it falls back to without a spare register
+    auto program = IRProgram{IRFunction{"main"}, constant_operation("f", IROpcode::DIVIDE, 7, 0)};
+    auto outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(outputASM.find("movsxd") != std::string::npos, outputASM);
+    program[1] = constant_operation("f", IROpcode::DIVIDE, 7, busy_parameters);
+    outputASM = gen_program_asm(gen_program_code(program, nullptr, nullptr, Target::X86_64), Target::X86_64);
+    BOOST_TEST(outputASM.find("imul edx") != std::string::npos, outputASM);
+
+    // JIT-compiling all of them would take minutes, so the code runs on the small divisors, the largest ones, and
+    // those next to the powers of two above 2^16
+    auto sampled = std::vector<std::int32_t>{};
+    auto dividends = std::vector<std::vector<std::int32_t>>{};
+    for (auto d : divisors) {
+        if ((d < -256 && d >= -70000) || (d > 256 && d <= 70000) || (d >= int_max - 70000 && d < int_max - 64))
+            continue;
+        sampled.push_back(d);
+        dividends.push_back(edge_dividends(d));
+    }
+    auto quotient = [](std::int32_t n, std::int32_t d) { return n / d; };
+    check_constant_operations(IROpcode::DIVIDE, sampled, dividends, 0, quotient);
+    check_constant_operations(IROpcode::DIVIDE, sampled, dividends, busy_parameters, quotient);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(power_of_two_division_test) {
+    auto divisors = std::vector<std::int32_t>{};
+    auto dividends = std::vector<std::vector<std::int32_t>>{};
+    for (auto k = 1; k < 31; k++) {
+        auto d = static_cast<std::int32_t>(1) << k;
+        BOOST_TEST(power_of_two_exponent(d) == k);
+        BOOST_TEST(power_of_two_exponent(d + 1) == -1);
+        divisors.push_back(d);
+        dividends.push_back(edge_dividends(d));
+    }
+    BOOST_TEST(power_of_two_exponent(1) == -1);
+    BOOST_TEST(power_of_two_exponent(0) == -1);
+    BOOST_TEST(power_of_two_exponent(int_min) == -1);
+
+#if defined(__x86_64__)
+    auto quotient = [](std::int32_t n, std::int32_t d) { return n / d; };
+    check_constant_operations(IROpcode::DIVIDE, divisors, dividends, 0, quotient);
+    check_constant_operations(IROpcode::DIVIDE, divisors, dividends, busy_parameters, quotient);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(multiply_test) {
+    auto values = std::vector<std::int32_t>{int_min, int_min + 1, -65536, -3, -2, -1, 0, 1, 2, 3, 65535, 65536, int_max - 1, int_max};
+    auto constants = std::vector<std::int32_t>{};
+    for (std::int32_t c = 0; c <= 1 << 20; c++) {
+        if (!is_cheap_multiply(c))
+            continue;
+        BOOST_TEST(multiply_steps(c).size() <= 2u);
+        constants.push_back(c);
+    }
+    for (auto c : {0, 1, 2, 3, 5, 9, 10, 15, 45, 81, 1024, 1 << 30})
+        BOOST_TEST(is_cheap_multiply(c), c << " should be cheap");
+    for (auto c : {7, 11, 30, 1000, -2, int_max})
+        BOOST_TEST(!is_cheap_multiply(c), c << " should not be cheap");
+
+#if defined(__x86_64__)
+    auto products = std::vector<std::vector<std::int32_t>>(constants.size(), values);
+    check_constant_operations(IROpcode::MULTIPLY, constants, products, 0, [](std::int32_t n, std::int32_t c) {
+        return wrap(static_cast<std::int64_t>(n) * c);
+    });
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
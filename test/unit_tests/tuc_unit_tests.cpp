@@ -38,6 +38,11 @@ THE SOFTWARE.
 
 #include "tuc_unit_tests.hpp"
 
+// c++ standard libraries
+#include <cstdio>
+#include <fstream>
+#include <tuple>
+
 //BOOST_AUTO_TEST_SUITE(__phonny_no_tests_here)
 
 std::unique_ptr<SyntaxNode> get_syntax_tree() {
@@ -96,4 +101,19 @@ std::unique_ptr<SyntaxNode> get_syntax_tree() {
     return std::move(rootNode);
 }
 
+std::unique_ptr<SyntaxNode> parse_program(const std::string& text, SymbolTable* symbols) {
+    const auto path = std::string{"parsed_program.ul"};
+    std::ofstream{path} << text;
+    auto tokens = lex_analyze(path);
+    std::remove(path.c_str());
+
+    auto root = std::unique_ptr<SyntaxNode>{};
+    auto symbolTable = SymbolTable{};
+    std::tie(root, symbolTable) = gen_syntax_tree(tokens);
+    check_symbols(root.get(), symbolTable);
+    if (symbols != nullptr)
+        *symbols = symbolTable;
+    return root;
+}
+
 //BOOST_AUTO_TEST_SUITE_END()
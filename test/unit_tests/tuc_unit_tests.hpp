@@ -3,7 +3,7 @@ Project: OGLA
 File: tuc_unit_tests.hpp
 Author: Leonardo Banderali
 Created: November 8, 2015
-Last Modified: January 5, 2016
+Last Modified: October 18, 2026
 
 Description: A collection of unit tests for the lexer, syntax tree generator,
     and assembly code generator. These unit tests use the Boos Test framework.
@@ -39,7 +39,26 @@ THE SOFTWARE.
 #include "text_entity.hpp"
 #include "lexer.hpp"
 #include "syntax_tree.hpp"
+#include "ir_generator.hpp"
 #include "asm_generator.hpp"
+#include "peephole.hpp"
+#include "dead_statements.hpp"
+#include "partial_evaluator.hpp"
+#include "inliner.hpp"
+#include "memoizer.hpp"
+#include "strictness.hpp"
+#include "parallelizer.hpp"
+#include "algebraic_simplifier.hpp"
+#include "value_range.hpp"
+#include "superoptimizer.hpp"
+#include "scheduler.hpp"
+#include "instruction_selector.hpp"
+#include "x86_encoder.hpp"
+#include "jit.hpp"
+#include "bytecode.hpp"
+#include "c_generator.hpp"
+#include "column_kernel.hpp"
+#include "elf_writer.hpp"
 
 // c++ standard libraries
 #include <string>
@@ -102,4 +121,7 @@ const std::vector<Token> expected_tokens = {
 
 std::unique_ptr<SyntaxNode> get_syntax_tree();
 
+std::unique_ptr<SyntaxNode> parse_program(const std::string& text, SymbolTable* symbols = nullptr);
+/*  returns the syntax tree of a program (written to a file since the lexer reads files), after checking its symbols */
+
 #endif//TUC_UNIT_TESTS_HPP
@@ -0,0 +1,554 @@
+/*
+Project: TUC
+File: burg.cpp
+Author: Leonardo Banderali
+Created: October 18, 2026
+Last Modified: October 18, 2026
+
+Description:
+    TUC is a simple, experimental compiler designed for learning and experimenting.
+    It is not intended to have any useful purpose other than being a way to learn
+    how compilers work.
+
+Copyright (C) 2026 Leonardo Banderali
+
+License:
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+/*
+burg compiles the instruction selection rules of tuc (src/x86.burs) into the tables used by the instruction selector.
+It is run when tuc is built:
+
+    burg <rules file> <output file>
+
+The output is a C++ fragment meant to be included by src/instruction_selector.cpp, which defines the types it uses.
+*/
+
+// standard libraries
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <cctype>
+
+
+
+//~helper functions~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+namespace {
+    /*
+    an error in the rules file
+    */
+    class RulesError : public std::runtime_error {
+        public:
+            RulesError(int _line, const std::string& message) : std::runtime_error{message}, line{_line} {}
+            int line;
+    };
+
+    /*
+    A pattern: an operator with its operand patterns or a nonterminal leaf.
+    */
+    struct Pattern {
+        std::string symbol;
+        bool isOperator = false;
+        int leaf = -1;              // the number of a leaf (`$n`)
+        std::vector<Pattern> kids;
+    };
+
+    /*
+    An operand of the instructions of a rule: the result, a leaf, or an address; the parts of an address that are
+    missing are -1.
+    */
+    struct Operand {
+        std::string kind;           // RESULT, LEAF, or ADDRESS
+        int leaf = -1;              // the leaf or the base of an address
+        int index = -1;
+        int scale = -1;
+        int displacement = -1;
+    };
+
+    struct Instruction {
+        std::string mnemonic;
+        std::vector<Operand> operands;
+    };
+
+    struct Rule {
+        int line = 0;
+        std::string text;
+        std::string lhs;
+        Pattern pattern;
+        std::string predicate;
+        int cost = 0;
+        std::string action;
+        std::vector<Instruction> instructions;
+        std::vector<std::string> leaves;    // the nonterminal of each leaf
+    };
+
+    struct Grammar {
+        std::map<std::string, int> arity;   // of each operator
+        std::set<std::string> commutative;
+        std::set<std::string> constants;    // nonterminals standing for immediate values
+        std::string start;
+        std::vector<Rule> rules;
+    };
+
+    std::string trim(const std::string& s) {
+        auto first = s.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            return "";
+        return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    std::string upper_case(std::string s) {
+        for (auto& c : s)
+            c = std::toupper(c);
+        return s;
+    }
+
+    /*
+    splits a line into identifiers, numbers, leaves (`$n`), and single punctuation characters
+    */
+    std::vector<std::string> tokenize(const std::string& line, int lineNumber) {
+        auto tokens = std::vector<std::string>{};
+        for (auto i = 0u; i < line.size();) {
+            auto c = line[i];
+            auto end = i + 1;
+            if (std::isspace(c)) {
+                i++;
+                continue;
+            }
+            else if (std::isalpha(c) || c == '_') {
+                while (end < line.size() && (std::isalnum(line[end]) || line[end] == '_'))
+                    end++;
+            }
+            else if (std::isdigit(c) || c == '$') {
+                while (end < line.size() && std::isdigit(line[end]))
+                    end++;
+                if (c == '$' && end == i + 1)
+                    throw RulesError{lineNumber, "expected the number of a leaf after `$`"};
+            }
+            else if (std::string{"%:()?,=;@[]+*/"}.find(c) == std::string::npos) {
+                throw RulesError{lineNumber, std::string{"unexpected character `"} + c + "`"};
+            }
+            tokens.push_back(line.substr(i, end - i));
+            i = end;
+        }
+        return tokens;
+    }
+
+    /*
+    Reads one rule from the tokens of a line.
+    */
+    class RuleParser {
+        public:
+            RuleParser(const Grammar& _grammar, std::vector<std::string> _tokens, int _line)
+            : grammar{_grammar}, tokens{std::move(_tokens)}, line{_line} {}
+
+            Rule parse(const std::string& text) {
+                auto rule = Rule{};
+                rule.line = line;
+                rule.text = text;
+                rule.lhs = identifier();
+                expect(":");
+                rule.pattern = pattern(rule);
+                if (accept("?"))
+                    rule.predicate = identifier();
+                expect("(");
+                rule.cost = number();
+                expect(")");
+                if (accept("=")) {
+                    if (accept("@")) {
+                        rule.action = identifier();
+                    }
+                    else {
+                        rule.instructions.push_back(instruction(rule));
+                        while (accept(";"))
+                            rule.instructions.push_back(instruction(rule));
+                    }
+                }
+                if (next < tokens.size())
+                    throw RulesError{line, "unexpected `" + tokens[next] + "`"};
+                return rule;
+            }
+
+        private:
+            bool accept(const std::string& token) {
+                if (next < tokens.size() && tokens[next] == token) {
+                    next++;
+                    return true;
+                }
+                return false;
+            }
+
+            void expect(const std::string& token) {
+                if (!accept(token))
+                    throw RulesError{line, "expected `" + token + "`"};
+            }
+
+            std::string identifier() {
+                if (next == tokens.size() || !(std::isalpha(tokens[next][0]) || tokens[next][0] == '_'))
+                    throw RulesError{line, "expected a name"};
+                return tokens[next++];
+            }
+
+            int number() {
+                if (next == tokens.size() || !std::isdigit(tokens[next][0]))
+                    throw RulesError{line, "expected a number"};
+                return std::stoi(tokens[next++]);
+            }
+
+            int leaf(const Rule& rule) {
+                if (next == tokens.size() || tokens[next][0] != '$')
+                    throw RulesError{line, "expected a leaf (`$n`)"};
+                auto n = std::stoi(tokens[next++].substr(1));
+                if (n >= static_cast<int>(rule.leaves.size()))
+                    throw RulesError{line, "the pattern has no leaf $" + std::to_string(n)};
+                return n;
+            }
+
+            Pattern pattern(Rule& rule) {
+                auto p = Pattern{};
+                p.symbol = identifier();
+                auto arity = grammar.arity.find(p.symbol);
+                if (arity == grammar.arity.end()) {
+                    p.leaf = rule.leaves.size();
+                    rule.leaves.push_back(p.symbol);
+                    return p;
+                }
+                p.isOperator = true;
+                if (arity->second > 0) {
+                    expect("(");
+                    for (auto i = 0; i < arity->second; i++) {
+                        if (i > 0)
+                            expect(",");
+                        p.kids.push_back(pattern(rule));
+                    }
+                    expect(")");
+                }
+                return p;
+            }
+
+            Instruction instruction(const Rule& rule) {
+                auto i = Instruction{};
+                i.mnemonic = identifier();
+                if (next < tokens.size() && tokens[next] != ";") {
+                    i.operands.push_back(operand(rule));
+                    while (accept(","))
+                        i.operands.push_back(operand(rule));
+                }
+                return i;
+            }
+
+            Operand operand(const Rule& rule) {
+                auto o = Operand{};
+                if (accept("%")) {
+                    o.kind = "RESULT";
+                }
+                else if (accept("[")) {
+                    o.kind = "ADDRESS";
+                    do {
+                        auto n = leaf(rule);
+                        if (accept("*")) {
+                            o.index = n;
+                            o.scale = leaf(rule);
+                            if (grammar.constants.count(rule.leaves[o.scale]) == 0)
+                                throw RulesError{line, "scales must be constants"};
+                        }
+                        else if (grammar.constants.count(rule.leaves[n]) > 0) {
+                            o.displacement = n;
+                        }
+                        else if (o.leaf < 0) {
+                            o.leaf = n;
+                        }
+                        else {
+                            o.index = n;
+                        }
+                    } while (accept("+"));
+                    expect("]");
+                    if (o.leaf < 0)
+                        throw RulesError{line, "addresses must have a base register"};
+                }
+                else {
+                    o.kind = "LEAF";
+                    o.leaf = leaf(rule);
+                }
+                return o;
+            }
+
+            const Grammar& grammar;
+            std::vector<std::string> tokens;
+            int line;
+            std::size_t next = 0;
+    };
+
+    Grammar read_grammar(std::istream& input) {
+        auto grammar = Grammar{};
+        auto text = std::string{};
+        for (auto lineNumber = 1; std::getline(input, text); lineNumber++) {
+            text = trim(text.substr(0, text.find('#')));
+            if (text.empty())
+                continue;
+
+            auto tokens = tokenize(text, lineNumber);
+            if (tokens.front() != "%") {
+                grammar.rules.push_back(RuleParser{grammar, tokens, lineNumber}.parse(text));
+                continue;
+            }
+
+            auto directive = tokens.size() > 1 ? tokens[1] : "";
+            for (auto t = 2u; t < tokens.size(); t++) {
+                if (directive == "operators" && t + 2 < tokens.size() && tokens[t + 1] == "/") {
+                    grammar.arity[tokens[t]] = std::stoi(tokens[t + 2]);
+                    t += 2;
+                }
+                else if (directive == "commutative") {
+                    grammar.commutative.insert(tokens[t]);
+                }
+                else if (directive == "constant") {
+                    grammar.constants.insert(tokens[t]);
+                }
+                else if (directive == "start" && tokens.size() == 3) {
+                    grammar.start = tokens[t];
+                }
+                else {
+                    throw RulesError{lineNumber, "invalid `%" + directive + "` directive"};
+                }
+            }
+        }
+
+        auto nonterminals = std::set<std::string>{};
+        for (const auto& rule : grammar.rules)
+            nonterminals.insert(rule.lhs);
+        for (const auto& rule : grammar.rules) {
+            for (const auto& leaf : rule.leaves) {
+                if (nonterminals.count(leaf) == 0)
+                    throw RulesError{rule.line, "`" + leaf + "` is neither an operator nor a nonterminal"};
+            }
+            if (rule.pattern.isOperator && rule.pattern.kids.empty() && !rule.instructions.empty())
+                throw RulesError{rule.line, "leaf operators cannot have instructions"};
+        }
+        if (nonterminals.count(grammar.start) == 0)
+            throw RulesError{0, "the start nonterminal is not defined (`%start`)"};
+        return grammar;
+    }
+
+    std::string describe(const Pattern& p) {
+        if (!p.isOperator || p.kids.empty())
+            return p.symbol;
+        auto s = p.symbol + "(";
+        for (auto i = 0u; i < p.kids.size(); i++)
+            s += (i > 0 ? ", " : "") + describe(p.kids[i]);
+        return s + ")";
+    }
+
+    /*
+    returns the pattern with the operands of commutative operators in every order (keeping the numbers of the leaves)
+    */
+    std::vector<Pattern> commuted_patterns(const Grammar& grammar, const Pattern& p) {
+        if (!p.isOperator || p.kids.empty())
+            return {p};
+
+        auto patterns = std::vector<Pattern>{p};
+        for (auto i = 0u; i < p.kids.size(); i++) {
+            auto next = std::vector<Pattern>{};
+            for (const auto& kid : commuted_patterns(grammar, p.kids[i])) {
+                for (auto q : patterns) {
+                    q.kids[i] = kid;
+                    next.push_back(q);
+                }
+            }
+            patterns = next;
+        }
+        if (grammar.commutative.count(p.symbol) > 0 && describe(p.kids[0]) != describe(p.kids[1])) {
+            auto count = patterns.size();
+            for (auto i = 0u; i < count; i++) {
+                auto q = patterns[i];
+                std::swap(q.kids[0], q.kids[1]);
+                patterns.push_back(q);
+            }
+        }
+        return patterns;
+    }
+
+    /*
+    writes the nodes of a pattern in prefix order; returns the number of operators
+    */
+    int write_pattern(std::ostream& output, const Pattern& p, const std::map<std::string, int>& nonterminals) {
+        if (p.isOperator) {
+            output << "    {PatternKind::OPERATOR, static_cast<int>(tuc::IROpcode::" << p.symbol << "), "
+                   << p.kids.size() << ", -1},\n";
+            auto operators = 1;
+            for (const auto& kid : p.kids)
+                operators += write_pattern(output, kid, nonterminals);
+            return operators;
+        }
+        output << "    {PatternKind::NONTERMINAL, " << nonterminals.at(p.symbol) << ", 0, " << p.leaf << "},\n";
+        return 0;
+    }
+
+    int pattern_size(const Pattern& p) {
+        auto size = 1;
+        for (const auto& kid : p.kids)
+            size += pattern_size(kid);
+        return size;
+    }
+
+    void write_tables(std::ostream& output, const Grammar& grammar, const std::string& source) {
+        auto nonterminals = std::map<std::string, int>{};
+        auto names = std::vector<std::string>{};
+        for (const auto& rule : grammar.rules) {
+            if (nonterminals.count(rule.lhs) == 0) {
+                nonterminals[rule.lhs] = names.size();
+                names.push_back(rule.lhs);
+            }
+        }
+
+        output << "// generated by burg from " << source << "; do not edit\n\n";
+        output << "const int nonterminalCount = " << names.size() << ";\n";
+        output << "const int startNonterminal = " << nonterminals.at(grammar.start) << ";    // " << grammar.start << "\n";
+        output << "const char* const nonterminalNames[] = {";
+        for (auto i = 0u; i < names.size(); i++)
+            output << (i > 0 ? ", " : "") << "\"" << names[i] << "\"";
+        output << "};\n\n";
+
+        // every commuted pattern becomes a rule of its own
+        auto patterns = std::vector<std::pair<const Rule*, Pattern>>{};
+        for (const auto& rule : grammar.rules) {
+            for (const auto& p : commuted_patterns(grammar, rule.pattern))
+                patterns.emplace_back(&rule, p);
+        }
+
+        output << "const PatternNode patternNodes[] = {\n";
+        auto operatorCounts = std::vector<int>{};
+        for (const auto& p : patterns)
+            operatorCounts.push_back(write_pattern(output, p.second, nonterminals));
+        output << "};\n\n";
+
+        output << "const TemplateInstruction templateInstructions[] = {\n";
+        for (const auto& rule : grammar.rules) {
+            for (const auto& i : rule.instructions) {
+                output << "    {tuc::AsmOpcode::" << upper_case(i.mnemonic) << ", {";
+                for (auto o = 0u; o < i.operands.size(); o++) {
+                    const auto& operand = i.operands[o];
+                    output << (o > 0 ? ", " : "") << "{OperandKind::" << operand.kind << ", " << operand.leaf << ", "
+                           << operand.index << ", " << operand.scale << ", " << operand.displacement << "}";
+                }
+                output << "}},\n";
+            }
+        }
+        output << "    {tuc::AsmOpcode::LABEL, {}}     // unused\n";
+        output << "};\n\n";
+
+        output << "const SelectionRule selectionRules[] = {\n";
+        auto firstNode = 0;
+        auto firstInstruction = std::map<const Rule*, int>{};
+        auto instructionCount = 0;
+        for (const auto& rule : grammar.rules) {
+            firstInstruction[&rule] = instructionCount;
+            instructionCount += rule.instructions.size();
+        }
+        for (auto r = 0u; r < patterns.size(); r++) {
+            const auto& rule = *patterns[r].first;
+            const auto& p = patterns[r].second;
+            auto addresses = false;
+            for (const auto& i : rule.instructions) {
+                for (const auto& o : i.operands)
+                    addresses = addresses || o.kind == "ADDRESS";
+            }
+            auto commutes = p.isOperator && grammar.commutative.count(p.symbol) > 0 && p.kids.size() == 2 &&
+                            !p.kids[0].isOperator && !p.kids[1].isOperator && p.kids[0].symbol == p.kids[1].symbol;
+            auto action = rule.action.empty() ? (rule.instructions.empty() ? "NONE" : "INSTRUCTIONS") : upper_case(rule.action);
+            output << "    {" << nonterminals.at(rule.lhs) << ", " << rule.cost << ", " << firstNode << ", "
+                   << pattern_size(p) << ", " << operatorCounts[r] << ", " << rule.leaves.size() << ", Predicate::"
+                   << (rule.predicate.empty() ? "NONE" : upper_case(rule.predicate)) << ", tuc::TileAction::" << action
+                   << ", " << firstInstruction[&rule] << ", " << rule.instructions.size() << ", "
+                   << (commutes ? "true" : "false") << ", " << (addresses ? "true" : "false") << ", \""
+                   << rule.lhs << ": " << describe(p) << "\"},    // " << source << ":" << rule.line << "\n";
+            firstNode += pattern_size(p);
+        }
+        output << "};\n\n";
+
+        output << "const std::vector<int> chainRules = {";
+        auto first = true;
+        for (auto r = 0u; r < patterns.size(); r++) {
+            if (!patterns[r].second.isOperator) {
+                output << (first ? "" : ", ") << r;
+                first = false;
+            }
+        }
+        output << "};\n\n";
+
+        output << "/*\nreturns the rules whose pattern has `opcode` at its root\n*/\n";
+        output << "const std::vector<int>& rules_of(tuc::IROpcode opcode) {\n";
+        output << "    static const auto noRules = std::vector<int>{};\n";
+        for (const auto& arity : grammar.arity) {
+            output << "    static const auto rulesOf" << arity.first << " = std::vector<int>{";
+            first = true;
+            for (auto r = 0u; r < patterns.size(); r++) {
+                if (patterns[r].second.isOperator && patterns[r].second.symbol == arity.first) {
+                    output << (first ? "" : ", ") << r;
+                    first = false;
+                }
+            }
+            output << "};\n";
+        }
+        output << "\n    switch (opcode) {\n";
+        for (const auto& arity : grammar.arity)
+            output << "    case tuc::IROpcode::" << arity.first << ": return rulesOf" << arity.first << ";\n";
+        output << "    default: return noRules;\n    }\n}\n";
+    }
+}
+
+
+
+//~main~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <rules file> <output file>\n";
+        return 1;
+    }
+
+    auto input = std::ifstream{argv[1]};
+    if (!input) {
+        std::cerr << argv[1] << ": cannot be read\n";
+        return 1;
+    }
+
+    auto tables = std::ostringstream{};
+    try {
+        write_tables(tables, read_grammar(input), argv[1]);
+    }
+    catch (const RulesError& e) {
+        std::cerr << argv[1] << ":" << e.line << ": " << e.what() << "\n";
+        return 1;
+    }
+
+    auto output = std::ofstream{argv[2]};
+    output << tables.str();
+    return output ? 0 : 1;
+}